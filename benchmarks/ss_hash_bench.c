@@ -0,0 +1,460 @@
+/**
+ * @file ss_hash_bench.c
+ * @brief Throughput, quality and hashmap lookup benchmark for the ss_hash functions
+ * @author trywen@qq.com
+ * @date 2026-10-18
+ *
+ * Usage: bench_tcsl [scale]
+ * scale multiplies the iteration and sample counts (default 1).
+ *
+ * Sections:
+ * - Throughput in GB/s by key length, and integer hash cost in ns
+ * - Avalanche: how often flipping one input bit flips each output bit (ideal 0.5),
+ *   and bit independence (BIC): correlation between two output bit flips (ideal 0)
+ * - Chi-squared bucket distribution for power-of-two and prime bucket counts
+ * - ss_hashmap lookup throughput and comparisons per lookup
+ * Quality sections run on sequential integers, heap pointers, URLs and UUIDs.
+ */
+
+#include "ss_hash.h"
+#include "ss_hashmap.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_KEYS 65536
+#define BENCH_MAP_BUCKETS 4096
+
+/* Key kinds a hash is meaningful on */
+#define BENCH_BYTES 0x01 /* byte strings of any length */
+#define BENCH_INTS 0x02  /* 8-byte integers and pointers */
+
+typedef struct bench_hash_s
+{
+    const char* name;
+    ss_hash_f hash;
+    int bits; /* output bits carrying hash, before truncation to size_t */
+    int kinds;
+} bench_hash_t;
+
+static size_t bench_splitmix(const void* value, size_t size)
+{
+    (void)size;
+    return (size_t)ss_hash_splitmix64(*((const uint64_t*)value));
+}
+
+static size_t bench_mulxor(const void* value, size_t size)
+{
+    (void)size;
+    return (size_t)ss_hash_mulxor64(*((const uint64_t*)value));
+}
+
+static const bench_hash_t bench_hashes[] = {
+    {"ss_hash_mem", ss_hash_mem, 64, BENCH_BYTES | BENCH_INTS},
+    {"ss_hash64_mem", ss_hash64_mem, 64, BENCH_BYTES | BENCH_INTS},
+    {"ss_hash_mem_case", ss_hash_mem_case, 64, BENCH_BYTES},
+    {"ss_hash64_mem_case", ss_hash64_mem_case, 64, BENCH_BYTES},
+    {"ss_hash_crc32c", ss_hash_crc32c, 32, BENCH_BYTES | BENCH_INTS},
+    {"ss_hash_ptr", ss_hash_ptr, 64, BENCH_INTS},
+    {"ss_hash_ptr_mix", ss_hash_ptr_mix, 64, BENCH_INTS},
+    {"splitmix64", bench_splitmix, 64, BENCH_INTS},
+    {"mulxor64", bench_mulxor, 64, BENCH_INTS},
+};
+
+#define BENCH_HASH_COUNT (sizeof(bench_hashes) / sizeof(bench_hashes[0]))
+
+static volatile size_t bench_sink;
+static uint64_t bench_rng_state = 1;
+
+static double bench_seconds(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// Deterministic across runs so results stay comparable
+static uint64_t bench_rand(void)
+{
+    return ss_hash_splitmix64(bench_rng_state++);
+}
+
+static int bench_bits(const bench_hash_t* h)
+{
+    int width = (int)(sizeof(size_t) * 8);
+    return h->bits < width ? h->bits : width;
+}
+
+/* Throughput */
+
+static void bench_throughput(long scale)
+{
+    static const size_t sizes[] = {4, 8, 16, 32, 64, 256, 1024, 4096};
+    unsigned char* buf = (unsigned char*)malloc(4096 + 64);
+    size_t i, k, s;
+    for (i = 0; i < 4096 + 64; i++)
+    {
+        buf[i] = (unsigned char)(i * 31 + 7);
+    }
+
+    printf("\n-- Throughput (GB/s) --\n%-20s", "bytes");
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        printf("%8zu", sizes[s]);
+    }
+    printf("\n");
+    for (k = 0; k < BENCH_HASH_COUNT; k++)
+    {
+        if (!(bench_hashes[k].kinds & BENCH_BYTES))
+        {
+            continue;
+        }
+        printf("%-20s", bench_hashes[k].name);
+        for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+        {
+            // About 64 MB per cell at scale 1
+            size_t rounds = (size_t)scale * ((64u << 20) / sizes[s]);
+            size_t h = 0;
+            clock_t start = clock();
+            for (i = 0; i < rounds; i++)
+            {
+                // Shift the start so the calls are not hoisted out of the loop
+                h += bench_hashes[k].hash(buf + (i & 63), sizes[s]);
+            }
+            double sec = bench_seconds(start);
+            bench_sink += h;
+            printf("%8.2f", sec > 0 ? (double)rounds * sizes[s] / sec / 1e9 : 0.0);
+        }
+        printf("\n");
+    }
+    free(buf);
+}
+
+static void bench_int_throughput(long scale)
+{
+    size_t rounds = (size_t)scale * (64u << 20);
+    size_t i, k;
+    printf("\n-- Integer hash cost (ns/hash) --\n");
+    for (k = 0; k < BENCH_HASH_COUNT; k++)
+    {
+        if (!(bench_hashes[k].kinds & BENCH_INTS))
+        {
+            continue;
+        }
+        uint64_t key = 0x7f0000100000ULL;
+        size_t h = 0;
+        clock_t start = clock();
+        for (i = 0; i < rounds; i++)
+        {
+            h += bench_hashes[k].hash(&key, sizeof(key));
+            key += 16;
+        }
+        double sec = bench_seconds(start);
+        bench_sink += h;
+        printf("%-20s%10.2f\n", bench_hashes[k].name, sec * 1e9 / (double)rounds);
+    }
+}
+
+/* Avalanche and bit independence */
+
+static uint32_t bench_flips[64];
+static uint32_t bench_pairs[64][64];
+
+static void bench_avalanche(long scale)
+{
+    size_t samples = (size_t)scale * 1000;
+    size_t k, s;
+    int in, j, m;
+    printf("\n-- Avalanche, %zu random keys per input bit (16-byte keys, 8 for integer-only "
+           "hashes) --\n",
+           samples);
+    printf("Sampling noise alone reaches about %.3f bias and %.3f BIC\n", 2.0 / sqrt(samples),
+           4.5 / sqrt(samples));
+    printf("%-20s%12s%12s%12s\n", "hash", "mean bias", "worst bias", "worst BIC");
+    for (k = 0; k < BENCH_HASH_COUNT; k++)
+    {
+        const bench_hash_t* h = &bench_hashes[k];
+        size_t ksize = (h->kinds & BENCH_BYTES) ? 16 : 8;
+        int bits = bench_bits(h);
+        double sum_bias = 0, worst_bias = 0, worst_bic = 0;
+        for (in = 0; in < (int)ksize * 8; in++)
+        {
+            memset(bench_flips, 0, sizeof(bench_flips));
+            memset(bench_pairs, 0, sizeof(bench_pairs));
+            for (s = 0; s < samples; s++)
+            {
+                uint64_t key[2] = {bench_rand(), bench_rand()};
+                uint64_t d = h->hash(key, ksize);
+                ((unsigned char*)key)[in >> 3] ^= (unsigned char)(1u << (in & 7));
+                d ^= h->hash(key, ksize);
+                for (j = 0; j < bits; j++)
+                {
+                    if ((d >> j) & 1)
+                    {
+                        bench_flips[j]++;
+                        for (m = j + 1; m < bits; m++)
+                        {
+                            bench_pairs[j][m] += (uint32_t)((d >> m) & 1);
+                        }
+                    }
+                }
+            }
+            for (j = 0; j < bits; j++)
+            {
+                double pj = (double)bench_flips[j] / samples;
+                double bias = fabs(pj - 0.5);
+                sum_bias += bias;
+                worst_bias = bias > worst_bias ? bias : worst_bias;
+                for (m = j + 1; m < bits; m++)
+                {
+                    double pm = (double)bench_flips[m] / samples;
+                    double var = pj * (1 - pj) * pm * (1 - pm);
+                    // A bit that never or always flips is fully dependent on the input
+                    double corr =
+                        var > 0 ? ((double)bench_pairs[j][m] / samples - pj * pm) / sqrt(var) : 1;
+                    worst_bic = fabs(corr) > worst_bic ? fabs(corr) : worst_bic;
+                }
+            }
+        }
+        printf("%-20s%12.4f%12.4f%12.4f\n", h->name, sum_bias / (ksize * 8 * bits), worst_bias,
+               worst_bic);
+    }
+    printf("Case-folding hashes ignore bit 5 of letters by design\n");
+}
+
+/* Key sets */
+
+typedef struct bench_keyset_s
+{
+    const char* name;
+    int kind;
+    char* data;   /* count keys, stride bytes apart */
+    size_t* lens; /* key sizes */
+    size_t stride;
+    size_t count;
+} bench_keyset_t;
+
+#define bench_key(ks, i) ((ks)->data + (i) * (ks)->stride)
+
+static void bench_keyset_alloc(bench_keyset_t* ks, const char* name, int kind, size_t stride)
+{
+    ks->name = name;
+    ks->kind = kind;
+    ks->stride = stride;
+    ks->count = BENCH_KEYS;
+    ks->data = (char*)calloc(BENCH_KEYS, stride);
+    ks->lens = (size_t*)malloc(BENCH_KEYS * sizeof(size_t));
+}
+
+static void bench_keyset_free(bench_keyset_t* ks)
+{
+    free(ks->data);
+    free(ks->lens);
+}
+
+static void bench_keys_sequential(bench_keyset_t* ks)
+{
+    size_t i;
+    bench_keyset_alloc(ks, "sequential ints", BENCH_INTS, sizeof(uint64_t));
+    for (i = 0; i < ks->count; i++)
+    {
+        uint64_t v = i;
+        memcpy(bench_key(ks, i), &v, sizeof(v));
+        ks->lens[i] = sizeof(v);
+    }
+}
+
+// Live heap addresses of small objects, the blocks are kept until bench_keys_pointers_free()
+static void bench_keys_pointers(bench_keyset_t* ks)
+{
+    size_t i;
+    bench_keyset_alloc(ks, "heap pointers", BENCH_INTS, sizeof(uint64_t));
+    for (i = 0; i < ks->count; i++)
+    {
+        uint64_t v = (uint64_t)(uintptr_t)malloc(24);
+        memcpy(bench_key(ks, i), &v, sizeof(v));
+        ks->lens[i] = sizeof(void*);
+    }
+}
+
+static void bench_keys_pointers_free(bench_keyset_t* ks)
+{
+    size_t i;
+    for (i = 0; i < ks->count; i++)
+    {
+        uint64_t v;
+        memcpy(&v, bench_key(ks, i), sizeof(v));
+        free((void*)(uintptr_t)v);
+    }
+    bench_keyset_free(ks);
+}
+
+static void bench_keys_urls(bench_keyset_t* ks)
+{
+    static const char* hosts[] = {"api.example.com", "cdn.example.net", "shop.example.org"};
+    static const char* resources[] = {"users", "orders", "items", "sessions", "carts"};
+    size_t i;
+    bench_keyset_alloc(ks, "URLs", BENCH_BYTES, 96);
+    for (i = 0; i < ks->count; i++)
+    {
+        int n = snprintf(bench_key(ks, i), ks->stride, "https://%s/v%d/%s/%zu?page=%zu",
+                         hosts[i % 3], (int)(i % 2) + 1, resources[(i / 3) % 5], 100000 + i,
+                         (i / 7) % 20);
+        ks->lens[i] = (size_t)n;
+    }
+}
+
+static void bench_keys_uuids(bench_keyset_t* ks)
+{
+    size_t i;
+    bench_keyset_alloc(ks, "UUIDs", BENCH_BYTES, 40);
+    for (i = 0; i < ks->count; i++)
+    {
+        uint64_t hi = bench_rand(), lo = bench_rand();
+        // Version 4, variant 1
+        hi = (hi & ~0xf000ULL) | 0x4000ULL;
+        lo = (lo & ~(3ULL << 62)) | (2ULL << 62);
+        snprintf(bench_key(ks, i), ks->stride, "%08x-%04x-%04x-%04x-%012llx",
+                 (unsigned)(hi >> 32), (unsigned)(hi >> 16) & 0xffff, (unsigned)hi & 0xffff,
+                 (unsigned)(lo >> 48), (unsigned long long)(lo & 0xffffffffffffULL));
+        ks->lens[i] = 36;
+    }
+}
+
+/* Bucket distribution */
+
+static const uint32_t bench_bnums[] = {1024, 4096, 1021, 4093};
+
+#define BENCH_BNUM_COUNT (sizeof(bench_bnums) / sizeof(bench_bnums[0]))
+
+// Chi-squared of the bucket counts divided by its expectation bnum - 1, about 1 when uniform
+static double bench_chi2_ratio(const size_t* hashes, size_t count, uint32_t bnum, int mix)
+{
+    static size_t counts[BENCH_MAP_BUCKETS];
+    double expected = (double)count / bnum;
+    double chi2 = 0;
+    size_t i;
+    memset(counts, 0, sizeof(counts));
+    for (i = 0; i < count; i++)
+    {
+        uint64_t h = mix ? ss_hash_fmix64(hashes[i]) : hashes[i];
+        counts[h % bnum]++;
+    }
+    for (i = 0; i < bnum; i++)
+    {
+        double d = (double)counts[i] - expected;
+        chi2 += d * d / expected;
+    }
+    return chi2 / (bnum - 1);
+}
+
+static void bench_distribution(const bench_keyset_t* ks)
+{
+    size_t* hashes = (size_t*)malloc(ks->count * sizeof(size_t));
+    size_t i, k, b;
+    printf("\n-- Distribution: %s, %zu keys, chi2 / (bnum - 1) --\n", ks->name, ks->count);
+    printf("%-20s", "hash");
+    for (b = 0; b < BENCH_BNUM_COUNT; b++)
+    {
+        printf("%10u", bench_bnums[b]);
+    }
+    printf("%10s\n", "map idx");
+    for (k = 0; k < BENCH_HASH_COUNT; k++)
+    {
+        if (!(bench_hashes[k].kinds & ks->kind))
+        {
+            continue;
+        }
+        for (i = 0; i < ks->count; i++)
+        {
+            hashes[i] = bench_hashes[k].hash(bench_key(ks, i), ks->lens[i]);
+        }
+        printf("%-20s", bench_hashes[k].name);
+        for (b = 0; b < BENCH_BNUM_COUNT; b++)
+        {
+            printf("%10.2f", bench_chi2_ratio(hashes, ks->count, bench_bnums[b], 0));
+        }
+        // What ss_hashmap buckets see at BENCH_MAP_BUCKETS
+        printf("%10.2f\n",
+               bench_chi2_ratio(hashes, ks->count, BENCH_MAP_BUCKETS, SS_HASHMAP_MIX_INDEX));
+    }
+    free(hashes);
+}
+
+/* ss_hashmap lookups */
+
+static void bench_hashmap(const bench_keyset_t* ks, long scale)
+{
+    size_t rounds = (size_t)scale * 16;
+    size_t i, k, r;
+    printf("\n-- ss_hashmap lookups: %s, %zu keys in %d buckets --\n", ks->name, ks->count,
+           BENCH_MAP_BUCKETS);
+    printf("%-20s%12s%12s%12s\n", "hash", "Mlookups/s", "mean depth", "max height");
+    for (k = 0; k < BENCH_HASH_COUNT; k++)
+    {
+        if (!(bench_hashes[k].kinds & ks->kind))
+        {
+            continue;
+        }
+        ss_hashmap_t* map = ss_hashmap_create(BENCH_MAP_BUCKETS, bench_hashes[k].hash,
+                                              ss_compare_mem);
+        for (i = 0; i < ks->count; i++)
+        {
+            ss_hashmap_put(map, bench_key(ks, i), ks->lens[i], &i, sizeof(i));
+        }
+        ss_hashmap_stats_t stats;
+        ss_hashmap_stats(map, &stats);
+
+        size_t found = 0;
+        clock_t start = clock();
+        for (r = 0; r < rounds; r++)
+        {
+            // Odd stride visits every key in an order the prefetcher cannot follow
+            size_t at = r;
+            for (i = 0; i < ks->count; i++)
+            {
+                at = (at + 40503) & (ks->count - 1);
+                found += ss_hashmap_get(map, bench_key(ks, at), ks->lens[at], NULL) != NULL;
+            }
+        }
+        double sec = bench_seconds(start);
+        bench_sink += found;
+        printf("%-20s%12.2f%12.2f%12zu%s\n", bench_hashes[k].name,
+               sec > 0 ? (double)rounds * ks->count / sec / 1e6 : 0.0, stats.mean_depth,
+               stats.max_height, found == rounds * ks->count ? "" : "  (missed keys)");
+        ss_hashmap_free(map);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    long scale = argc > 1 ? atol(argv[1]) : 1;
+    if (scale <= 0)
+    {
+        scale = 1;
+    }
+    printf("=== ss_hash benchmark (scale %ld) ===\n", scale);
+    bench_throughput(scale);
+    bench_int_throughput(scale);
+    bench_avalanche(scale);
+
+    bench_keyset_t keysets[4];
+    size_t i;
+    bench_keys_sequential(&keysets[0]);
+    bench_keys_pointers(&keysets[1]);
+    bench_keys_urls(&keysets[2]);
+    bench_keys_uuids(&keysets[3]);
+    for (i = 0; i < 4; i++)
+    {
+        bench_distribution(&keysets[i]);
+    }
+    for (i = 0; i < 4; i++)
+    {
+        bench_hashmap(&keysets[i], scale);
+    }
+    bench_keyset_free(&keysets[0]);
+    bench_keys_pointers_free(&keysets[1]);
+    bench_keyset_free(&keysets[2]);
+    bench_keyset_free(&keysets[3]);
+    return 0;
+}
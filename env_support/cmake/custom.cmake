@@ -10,6 +10,18 @@ set(SOURCES
     src/ss_list.c
     src/ss_bigbitset.c
     src/ss_bitarray.c
+    src/ss_lru.c
+    src/ss_ttlmap.c
+    src/ss_intmap.c
+    src/ss_intern.c
+    src/ss_countermap.c
+    src/ss_hash.c
+    src/ss_cpu.c
+    src/ss_ascii.c
+    src/ss_btree.c
+    src/ss_ptree.c
+    src/ss_skiplist.c
+    src/ss_itree.c
 )
 
 
@@ -31,8 +43,28 @@ add_executable(test_tcsl ${SOURCES}
     tests/ss_bigbitset_test.c
     tests/ss_compare_test.c
     tests/ss_hash_test.c
+    tests/ss_lru_test.c
+    tests/ss_ttlmap_test.c
+    tests/ss_intmap_test.c
+    tests/ss_intern_test.c
+    tests/ss_countermap_test.c
+    tests/ss_cpu_test.c
+    tests/ss_ascii_test.c
+    tests/ss_btree_test.c
+    tests/ss_ptree_test.c
+    tests/ss_skiplist_test.c
+    tests/ss_itree_test.c
 )
 
+add_executable(bench_tcsl ${SOURCES}
+    benchmarks/ss_hash_bench.c
+)
+target_link_libraries(bench_tcsl m)
+
+# ss_skiplist_test runs worker threads
+find_package(Threads REQUIRED)
+target_link_libraries(test_tcsl Threads::Threads)
+
 target_link_libraries(${PROJECT_NAME} m)
 
 
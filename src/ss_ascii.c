@@ -0,0 +1,245 @@
+#include "ss_ascii.h"
+#include "ss_cpu.h"
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define _SS_ASCII_SSE2 1
+#if defined(__GNUC__) || defined(__clang__)
+#include <immintrin.h>
+#define _SS_ASCII_AVX2 1
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define _SS_ASCII_NEON 1
+#endif
+
+// AVX2 only pays for its dispatch check on longer blocks
+#define _SS_ASCII_AVX2_MIN 64
+
+/* SSE2 and NEON are part of the x86-64 and AArch64 baselines and compiled in directly,
+ * AVX2 is checked at run time. 32-bit ARM has no vminvq_u8 and takes the SWAR path.
+ * Vector loops finish with one overlapping block instead of a scalar tail; upper-casing
+ * twice is harmless and memicmp only needs the equal prefix. Blocks shorter than a
+ * vector go through 8-byte SWAR words. */
+
+static inline uint64_t _ss_ascii_load64(const uint8_t* p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static void _ss_ascii_toupper_words(uint8_t* d, const uint8_t* s, size_t len)
+{
+    if (len >= 8)
+    {
+        size_t i;
+        uint64_t v;
+        for (i = 0; i + 8 < len; i += 8)
+        {
+            v = ss_ascii_toupper64(_ss_ascii_load64(s + i));
+            memcpy(d + i, &v, sizeof(v));
+        }
+        v = ss_ascii_toupper64(_ss_ascii_load64(s + len - 8));
+        memcpy(d + len - 8, &v, sizeof(v));
+        return;
+    }
+    while (len--)
+    {
+        *d++ = (uint8_t)ss_ascii_toupper(*s);
+        s++;
+    }
+}
+
+static int _ss_ascii_memicmp_words(const uint8_t* l, const uint8_t* r, size_t len)
+{
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8)
+    {
+        if (ss_ascii_toupper64(_ss_ascii_load64(l + i)) !=
+            ss_ascii_toupper64(_ss_ascii_load64(r + i)))
+        {
+            break;
+        }
+    }
+    // Locates the mismatch inside the differing word, or checks the last bytes
+    for (; i < len; i++)
+    {
+        int lc = ss_ascii_tolower(l[i]);
+        int rc = ss_ascii_tolower(r[i]);
+        if (lc != rc)
+        {
+            return lc - rc;
+        }
+    }
+    return 0;
+}
+
+#if defined(_SS_ASCII_SSE2)
+/* Bytes 'a'..'z' shifted by 0x80 - 'a' land on -128..-103, the only signed values
+ * below -102, so one signed compare selects them */
+#define _SS_ASCII_SHIFT ((char)(0x80 - 'a'))
+#define _SS_ASCII_LIMIT ((char)(-128 + 26))
+
+static inline __m128i _ss_ascii_upper_sse2(__m128i v)
+{
+    __m128i t = _mm_add_epi8(v, _mm_set1_epi8(_SS_ASCII_SHIFT));
+    __m128i m = _mm_cmplt_epi8(t, _mm_set1_epi8(_SS_ASCII_LIMIT));
+    return _mm_xor_si128(v, _mm_and_si128(m, _mm_set1_epi8(0x20)));
+}
+
+static inline void _ss_ascii_toupper_sse2_at(uint8_t* d, const uint8_t* s)
+{
+    _mm_storeu_si128((__m128i*)d, _ss_ascii_upper_sse2(_mm_loadu_si128((const __m128i*)s)));
+}
+
+static inline int _ss_ascii_equal_sse2_at(const uint8_t* l, const uint8_t* r)
+{
+    __m128i lv = _ss_ascii_upper_sse2(_mm_loadu_si128((const __m128i*)l));
+    __m128i rv = _ss_ascii_upper_sse2(_mm_loadu_si128((const __m128i*)r));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(lv, rv)) == 0xffff;
+}
+
+#define _SS_ASCII_VEC 16
+#define _ss_ascii_toupper_vec_at _ss_ascii_toupper_sse2_at
+#define _ss_ascii_equal_vec_at _ss_ascii_equal_sse2_at
+#elif defined(_SS_ASCII_NEON)
+static inline uint8x16_t _ss_ascii_upper_neon(uint8x16_t v)
+{
+    uint8x16_t m = vcltq_u8(vsubq_u8(v, vdupq_n_u8('a')), vdupq_n_u8(26));
+    return veorq_u8(v, vandq_u8(m, vdupq_n_u8(0x20)));
+}
+
+static inline void _ss_ascii_toupper_neon_at(uint8_t* d, const uint8_t* s)
+{
+    vst1q_u8(d, _ss_ascii_upper_neon(vld1q_u8(s)));
+}
+
+static inline int _ss_ascii_equal_neon_at(const uint8_t* l, const uint8_t* r)
+{
+    uint8x16_t lv = _ss_ascii_upper_neon(vld1q_u8(l));
+    uint8x16_t rv = _ss_ascii_upper_neon(vld1q_u8(r));
+    return vminvq_u8(vceqq_u8(lv, rv)) == 0xff;
+}
+
+#define _SS_ASCII_VEC 16
+#define _ss_ascii_toupper_vec_at _ss_ascii_toupper_neon_at
+#define _ss_ascii_equal_vec_at _ss_ascii_equal_neon_at
+#endif
+
+#if defined(_SS_ASCII_AVX2)
+__attribute__((target("avx2"))) static inline __m256i _ss_ascii_upper_avx2(__m256i v)
+{
+    __m256i t = _mm256_add_epi8(v, _mm256_set1_epi8(_SS_ASCII_SHIFT));
+    __m256i m = _mm256_cmpgt_epi8(_mm256_set1_epi8(_SS_ASCII_LIMIT), t);
+    return _mm256_xor_si256(v, _mm256_and_si256(m, _mm256_set1_epi8(0x20)));
+}
+
+// len >= 32
+__attribute__((target("avx2"))) static void _ss_ascii_toupper_avx2(uint8_t* d, const uint8_t* s,
+                                                                   size_t len)
+{
+    size_t i = 0;
+    for (;; i += 32)
+    {
+        if (i + 32 > len)
+        {
+            i = len - 32;
+        }
+        __m256i v = _mm256_loadu_si256((const __m256i*)(s + i));
+        _mm256_storeu_si256((__m256i*)(d + i), _ss_ascii_upper_avx2(v));
+        if (i + 32 == len)
+        {
+            break;
+        }
+    }
+}
+
+// len >= 32, returns the length of a prefix known to be equal
+__attribute__((target("avx2"))) static size_t _ss_ascii_memicmp_avx2(const uint8_t* l,
+                                                                     const uint8_t* r,
+                                                                     size_t len)
+{
+    size_t i = 0;
+    for (;; i += 32)
+    {
+        if (i + 32 > len)
+        {
+            i = len - 32;
+        }
+        __m256i lv = _ss_ascii_upper_avx2(_mm256_loadu_si256((const __m256i*)(l + i)));
+        __m256i rv = _ss_ascii_upper_avx2(_mm256_loadu_si256((const __m256i*)(r + i)));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(lv, rv)) != -1)
+        {
+            return i;
+        }
+        if (i + 32 == len)
+        {
+            return len;
+        }
+    }
+}
+#endif
+
+void ss_ascii_toupper_block(void* dst, const void* src, size_t len)
+{
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+#if defined(_SS_ASCII_AVX2)
+    if (len >= _SS_ASCII_AVX2_MIN && ss_cpu_has(SS_CPU_AVX2))
+    {
+        _ss_ascii_toupper_avx2(d, s, len);
+        return;
+    }
+#endif
+#if defined(_SS_ASCII_VEC)
+    if (len >= _SS_ASCII_VEC)
+    {
+        size_t i;
+        for (i = 0; i + _SS_ASCII_VEC < len; i += _SS_ASCII_VEC)
+        {
+            _ss_ascii_toupper_vec_at(d + i, s + i);
+        }
+        _ss_ascii_toupper_vec_at(d + len - _SS_ASCII_VEC, s + len - _SS_ASCII_VEC);
+        return;
+    }
+#endif
+    _ss_ascii_toupper_words(d, s, len);
+}
+
+int ss_ascii_memicmp(const void* lbuf, const void* rbuf, size_t len)
+{
+    const uint8_t* l = (const uint8_t*)lbuf;
+    const uint8_t* r = (const uint8_t*)rbuf;
+    size_t done = 0;
+#if defined(_SS_ASCII_AVX2)
+    if (len >= _SS_ASCII_AVX2_MIN && ss_cpu_has(SS_CPU_AVX2))
+    {
+        done = _ss_ascii_memicmp_avx2(l, r, len);
+        return _ss_ascii_memicmp_words(l + done, r + done, len - done);
+    }
+#endif
+#if defined(_SS_ASCII_VEC)
+    if (len >= _SS_ASCII_VEC)
+    {
+        for (;; done += _SS_ASCII_VEC)
+        {
+            if (done + _SS_ASCII_VEC > len)
+            {
+                done = len - _SS_ASCII_VEC;
+            }
+            if (!_ss_ascii_equal_vec_at(l + done, r + done))
+            {
+                break;
+            }
+            if (done + _SS_ASCII_VEC == len)
+            {
+                return 0;
+            }
+        }
+    }
+#endif
+    return _ss_ascii_memicmp_words(l + done, r + done, len - done);
+}
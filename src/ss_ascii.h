@@ -0,0 +1,49 @@
+/**
+ * @file ss_ascii.h
+ * @brief Vectorized ASCII case folding for case-insensitive hashing and comparison
+ * @author trywen@qq.com
+ * @date 2026-10-18
+ *
+ * Kernels run 32 bytes per step on AVX2, chosen at run time through ss_cpu_has(), or
+ * 16 on SSE2 or AArch64 NEON. Instead of a scalar tail, the last step reprocesses one
+ * full vector ending at the last byte, overlapping bytes already done; blocks shorter
+ * than a vector use 8-byte words. Upper-casing a byte twice is harmless, so dst may
+ * equal src, but partially overlapping buffers would re-read bytes already written.
+ * Only 'A'-'Z' and 'a'-'z' fold, every other byte, including those above 0x7f, is
+ * compared as is.
+ */
+
+#ifndef SS_ASCII_H
+#define SS_ASCII_H
+
+#include "ss_types.h"
+
+#define ss_ascii_tolower(c) ((((c) >= 'A') && ((c) <= 'Z')) ? ((c) - 'A' + 'a') : (c))
+#define ss_ascii_toupper(c) ((((c) >= 'a') && ((c) <= 'z')) ? ((c) - 'a' + 'A') : (c))
+
+/* Upper-case the ASCII letters of 8 packed bytes, other bytes are untouched */
+static inline uint64_t ss_ascii_toupper64(uint64_t v)
+{
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t high = 0x8080808080808080ULL;
+    uint64_t low7 = v & ~high;
+    uint64_t ge_a = low7 + ones * (0x80 - 'a');
+    uint64_t gt_z = low7 + ones * (0x80 - 'z' - 1);
+    return v - (((ge_a & ~gt_z & ~v) & high) >> 2);
+}
+
+/**
+ * @brief Copy a block with its ASCII letters upper-cased
+ * @param dst Destination, either src itself or a buffer not overlapping it
+ * @param src Source block
+ * @param len Size of the block in bytes
+ */
+void ss_ascii_toupper_block(void* dst, const void* src, size_t len);
+
+/**
+ * @brief ASCII case-insensitive memcmp
+ * @return Difference of the lower-cased first mismatching bytes, 0 if equal
+ */
+int ss_ascii_memicmp(const void* lbuf, const void* rbuf, size_t len);
+
+#endif /* SS_ASCII_H */
@@ -0,0 +1,44 @@
+/**
+ * @file ss_atomic.h
+ * @brief Minimal atomic operation wrappers
+ * @author trywen@qq.com
+ * @date 2026-10-18
+ *
+ * Maps onto the GCC/Clang __atomic builtins when SS_ATOMIC_ENABLED is defined.
+ * Other toolchains fall back to plain loads and stores, which are only correct
+ * for single-threaded use.
+ */
+
+#ifndef SS_ATOMIC_H
+#define SS_ATOMIC_H
+
+#include "ss_version.h"
+
+#ifdef SS_ATOMIC_ENABLED
+
+#define ss_atomic_load(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define ss_atomic_load_relaxed(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define ss_atomic_store(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define ss_atomic_fetch_add(p, v) __atomic_fetch_add((p), (v), __ATOMIC_RELAXED)
+/* Acquire-release, so whoever drops the last reference sees all earlier writes */
+#define ss_atomic_fetch_sub(p, v) __atomic_fetch_sub((p), (v), __ATOMIC_ACQ_REL)
+/* On failure *expected receives the current value */
+#define ss_atomic_cas(p, expected, desired)                                                        \
+    __atomic_compare_exchange_n((p), (expected), (desired), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+/* Full barrier, orders a store before later loads */
+#define ss_atomic_fence() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#else
+
+#define ss_atomic_load(p) (*(p))
+#define ss_atomic_load_relaxed(p) (*(p))
+#define ss_atomic_store(p, v) ((void)(*(p) = (v)))
+#define ss_atomic_fetch_add(p, v) ((*(p) += (v)) - (v))
+#define ss_atomic_fetch_sub(p, v) ((*(p) -= (v)) + (v))
+#define ss_atomic_cas(p, expected, desired)                                                        \
+    (*(p) == *(expected) ? (*(p) = (desired), 1) : (*(expected) = *(p), 0))
+#define ss_atomic_fence() ((void)0)
+
+#endif
+
+#endif /* SS_ATOMIC_H */
@@ -0,0 +1,767 @@
+#include "ss_alloc.h"
+#include "ss_btree.h"
+
+#include <string.h>
+
+/* Splits only create inner nodes at least half full, so heights stay far below this */
+#define _SS_BTREE_MAX_HEIGHT 64
+
+#define _ss_btree_align(n) (((n) + SS_PTR_SIZE - 1) & ~(SS_PTR_SIZE - 1))
+
+#define _ss_btree_key(t, node, i) ((unsigned char*)((node) + 1) + (i) * (t)->ksize)
+#define _ss_btree_value(t, node, i) ((unsigned char*)(node) + (t)->leaf_voff + (i) * (t)->vsize)
+#define _ss_btree_children(t, node)                                                                \
+    ((ss_btree_node_t**)((unsigned char*)(node) + (t)->inner_coff))
+
+#define _ss_btree_cap(t, node) ((node)->leaf ? (t)->leaf_cap : (t)->inner_cap)
+
+// Nodes below half capacity are refilled after a removal
+#define _ss_btree_min(t, node) (_ss_btree_cap(t, node) / 2)
+
+// Slots per node for the target size; one more slot is allocated so that a full node
+// can take the overflowing entry before it splits
+static size_t _ss_btree_capacity(size_t slot, size_t extra)
+{
+    size_t header = sizeof(ss_btree_node_t) + extra;
+    size_t cap = SS_BTREE_NODE_BYTES > header ? (SS_BTREE_NODE_BYTES - header) / slot : 0;
+    cap = cap > 0 ? cap - 1 : 0;
+    return SS_MAX(cap, SS_BTREE_MIN_CAPACITY);
+}
+
+static inline int _ss_btree_compare(const ss_btree_t* t, const void* lkey, const void* rkey)
+{
+    if (t->key_compare)
+    {
+        return t->key_compare(lkey, t->ksize, rkey, t->ksize);
+    }
+    uint64_t l, r;
+    memcpy(&l, lkey, sizeof(l));
+    memcpy(&r, rkey, sizeof(r));
+    return (l > r) - (l < r);
+}
+
+// Index of the first key not less than key, found tells whether it is equal
+static size_t _ss_btree_search(const ss_btree_t* t, ss_btree_node_t* node, const void* key,
+                               ss_bool_t* found)
+{
+    size_t count = node->count;
+    if (!t->key_compare)
+    {
+        // Branchless binary search over the contiguous native keys
+        const uint64_t* keys = (const uint64_t*)(node + 1);
+        const uint64_t* base = keys;
+        uint64_t k;
+        memcpy(&k, key, sizeof(k));
+        if (count == 0)
+        {
+            *found = SS_FALSE;
+            return 0;
+        }
+        while (count > 1)
+        {
+            size_t half = count / 2;
+            base = base[half - 1] < k ? base + half : base;
+            count -= half;
+        }
+        size_t pos = (size_t)(base - keys) + (*base < k);
+        *found = pos < node->count && keys[pos] == k;
+        return pos;
+    }
+    size_t lo = 0;
+    size_t hi = count;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        int cmprs = t->key_compare(_ss_btree_key(t, node, mid), t->ksize, key, t->ksize);
+        if (cmprs < 0)
+        {
+            lo = mid + 1;
+        }
+        else if (cmprs > 0)
+        {
+            hi = mid;
+        }
+        else
+        {
+            *found = SS_TRUE;
+            return mid;
+        }
+    }
+    *found = SS_FALSE;
+    return lo;
+}
+
+static ss_btree_node_t* _ss_btree_node_new(ss_btree_t* t, uint32_t leaf)
+{
+    ss_btree_node_t* node =
+        (ss_btree_node_t*)ss_malloc((unsigned long)(leaf ? t->leaf_bytes : t->inner_bytes));
+    if (node)
+    {
+        node->prev = NULL;
+        node->next = NULL;
+        node->count = 0;
+        node->leaf = leaf;
+        if (leaf)
+        {
+            t->leaves++;
+        }
+        else
+        {
+            t->inners++;
+        }
+    }
+    return node;
+}
+
+static void _ss_btree_node_free(ss_btree_t* t, ss_btree_node_t* node)
+{
+    if (node->leaf)
+    {
+        t->leaves--;
+    }
+    else
+    {
+        t->inners--;
+    }
+    ss_free(node);
+}
+
+// Descends to the leaf that holds or would hold key, recording the path when asked
+static ss_btree_node_t* _ss_btree_leaf_find(ss_btree_t* t, const void* key, size_t* pos,
+                                            ss_bool_t* found, ss_btree_node_t** path,
+                                            size_t* slots, size_t* depth)
+{
+    ss_btree_node_t* node = t->root;
+    size_t level = 0;
+    while (node)
+    {
+        size_t i = _ss_btree_search(t, node, key, found);
+        if (node->leaf)
+        {
+            *pos = i;
+            break;
+        }
+        // Separator i is the smallest key of child i + 1
+        i += *found ? 1 : 0;
+        if (path)
+        {
+            path[level] = node;
+            slots[level] = i;
+        }
+        level++;
+        node = _ss_btree_children(t, node)[i];
+    }
+    if (depth)
+    {
+        *depth = level;
+    }
+    return node;
+}
+
+ss_bool_t ss_btree_init(ss_btree_t* t, size_t ksize, size_t vsize, ss_compare_f key_compare)
+{
+    memset(t, 0, sizeof(ss_btree_t));
+    if (ksize == 0 || (!key_compare && ksize != sizeof(uint64_t)))
+    {
+        return SS_FALSE;
+    }
+    t->ksize = ksize;
+    t->vsize = vsize;
+    t->key_compare = key_compare;
+    t->leaf_cap = _ss_btree_capacity(ksize + vsize, 0);
+    t->leaf_voff = sizeof(ss_btree_node_t) + _ss_btree_align((t->leaf_cap + 1) * ksize);
+    t->leaf_bytes = t->leaf_voff + (t->leaf_cap + 1) * vsize;
+    // An inner node has one child more than it has keys
+    t->inner_cap = _ss_btree_capacity(ksize + SS_PTR_SIZE, SS_PTR_SIZE);
+    t->inner_coff = sizeof(ss_btree_node_t) + _ss_btree_align((t->inner_cap + 1) * ksize);
+    t->inner_bytes = t->inner_coff + (t->inner_cap + 2) * SS_PTR_SIZE;
+    return SS_TRUE;
+}
+
+void ss_btree_destroy(ss_btree_t* t) { ss_btree_clear(t); }
+
+ss_btree_t* ss_btree_create(size_t ksize, size_t vsize, ss_compare_f key_compare)
+{
+    ss_btree_t* t = (ss_btree_t*)ss_malloc(sizeof(ss_btree_t));
+    if (t && !ss_btree_init(t, ksize, vsize, key_compare))
+    {
+        ss_free(t);
+        return NULL;
+    }
+    return t;
+}
+
+void ss_btree_free(ss_btree_t* t)
+{
+    if (t)
+    {
+        ss_btree_destroy(t);
+        ss_free(t);
+    }
+}
+
+// Opens slot pos of a leaf for the pair
+static void _ss_btree_leaf_insert_at(ss_btree_t* t, ss_btree_node_t* node, size_t pos,
+                                     const void* key, const void* value)
+{
+    size_t n = node->count - pos;
+    memmove(_ss_btree_key(t, node, pos + 1), _ss_btree_key(t, node, pos), n * t->ksize);
+    memmove(_ss_btree_value(t, node, pos + 1), _ss_btree_value(t, node, pos), n * t->vsize);
+    memcpy(_ss_btree_key(t, node, pos), key, t->ksize);
+    if (value)
+    {
+        memcpy(_ss_btree_value(t, node, pos), value, t->vsize);
+    }
+    else
+    {
+        memset(_ss_btree_value(t, node, pos), 0, t->vsize);
+    }
+    node->count++;
+}
+
+// Opens key slot pos of an inner node, child goes to the right of the key
+static void _ss_btree_inner_insert_at(ss_btree_t* t, ss_btree_node_t* node, size_t pos,
+                                      const void* key, ss_btree_node_t* child)
+{
+    ss_btree_node_t** children = _ss_btree_children(t, node);
+    size_t n = node->count - pos;
+    memmove(_ss_btree_key(t, node, pos + 1), _ss_btree_key(t, node, pos), n * t->ksize);
+    memmove(children + pos + 2, children + pos + 1, n * sizeof(ss_btree_node_t*));
+    memcpy(_ss_btree_key(t, node, pos), key, t->ksize);
+    children[pos + 1] = child;
+    node->count++;
+}
+
+// Moves the entries from keep on into the empty right leaf, returns its first key
+static const void* _ss_btree_leaf_split(ss_btree_t* t, ss_btree_node_t* node,
+                                        ss_btree_node_t* right, size_t keep)
+{
+    size_t n = node->count - keep;
+    memcpy(_ss_btree_key(t, right, 0), _ss_btree_key(t, node, keep), n * t->ksize);
+    memcpy(_ss_btree_value(t, right, 0), _ss_btree_value(t, node, keep), n * t->vsize);
+    right->count = (uint32_t)n;
+    node->count = (uint32_t)keep;
+    right->prev = node;
+    right->next = node->next;
+    if (node->next)
+    {
+        node->next->prev = right;
+    }
+    else
+    {
+        t->last = right;
+    }
+    node->next = right;
+    return _ss_btree_key(t, right, 0);
+}
+
+// Moves the upper half into the empty right node, returns the middle key to push up; it
+// stays readable in the unused part of node until the parent copies it
+static const void* _ss_btree_inner_split(ss_btree_t* t, ss_btree_node_t* node,
+                                         ss_btree_node_t* right)
+{
+    size_t mid = node->count / 2;
+    size_t n = node->count - mid - 1;
+    memcpy(_ss_btree_key(t, right, 0), _ss_btree_key(t, node, mid + 1), n * t->ksize);
+    memcpy(_ss_btree_children(t, right), _ss_btree_children(t, node) + mid + 1,
+           (n + 1) * sizeof(ss_btree_node_t*));
+    right->count = (uint32_t)n;
+    node->count = (uint32_t)mid;
+    return _ss_btree_key(t, node, mid);
+}
+
+ss_bool_t ss_btree_put(ss_btree_t* t, const void* key, const void* value)
+{
+    ss_btree_node_t* path[_SS_BTREE_MAX_HEIGHT];
+    size_t slots[_SS_BTREE_MAX_HEIGHT];
+    ss_btree_node_t* spare[_SS_BTREE_MAX_HEIGHT + 2];
+    size_t depth, pos, nspare = 0, i;
+    ss_bool_t found;
+    if (!t->root)
+    {
+        t->root = _ss_btree_node_new(t, 1);
+        if (!t->root)
+        {
+            return SS_FALSE;
+        }
+        t->first = t->last = t->root;
+        t->height = 1;
+    }
+    ss_btree_node_t* leaf = _ss_btree_leaf_find(t, key, &pos, &found, path, slots, &depth);
+    if (found)
+    {
+        if (value)
+        {
+            memcpy(_ss_btree_value(t, leaf, pos), value, t->vsize);
+        }
+        else
+        {
+            memset(_ss_btree_value(t, leaf, pos), 0, t->vsize);
+        }
+        return SS_TRUE;
+    }
+
+    // Allocate up front for every full node that will split, and a new root if the root
+    // splits, so a failure leaves the tree untouched
+    path[depth] = leaf;
+    for (i = depth + 1; i-- > 0;)
+    {
+        if (path[i]->count < _ss_btree_cap(t, path[i]))
+        {
+            break;
+        }
+        spare[nspare] = _ss_btree_node_new(t, path[i]->leaf);
+        if (spare[nspare] && i == 0)
+        {
+            spare[++nspare] = _ss_btree_node_new(t, 0);
+        }
+        if (!spare[nspare])
+        {
+            while (nspare-- > 0)
+            {
+                _ss_btree_node_free(t, spare[nspare]);
+            }
+            return SS_FALSE;
+        }
+        nspare++;
+    }
+
+    ss_bool_t full = leaf->count == t->leaf_cap;
+    // Pure appends and prepends leave the outer leaf full instead of half full
+    size_t keep = (!leaf->next && pos == leaf->count) ? t->leaf_cap
+                  : (!leaf->prev && pos == 0)         ? 1
+                                                      : (t->leaf_cap + 1) / 2;
+    _ss_btree_leaf_insert_at(t, leaf, pos, key, value);
+    t->size++;
+    if (!full)
+    {
+        return SS_TRUE;
+    }
+    nspare = 0;
+    ss_btree_node_t* right = spare[nspare++];
+    const void* sep = _ss_btree_leaf_split(t, leaf, right, keep);
+    for (i = depth; i-- > 0;)
+    {
+        ss_btree_node_t* node = path[i];
+        full = node->count == t->inner_cap;
+        _ss_btree_inner_insert_at(t, node, slots[i], sep, right);
+        if (!full)
+        {
+            return SS_TRUE;
+        }
+        right = spare[nspare++];
+        sep = _ss_btree_inner_split(t, node, right);
+    }
+    // The root split
+    ss_btree_node_t* root = spare[nspare];
+    memcpy(_ss_btree_key(t, root, 0), sep, t->ksize);
+    _ss_btree_children(t, root)[0] = t->root;
+    _ss_btree_children(t, root)[1] = right;
+    root->count = 1;
+    t->root = root;
+    t->height++;
+    return SS_TRUE;
+}
+
+void* ss_btree_find(ss_btree_t* t, const void* key)
+{
+    size_t pos;
+    ss_bool_t found = SS_FALSE;
+    ss_btree_node_t* leaf = _ss_btree_leaf_find(t, key, &pos, &found, NULL, NULL, NULL);
+    return leaf && found ? _ss_btree_value(t, leaf, pos) : NULL;
+}
+
+ss_bool_t ss_btree_get(ss_btree_t* t, const void* key, void* value)
+{
+    void* slot = ss_btree_find(t, key);
+    if (!slot)
+    {
+        return SS_FALSE;
+    }
+    if (value)
+    {
+        memcpy(value, slot, t->vsize);
+    }
+    return SS_TRUE;
+}
+
+// Moves one entry from the left sibling into child ci
+static void _ss_btree_borrow_left(ss_btree_t* t, ss_btree_node_t* parent, size_t ci)
+{
+    ss_btree_node_t** siblings = _ss_btree_children(t, parent);
+    ss_btree_node_t* node = siblings[ci];
+    ss_btree_node_t* left = siblings[ci - 1];
+    size_t n = node->count;
+    memmove(_ss_btree_key(t, node, 1), _ss_btree_key(t, node, 0), n * t->ksize);
+    if (node->leaf)
+    {
+        memmove(_ss_btree_value(t, node, 1), _ss_btree_value(t, node, 0), n * t->vsize);
+        memcpy(_ss_btree_key(t, node, 0), _ss_btree_key(t, left, left->count - 1), t->ksize);
+        memcpy(_ss_btree_value(t, node, 0), _ss_btree_value(t, left, left->count - 1),
+               t->vsize);
+        memcpy(_ss_btree_key(t, parent, ci - 1), _ss_btree_key(t, node, 0), t->ksize);
+    }
+    else
+    {
+        // The separator rotates down and the left sibling's last key rotates up
+        ss_btree_node_t** children = _ss_btree_children(t, node);
+        memmove(children + 1, children, (n + 1) * sizeof(ss_btree_node_t*));
+        children[0] = _ss_btree_children(t, left)[left->count];
+        memcpy(_ss_btree_key(t, node, 0), _ss_btree_key(t, parent, ci - 1), t->ksize);
+        memcpy(_ss_btree_key(t, parent, ci - 1), _ss_btree_key(t, left, left->count - 1),
+               t->ksize);
+    }
+    left->count--;
+    node->count++;
+}
+
+// Moves one entry from the right sibling into child ci
+static void _ss_btree_borrow_right(ss_btree_t* t, ss_btree_node_t* parent, size_t ci)
+{
+    ss_btree_node_t** siblings = _ss_btree_children(t, parent);
+    ss_btree_node_t* node = siblings[ci];
+    ss_btree_node_t* right = siblings[ci + 1];
+    size_t n = right->count - 1;
+    if (node->leaf)
+    {
+        memcpy(_ss_btree_key(t, node, node->count), _ss_btree_key(t, right, 0), t->ksize);
+        memcpy(_ss_btree_value(t, node, node->count), _ss_btree_value(t, right, 0), t->vsize);
+        memmove(_ss_btree_key(t, right, 0), _ss_btree_key(t, right, 1), n * t->ksize);
+        memmove(_ss_btree_value(t, right, 0), _ss_btree_value(t, right, 1), n * t->vsize);
+        memcpy(_ss_btree_key(t, parent, ci), _ss_btree_key(t, right, 0), t->ksize);
+    }
+    else
+    {
+        ss_btree_node_t** children = _ss_btree_children(t, right);
+        memcpy(_ss_btree_key(t, node, node->count), _ss_btree_key(t, parent, ci), t->ksize);
+        _ss_btree_children(t, node)[node->count + 1] = children[0];
+        memcpy(_ss_btree_key(t, parent, ci), _ss_btree_key(t, right, 0), t->ksize);
+        memmove(_ss_btree_key(t, right, 0), _ss_btree_key(t, right, 1), n * t->ksize);
+        memmove(children, children + 1, (n + 1) * sizeof(ss_btree_node_t*));
+    }
+    right->count--;
+    node->count++;
+}
+
+// Merges child i + 1 into child i and drops their separator from the parent
+static void _ss_btree_merge(ss_btree_t* t, ss_btree_node_t* parent, size_t i)
+{
+    ss_btree_node_t** siblings = _ss_btree_children(t, parent);
+    ss_btree_node_t* left = siblings[i];
+    ss_btree_node_t* right = siblings[i + 1];
+    size_t n = right->count;
+    if (left->leaf)
+    {
+        memcpy(_ss_btree_key(t, left, left->count), _ss_btree_key(t, right, 0), n * t->ksize);
+        memcpy(_ss_btree_value(t, left, left->count), _ss_btree_value(t, right, 0),
+               n * t->vsize);
+        left->next = right->next;
+        if (right->next)
+        {
+            right->next->prev = left;
+        }
+        else
+        {
+            t->last = left;
+        }
+    }
+    else
+    {
+        memcpy(_ss_btree_key(t, left, left->count), _ss_btree_key(t, parent, i), t->ksize);
+        left->count++;
+        memcpy(_ss_btree_key(t, left, left->count), _ss_btree_key(t, right, 0), n * t->ksize);
+        memcpy(_ss_btree_children(t, left) + left->count, _ss_btree_children(t, right),
+               (n + 1) * sizeof(ss_btree_node_t*));
+    }
+    left->count += (uint32_t)n;
+    _ss_btree_node_free(t, right);
+    n = parent->count - i - 1;
+    memmove(_ss_btree_key(t, parent, i), _ss_btree_key(t, parent, i + 1), n * t->ksize);
+    memmove(siblings + i + 1, siblings + i + 2, n * sizeof(ss_btree_node_t*));
+    parent->count--;
+}
+
+ss_bool_t ss_btree_remove(ss_btree_t* t, const void* key)
+{
+    ss_btree_node_t* path[_SS_BTREE_MAX_HEIGHT];
+    size_t slots[_SS_BTREE_MAX_HEIGHT];
+    size_t depth, pos, i;
+    ss_bool_t found = SS_FALSE;
+    ss_btree_node_t* leaf = _ss_btree_leaf_find(t, key, &pos, &found, path, slots, &depth);
+    if (!leaf || !found)
+    {
+        return SS_FALSE;
+    }
+    size_t n = leaf->count - pos - 1;
+    memmove(_ss_btree_key(t, leaf, pos), _ss_btree_key(t, leaf, pos + 1), n * t->ksize);
+    memmove(_ss_btree_value(t, leaf, pos), _ss_btree_value(t, leaf, pos + 1), n * t->vsize);
+    leaf->count--;
+    t->size--;
+
+    // Refill underfull nodes bottom-up: borrow from a sibling above half capacity,
+    // otherwise merge, which always fits and may leave the parent underfull in turn
+    ss_btree_node_t* node = leaf;
+    for (i = depth; i-- > 0;)
+    {
+        if (node->count >= _ss_btree_min(t, node))
+        {
+            break;
+        }
+        ss_btree_node_t* parent = path[i];
+        ss_btree_node_t** siblings = _ss_btree_children(t, parent);
+        size_t ci = slots[i];
+        if (ci > 0 && siblings[ci - 1]->count > _ss_btree_min(t, node))
+        {
+            _ss_btree_borrow_left(t, parent, ci);
+        }
+        else if (ci < parent->count && siblings[ci + 1]->count > _ss_btree_min(t, node))
+        {
+            _ss_btree_borrow_right(t, parent, ci);
+        }
+        else
+        {
+            _ss_btree_merge(t, parent, ci > 0 ? ci - 1 : ci);
+        }
+        node = parent;
+    }
+
+    ss_btree_node_t* root = t->root;
+    if (root->count == 0)
+    {
+        if (root->leaf)
+        {
+            t->root = t->first = t->last = NULL;
+        }
+        else
+        {
+            t->root = _ss_btree_children(t, root)[0];
+        }
+        _ss_btree_node_free(t, root);
+        t->height--;
+    }
+    return SS_TRUE;
+}
+
+// Leftmost key below node
+static const void* _ss_btree_min_key(ss_btree_t* t, ss_btree_node_t* node)
+{
+    while (!node->leaf)
+    {
+        node = _ss_btree_children(t, node)[0];
+    }
+    return _ss_btree_key(t, node, 0);
+}
+
+ss_bool_t ss_btree_bulk_load(ss_btree_t* t, const void* keys, const void* values, size_t n)
+{
+    const unsigned char* k = (const unsigned char*)keys;
+    const unsigned char* v = (const unsigned char*)values;
+    size_t count, total, i, j;
+    if (t->root)
+    {
+        return SS_FALSE;
+    }
+    for (i = 1; i < n; i++)
+    {
+        if (_ss_btree_compare(t, k + (i - 1) * t->ksize, k + i * t->ksize) >= 0)
+        {
+            return SS_FALSE;
+        }
+    }
+    if (n == 0)
+    {
+        return SS_TRUE;
+    }
+
+    // Allocate every level up front: leaves first, then each inner level
+    total = 0;
+    for (count = (n + t->leaf_cap - 1) / t->leaf_cap;; count = (count + t->inner_cap) /
+                                                              (t->inner_cap + 1))
+    {
+        total += count;
+        if (count == 1)
+        {
+            break;
+        }
+    }
+    ss_btree_node_t** nodes =
+        (ss_btree_node_t**)ss_malloc((unsigned long)(total * sizeof(ss_btree_node_t*)));
+    if (!nodes)
+    {
+        return SS_FALSE;
+    }
+    count = (n + t->leaf_cap - 1) / t->leaf_cap;
+    for (i = 0; i < total; i++)
+    {
+        nodes[i] = _ss_btree_node_new(t, i < count);
+        if (!nodes[i])
+        {
+            while (i-- > 0)
+            {
+                _ss_btree_node_free(t, nodes[i]);
+            }
+            ss_free(nodes);
+            return SS_FALSE;
+        }
+    }
+
+    // Spread the pairs evenly over the leaves
+    for (i = 0; i < count; i++)
+    {
+        ss_btree_node_t* leaf = nodes[i];
+        size_t lo = i * n / count;
+        size_t hi = (i + 1) * n / count;
+        memcpy(_ss_btree_key(t, leaf, 0), k + lo * t->ksize, (hi - lo) * t->ksize);
+        if (v)
+        {
+            memcpy(_ss_btree_value(t, leaf, 0), v + lo * t->vsize, (hi - lo) * t->vsize);
+        }
+        else
+        {
+            memset(_ss_btree_value(t, leaf, 0), 0, (hi - lo) * t->vsize);
+        }
+        leaf->count = (uint32_t)(hi - lo);
+        leaf->prev = i > 0 ? nodes[i - 1] : NULL;
+        leaf->next = i + 1 < count ? nodes[i + 1] : NULL;
+    }
+    t->first = nodes[0];
+    t->last = nodes[count - 1];
+    t->height = 1;
+
+    // Group each level's nodes evenly under the next
+    ss_btree_node_t** level = nodes;
+    while (count > 1)
+    {
+        size_t groups = (count + t->inner_cap) / (t->inner_cap + 1);
+        ss_btree_node_t** upper = level + count;
+        for (i = 0; i < groups; i++)
+        {
+            ss_btree_node_t* node = upper[i];
+            size_t lo = i * count / groups;
+            size_t hi = (i + 1) * count / groups;
+            memcpy(_ss_btree_children(t, node), level + lo, (hi - lo) * sizeof(ss_btree_node_t*));
+            for (j = lo + 1; j < hi; j++)
+            {
+                memcpy(_ss_btree_key(t, node, j - lo - 1), _ss_btree_min_key(t, level[j]),
+                       t->ksize);
+            }
+            node->count = (uint32_t)(hi - lo - 1);
+        }
+        level = upper;
+        count = groups;
+        t->height++;
+    }
+    t->root = level[0];
+    t->size = n;
+    ss_free(nodes);
+    return SS_TRUE;
+}
+
+ss_bool_t ss_btree_seek_first(ss_btree_t* t, ss_btree_iter_t* it)
+{
+    it->leaf = t->first;
+    it->index = 0;
+    return it->leaf != NULL;
+}
+
+ss_bool_t ss_btree_seek_last(ss_btree_t* t, ss_btree_iter_t* it)
+{
+    it->leaf = t->last;
+    it->index = it->leaf ? it->leaf->count - 1 : 0;
+    return it->leaf != NULL;
+}
+
+ss_bool_t ss_btree_seek(ss_btree_t* t, const void* key, ss_btree_iter_t* it)
+{
+    ss_bool_t found;
+    it->leaf = _ss_btree_leaf_find(t, key, &it->index, &found, NULL, NULL, NULL);
+    if (it->leaf && it->index == it->leaf->count)
+    {
+        // Every key of this leaf is smaller, the next leaf starts past key
+        it->leaf = it->leaf->next;
+        it->index = 0;
+    }
+    return it->leaf != NULL;
+}
+
+ss_bool_t ss_btree_next(ss_btree_t* t, ss_btree_iter_t* it)
+{
+    (void)t; // Unused
+    if (++it->index >= it->leaf->count)
+    {
+        it->leaf = it->leaf->next;
+        it->index = 0;
+    }
+    return it->leaf != NULL;
+}
+
+ss_bool_t ss_btree_prev(ss_btree_t* t, ss_btree_iter_t* it)
+{
+    (void)t; // Unused
+    if (it->index == 0)
+    {
+        it->leaf = it->leaf->prev;
+        it->index = it->leaf ? it->leaf->count - 1 : 0;
+        return it->leaf != NULL;
+    }
+    it->index--;
+    return SS_TRUE;
+}
+
+ss_bool_t ss_btree_range(ss_btree_t* t, const void* lo, const void* hi, ss_btree_iterate_cb_f cb,
+                         void* param)
+{
+    ss_btree_iter_t it;
+    ss_entry_t entry;
+    ss_bool_t valid = lo ? ss_btree_seek(t, lo, &it) : ss_btree_seek_first(t, &it);
+    entry.ksize = t->ksize;
+    entry.vsize = t->vsize;
+    for (; valid; valid = ss_btree_next(t, &it))
+    {
+        entry.key = ss_btree_iter_key(t, &it);
+        if (hi && _ss_btree_compare(t, entry.key, hi) >= 0)
+        {
+            break;
+        }
+        entry.value = ss_btree_iter_value(t, &it);
+        if (cb(t, &entry, param))
+        {
+            return SS_TRUE;
+        }
+    }
+    return SS_FALSE;
+}
+
+ss_bool_t ss_btree_iterate(ss_btree_t* t, ss_btree_iterate_cb_f cb, void* param)
+{
+    return ss_btree_range(t, NULL, NULL, cb, param);
+}
+
+static void _ss_btree_node_destroy(ss_btree_t* t, ss_btree_node_t* node)
+{
+    if (!node->leaf)
+    {
+        size_t i;
+        for (i = 0; i <= node->count; i++)
+        {
+            _ss_btree_node_destroy(t, _ss_btree_children(t, node)[i]);
+        }
+    }
+    _ss_btree_node_free(t, node);
+}
+
+void ss_btree_clear(ss_btree_t* t)
+{
+    if (t->root)
+    {
+        _ss_btree_node_destroy(t, t->root);
+    }
+    t->root = t->first = t->last = NULL;
+    t->size = 0;
+    t->height = 0;
+}
+
+size_t ss_btree_bytes(const ss_btree_t* t)
+{
+    return sizeof(ss_btree_t) + t->leaves * t->leaf_bytes + t->inners * t->inner_bytes;
+}
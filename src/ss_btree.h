@@ -0,0 +1,186 @@
+/**
+ * @file ss_btree.h
+ * @brief In-memory B+tree with fixed-width inline keys and values
+ * @author trywen@qq.com
+ * @date 2026-10-18
+ *
+ * Ordered map for large data sets. Features include:
+ * - Nodes of a few cache lines holding keys in one contiguous array
+ * - Values only in the leaves, which are linked for sequential scans both ways
+ * - No per-entry allocation: keys and values are copied inline with fixed sizes
+ * - O(n) bulk load from sorted input
+ *
+ * Keys are ordered by an ss_compare_f called with ksize for both sizes. Variable-size
+ * keys are stored as pointers and ordered by a pointer comparator such as
+ * ss_compare_string_ptr, the caller keeping the pointed-to bytes alive. A NULL
+ * comparator selects native uint64_t keys, searched without callbacks.
+ *
+ * Inserting and removing move entries between nodes, so value pointers and iterators
+ * stay valid only until the next modification.
+ */
+
+#ifndef SS_BTREE_H
+#define SS_BTREE_H
+
+#include "ss_types.h"
+
+/* Target node size in bytes, the capacities follow from the key and value sizes */
+#define SS_BTREE_NODE_BYTES 512
+
+/* Smallest node capacity, used when large keys or values exceed the target size */
+#define SS_BTREE_MIN_CAPACITY 4
+
+/**
+ * @struct ss_btree_node_s
+ * @brief Node header, followed by the key array and then the values (leaves) or
+ *        the child pointers (inner nodes)
+ */
+struct ss_btree_node_s
+{
+    ss_btree_node_t* prev; // Leaf siblings, NULL in inner nodes
+    ss_btree_node_t* next;
+    uint32_t count; // Keys in the node, an inner node has count + 1 children
+    uint32_t leaf;
+};
+
+/**
+ * @struct ss_btree_s
+ * @brief B+tree container structure
+ *
+ * @var root Root node, NULL for an empty tree
+ * @var first Leftmost leaf
+ * @var last Rightmost leaf
+ * @var size Number of stored pairs
+ * @var height Number of levels (0 for an empty tree)
+ * @var leaves Number of leaf nodes
+ * @var inners Number of inner nodes
+ * @var ksize Key size in bytes
+ * @var vsize Value size in bytes, 0 for a set
+ * @var key_compare Key order, NULL for native uint64_t keys
+ */
+struct ss_btree_s
+{
+    ss_btree_node_t* root;
+    ss_btree_node_t* first;
+    ss_btree_node_t* last;
+    size_t size;
+    size_t height;
+    size_t leaves;
+    size_t inners;
+
+    size_t ksize;
+    size_t vsize;
+    ss_compare_f key_compare;
+
+    size_t leaf_cap;    // Keys per leaf
+    size_t inner_cap;   // Keys per inner node
+    size_t leaf_voff;   // Offset of the value array in a leaf
+    size_t inner_coff;  // Offset of the child array in an inner node
+    size_t leaf_bytes;  // Allocation size of a leaf
+    size_t inner_bytes; // Allocation size of an inner node
+};
+
+/**
+ * @struct ss_btree_iter_s
+ * @brief Position of one entry in the leaf chain
+ */
+typedef struct ss_btree_iter_s
+{
+    ss_btree_node_t* leaf;
+    size_t index;
+} ss_btree_iter_t;
+
+/* If returns true, iteration will stop. The entry points into the tree */
+typedef ss_bool_t (*ss_btree_iterate_cb_f)(ss_btree_t* t, const ss_entry_t* entry, void* param);
+
+/**
+ * @brief Initialize B+tree
+ * @param[in] t Pointer to tree structure
+ * @param[in] ksize Key size in bytes, must be 8 when key_compare is NULL
+ * @param[in] vsize Value size in bytes (0 for a set)
+ * @param[in] key_compare Key order, NULL for native uint64_t keys
+ * @return SS_FALSE if the sizes are invalid
+ */
+ss_bool_t ss_btree_init(ss_btree_t* t, size_t ksize, size_t vsize, ss_compare_f key_compare);
+void ss_btree_destroy(ss_btree_t* t);
+
+/**
+ * @brief Create new B+tree instance
+ * @note Caller must free with ss_btree_free()
+ */
+ss_btree_t* ss_btree_create(size_t ksize, size_t vsize, ss_compare_f key_compare);
+void ss_btree_free(ss_btree_t* t);
+
+/**
+ * @brief Insert or update key-value pair
+ * @param[in] key ksize bytes
+ * @param[in] value vsize bytes, NULL stores zeros
+ * @return SS_TRUE on success, SS_FALSE on allocation failure
+ */
+ss_bool_t ss_btree_put(ss_btree_t* t, const void* key, const void* value);
+
+/**
+ * @brief Look up the value slot of a key
+ * @return Pointer to the stored value, NULL if not found
+ * @note Valid until the next put or remove; not to be dereferenced when vsize is 0
+ */
+void* ss_btree_find(ss_btree_t* t, const void* key);
+
+/**
+ * @brief Retrieve value associated with key
+ * @param[out] value Receives vsize bytes (may be NULL)
+ * @return SS_TRUE if found
+ */
+ss_bool_t ss_btree_get(ss_btree_t* t, const void* key, void* value);
+
+ss_bool_t ss_btree_remove(ss_btree_t* t, const void* key);
+
+/**
+ * @brief Fill an empty tree from strictly ascending keys in O(n)
+ * @param[in] keys n keys of ksize bytes each, contiguous
+ * @param[in] values n values of vsize bytes each, contiguous (NULL stores zeros)
+ * @param[in] n Number of pairs
+ * @return SS_FALSE if the tree is not empty, the keys are not strictly ascending or
+ *         allocation failed (the tree is left empty)
+ * @note Entries are spread evenly over ceil(n / leaf_cap) leaves, whose sizes differ
+ *       by at most one, and each inner level groups the level below evenly the same
+ *       way. Nodes are therefore full only when the counts divide exactly
+ */
+ss_bool_t ss_btree_bulk_load(ss_btree_t* t, const void* keys, const void* values, size_t n);
+
+/* Position an iterator, SS_FALSE if there is no such entry */
+ss_bool_t ss_btree_seek_first(ss_btree_t* t, ss_btree_iter_t* it);
+ss_bool_t ss_btree_seek_last(ss_btree_t* t, ss_btree_iter_t* it);
+// First entry whose key is not less than key
+ss_bool_t ss_btree_seek(ss_btree_t* t, const void* key, ss_btree_iter_t* it);
+
+/* Step an iterator, SS_FALSE past either end */
+ss_bool_t ss_btree_next(ss_btree_t* t, ss_btree_iter_t* it);
+ss_bool_t ss_btree_prev(ss_btree_t* t, ss_btree_iter_t* it);
+
+#define ss_btree_iter_key(t, it)                                                                   \
+    ((void*)((unsigned char*)((it)->leaf + 1) + (it)->index * (t)->ksize))
+#define ss_btree_iter_value(t, it)                                                                 \
+    ((void*)((unsigned char*)(it)->leaf + (t)->leaf_voff + (it)->index * (t)->vsize))
+
+/**
+ * @brief Visit the keys in [lo, hi) in ascending order, O(log n + k)
+ * @param[in] lo Inclusive lower key, NULL to start at the first entry
+ * @param[in] hi Exclusive upper key, NULL to run to the last entry
+ * @return SS_TRUE if the callback stopped the scan
+ * @note The callback must not modify the tree
+ */
+ss_bool_t ss_btree_range(ss_btree_t* t, const void* lo, const void* hi, ss_btree_iterate_cb_f cb,
+                         void* param);
+
+// param: user data for callback. Returns TRUE to stop iteration
+ss_bool_t ss_btree_iterate(ss_btree_t* t, ss_btree_iterate_cb_f cb, void* param);
+
+void ss_btree_clear(ss_btree_t* t);
+
+#define ss_btree_size(t) ((t)->size)
+
+/* Tree structure and all nodes in bytes */
+size_t ss_btree_bytes(const ss_btree_t* t);
+
+#endif /* SS_BTREE_H */
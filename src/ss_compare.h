@@ -261,8 +261,8 @@ static inline int ss_compare_ptr(const void* lvalue, size_t lsize, const void* r
 {
     (void)lsize;
     (void)rsize;
-    unsigned long lv = *((unsigned long*)lvalue);
-    unsigned long rv = *((unsigned long*)rvalue);
+    uintptr_t lv = (uintptr_t)*((void* const*)lvalue);
+    uintptr_t rv = (uintptr_t)*((void* const*)rvalue);
     return lv == rv ? 0 : (lv < rv ? -1 : 1);
 }
 
@@ -288,4 +288,51 @@ inline static int ss_compare_data_case(const void* lvalue, size_t lsize, const v
     return ss_compare_mem_case(left->data, left->size, right->data, right->size);
 }
 
+static inline int _ss_compare_slices(const ss_slice_t* parts, size_t count, const void* rvalue,
+                                     size_t rsize, int fold)
+{
+    const char* r = (const char*)rvalue;
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        size_t n = parts[i].size < rsize ? parts[i].size : rsize;
+        if (n > 0)
+        {
+            int cmprs =
+                fold ? ss_csl_memicmp(parts[i].data, r, (int)n) : memcmp(parts[i].data, r, n);
+            if (cmprs != 0)
+            {
+                return cmprs;
+            }
+        }
+        if (n < parts[i].size)
+        {
+            return 1; // rvalue is a proper prefix of the concatenation
+        }
+        r += n;
+        rsize -= n;
+    }
+    return rsize ? -1 : 0;
+}
+
+/**
+ * @brief Compare a key split into fragments with a contiguous one
+ * @param parts Fragments, compared as their concatenation
+ * @param count Number of fragments
+ * @param rvalue Contiguous key
+ * @param rsize Size of the contiguous key
+ * @return Sign of ss_compare_mem() on the concatenation, without building it
+ */
+static inline int ss_compare_slices(const ss_slice_t* parts, size_t count, const void* rvalue,
+                                    size_t rsize)
+{
+    return _ss_compare_slices(parts, count, rvalue, rsize, 0);
+}
+
+static inline int ss_compare_slices_case(const ss_slice_t* parts, size_t count,
+                                         const void* rvalue, size_t rsize)
+{
+    return _ss_compare_slices(parts, count, rvalue, rsize, 1);
+}
+
 #endif /* SS_COMPARE_H */
@@ -0,0 +1,225 @@
+#include "ss_alloc.h"
+#include "ss_atomic.h"
+#include "ss_countermap.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Caller hashes may be as weak as ss_hash_int, mix before masking
+static inline size_t _ss_countermap_index(const ss_countermap_t* m, size_t khash)
+{
+    return (size_t)ss_hash_fmix64(khash) & (m->bnum - 1);
+}
+
+#define _ss_countermap_shard(m, node, shard)                                                       \
+    (&(node)->counters[((shard) % (m)->nshards) * (m)->stride])
+
+// Scan a chain from first up to (excluding) last
+static ss_countermap_node_t* _ss_countermap_scan(ss_countermap_t* m, ss_countermap_node_t* first,
+                                                 ss_countermap_node_t* last, const void* key,
+                                                 size_t ksize, size_t khash)
+{
+    ss_countermap_node_t* node;
+    for (node = first; node != last; node = node->next)
+    {
+        if (node->khash == khash && m->key_compare(node->key, node->ksize, key, ksize) == 0)
+        {
+            return node;
+        }
+    }
+    return NULL;
+}
+
+static ss_countermap_node_t* _ss_countermap_node_new(ss_countermap_t* m, const void* key,
+                                                     size_t ksize, size_t khash)
+{
+    size_t counters = m->nshards * m->stride * sizeof(int64_t);
+    ss_countermap_node_t* node =
+        (ss_countermap_node_t*)ss_malloc(sizeof(ss_countermap_node_t) + counters + ksize);
+    if (!node)
+    {
+        return NULL;
+    }
+    memset(node, 0, sizeof(ss_countermap_node_t) + counters);
+    node->khash = khash;
+    node->ksize = ksize;
+    node->key = (char*)node->counters + counters;
+    memcpy(node->key, key, ksize);
+    return node;
+}
+
+ss_bool_t ss_countermap_init(ss_countermap_t* m, size_t bnum, size_t nshards, ss_hash_f hash,
+                             ss_compare_f compare)
+{
+    memset(m, 0, sizeof(ss_countermap_t));
+    m->bnum = 1;
+    while (m->bnum < (bnum ? bnum : SS_DEFAULT_COUNTERMAP_BUCKETS))
+    {
+        m->bnum <<= 1;
+    }
+    m->nshards = nshards ? nshards : 1;
+    m->stride = m->nshards > 1 ? SS_COUNTERMAP_SHARD_STRIDE / sizeof(int64_t) : 1;
+    m->hash = hash ? hash : ss_hash64_mem;
+    m->key_compare = compare ? compare : ss_compare_mem;
+    m->buckets = (ss_countermap_node_t**)ss_malloc(m->bnum * sizeof(ss_countermap_node_t*));
+    if (!m->buckets)
+    {
+        return SS_FALSE;
+    }
+    memset(m->buckets, 0, m->bnum * sizeof(ss_countermap_node_t*));
+    return SS_TRUE;
+}
+
+void ss_countermap_destroy(ss_countermap_t* m)
+{
+    if (m->buckets)
+    {
+        ss_countermap_clear(m);
+        ss_free(m->buckets);
+        m->buckets = NULL;
+    }
+}
+
+ss_countermap_t* ss_countermap_create(size_t bnum, size_t nshards, ss_hash_f hash,
+                                      ss_compare_f compare)
+{
+    ss_countermap_t* m = (ss_countermap_t*)ss_malloc(sizeof(ss_countermap_t));
+    if (!m)
+    {
+        return NULL;
+    }
+    if (!ss_countermap_init(m, bnum, nshards, hash, compare))
+    {
+        ss_free(m);
+        return NULL;
+    }
+    return m;
+}
+
+void ss_countermap_free(ss_countermap_t* m)
+{
+    ss_countermap_destroy(m);
+    ss_free(m);
+}
+
+ss_countermap_node_t* ss_countermap_find(ss_countermap_t* m, const void* key, size_t ksize)
+{
+    size_t khash = m->hash(key, ksize);
+    ss_countermap_node_t* first = ss_atomic_load(&m->buckets[_ss_countermap_index(m, khash)]);
+    return _ss_countermap_scan(m, first, NULL, key, ksize, khash);
+}
+
+ss_countermap_node_t* ss_countermap_ref(ss_countermap_t* m, const void* key, size_t ksize)
+{
+    size_t khash = m->hash(key, ksize);
+    ss_countermap_node_t** head = &m->buckets[_ss_countermap_index(m, khash)];
+    ss_countermap_node_t* first = ss_atomic_load(head);
+    ss_countermap_node_t* node = _ss_countermap_scan(m, first, NULL, key, ksize, khash);
+    if (node)
+    {
+        return node;
+    }
+
+    ss_countermap_node_t* fresh = _ss_countermap_node_new(m, key, ksize, khash);
+    if (!fresh)
+    {
+        return NULL;
+    }
+    fresh->next = first;
+    while (!ss_atomic_cas(head, &fresh->next, fresh))
+    {
+        // Lost the race: only nodes pushed since our last scan can hold the key
+        node = _ss_countermap_scan(m, fresh->next, first, key, ksize, khash);
+        if (node)
+        {
+            ss_free(fresh);
+            return node;
+        }
+        first = fresh->next;
+    }
+    ss_atomic_fetch_add(&m->size, (size_t)1);
+    return fresh;
+}
+
+void ss_countermap_node_add(ss_countermap_t* m, ss_countermap_node_t* node, size_t shard,
+                            int64_t delta)
+{
+    ss_atomic_fetch_add(_ss_countermap_shard(m, node, shard), delta);
+}
+
+int64_t ss_countermap_node_value(ss_countermap_t* m, ss_countermap_node_t* node)
+{
+    int64_t sum = 0;
+    size_t i;
+    for (i = 0; i < m->nshards; i++)
+    {
+        sum += ss_atomic_load_relaxed(_ss_countermap_shard(m, node, i));
+    }
+    return sum;
+}
+
+ss_bool_t ss_countermap_add_shard(ss_countermap_t* m, const void* key, size_t ksize, size_t shard,
+                                  int64_t delta)
+{
+    ss_countermap_node_t* node = ss_countermap_ref(m, key, ksize);
+    if (!node)
+    {
+        return SS_FALSE;
+    }
+    ss_countermap_node_add(m, node, shard, delta);
+    return SS_TRUE;
+}
+
+int64_t ss_countermap_get(ss_countermap_t* m, const void* key, size_t ksize)
+{
+    ss_countermap_node_t* node = ss_countermap_find(m, key, ksize);
+    return node ? ss_countermap_node_value(m, node) : 0;
+}
+
+ss_bool_t ss_countermap_snapshot(ss_countermap_t* m, ss_countermap_snapshot_cb_f cb, void* param,
+                                 ss_bool_t reset)
+{
+    size_t b;
+    for (b = 0; b < m->bnum; b++)
+    {
+        ss_countermap_node_t* node;
+        for (node = ss_atomic_load(&m->buckets[b]); node; node = node->next)
+        {
+            int64_t sum = 0;
+            size_t i;
+            for (i = 0; i < m->nshards; i++)
+            {
+                int64_t* counter = _ss_countermap_shard(m, node, i);
+                int64_t v = ss_atomic_load_relaxed(counter);
+                if (reset && v)
+                {
+                    ss_atomic_fetch_add(counter, -v);
+                }
+                sum += v;
+            }
+            if (cb(m, node->key, node->ksize, sum, param))
+            {
+                return SS_TRUE;
+            }
+        }
+    }
+    return SS_FALSE;
+}
+
+void ss_countermap_clear(ss_countermap_t* m)
+{
+    size_t b;
+    for (b = 0; b < m->bnum; b++)
+    {
+        ss_countermap_node_t* node = m->buckets[b];
+        while (node)
+        {
+            ss_countermap_node_t* next = node->next;
+            ss_free(node);
+            node = next;
+        }
+        m->buckets[b] = NULL;
+    }
+    m->size = 0;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file ss_countermap.h
+ * @brief Concurrent key to int64_t counter map for metrics aggregation
+ * @author trywen@qq.com
+ * @date 2026-10-18
+ *
+ * Counters keyed by arbitrary bytes, safe to update from many threads. Features include:
+ * - Lock-free add on existing keys (a single relaxed atomic add)
+ * - Lock-free insertion of new keys by pushing onto a fixed bucket chain
+ * - Optional per-thread shards, each on its own cache line, merged on read
+ * - Snapshot with reset for periodic flush without losing concurrent adds
+ *
+ * Nodes are never unlinked while the map is shared, so node handles from
+ * ss_countermap_ref() stay valid until ss_countermap_clear() or destroy, which
+ * must not run concurrently with other calls.
+ */
+
+#ifndef SS_COUNTERMAP_H
+#define SS_COUNTERMAP_H
+
+#include "ss_types.h"
+
+#include "ss_compare.h"
+#include "ss_hash.h"
+
+/* Bytes between two shards of a counter, keeps shards off each other's cache line */
+#define SS_COUNTERMAP_SHARD_STRIDE 64
+#define SS_DEFAULT_COUNTERMAP_BUCKETS 256
+
+/**
+ * @struct ss_countermap_node_s
+ * @brief Counter node: header, shard counters, then key bytes
+ *
+ * @var counters nshards counters, SS_COUNTERMAP_SHARD_STRIDE bytes apart when sharded
+ */
+struct ss_countermap_node_s
+{
+    struct ss_countermap_node_s* next;
+    size_t khash;
+    size_t ksize;
+    void* key;
+    int64_t counters[];
+};
+
+/**
+ * @struct ss_countermap_s
+ * @brief Counter map container structure
+ *
+ * @var buckets Bucket chain heads, fixed at init
+ * @var bnum Bucket count (power of two)
+ * @var nshards Counter shards per key
+ * @var stride int64_t slots between two shards
+ * @var size Number of keys
+ */
+struct ss_countermap_s
+{
+    ss_countermap_node_t** buckets;
+    size_t bnum;
+    size_t nshards;
+    size_t stride;
+    size_t size;
+
+    ss_hash_f hash;
+    ss_compare_f key_compare;
+};
+
+/* If returns true, snapshot will stop */
+typedef ss_bool_t (*ss_countermap_snapshot_cb_f)(ss_countermap_t* m, const void* key, size_t ksize,
+                                                 int64_t value, void* param);
+
+/**
+ * @brief Initialize counter map
+ * @param[in] m Pointer to map structure
+ * @param[in] bnum Bucket count, rounded up to a power of two (0 = default)
+ * @param[in] nshards Counter shards per key, e.g. the number of updating threads (0 = 1)
+ * @param[in] hash Key hash function (NULL = ss_hash64_mem)
+ * @param[in] compare Key compare function (NULL = ss_compare_mem)
+ * @return SS_TRUE if initialization succeeded
+ */
+ss_bool_t ss_countermap_init(ss_countermap_t* m, size_t bnum, size_t nshards, ss_hash_f hash,
+                             ss_compare_f compare);
+void ss_countermap_destroy(ss_countermap_t* m);
+
+/**
+ * @brief Create new counter map instance
+ * @note Caller must free with ss_countermap_free()
+ */
+ss_countermap_t* ss_countermap_create(size_t bnum, size_t nshards, ss_hash_f hash,
+                                      ss_compare_f compare);
+void ss_countermap_free(ss_countermap_t* m);
+
+/**
+ * @brief Find or insert the counter node of a key
+ * @return Node handle valid until clear/destroy, NULL on allocation failure
+ * @note Cache the handle to turn hot updates into ss_countermap_node_add()
+ */
+ss_countermap_node_t* ss_countermap_ref(ss_countermap_t* m, const void* key, size_t ksize);
+
+/**
+ * @brief Find the counter node of a key without inserting
+ * @return Node handle, NULL if the key is absent
+ */
+ss_countermap_node_t* ss_countermap_find(ss_countermap_t* m, const void* key, size_t ksize);
+
+/**
+ * @brief Atomically add to one shard of a node
+ * @param[in] shard Caller's shard index, taken modulo nshards
+ */
+void ss_countermap_node_add(ss_countermap_t* m, ss_countermap_node_t* node, size_t shard,
+                            int64_t delta);
+
+/**
+ * @brief Sum of all shards of a node
+ */
+int64_t ss_countermap_node_value(ss_countermap_t* m, ss_countermap_node_t* node);
+
+/**
+ * @brief Add to the counter of a key on a given shard, inserting the key if needed
+ * @return SS_TRUE on success, SS_FALSE on allocation failure
+ */
+ss_bool_t ss_countermap_add_shard(ss_countermap_t* m, const void* key, size_t ksize, size_t shard,
+                                  int64_t delta);
+
+#define ss_countermap_add(m, key, ksize, delta)                                                    \
+    ss_countermap_add_shard((m), (key), (ksize), 0, (delta))
+
+/**
+ * @brief Merged counter value of a key, 0 if absent
+ */
+int64_t ss_countermap_get(ss_countermap_t* m, const void* key, size_t ksize);
+
+/**
+ * @brief Visit every key with its merged value
+ * @param[in] reset SS_TRUE to subtract the reported value from each shard, so adds racing
+ *            with the snapshot are carried into the next one instead of being lost
+ * @return SS_TRUE if the callback stopped the snapshot
+ */
+ss_bool_t ss_countermap_snapshot(ss_countermap_t* m, ss_countermap_snapshot_cb_f cb, void* param,
+                                 ss_bool_t reset);
+
+/**
+ * @brief Remove all keys
+ * @note Not thread-safe, invalidates node handles
+ */
+void ss_countermap_clear(ss_countermap_t* m);
+
+#define ss_countermap_size(m) ((m)->size)
+
+#endif /* SS_COUNTERMAP_H */
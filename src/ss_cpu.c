@@ -0,0 +1,52 @@
+#include "ss_atomic.h"
+#include "ss_cpu.h"
+
+// Bit never used by a feature, marks the cache as not filled yet
+#define _SS_CPU_UNKNOWN 0x80000000u
+
+static uint32_t _ss_cpu_detected = _SS_CPU_UNKNOWN;
+static uint32_t _ss_cpu_mask = ~0u;
+
+static uint32_t _ss_cpu_detect(void)
+{
+    uint32_t features = 0;
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    // Also checks that the OS saves the wider register state (AVX)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2"))
+    {
+        features |= SS_CPU_SSE2;
+    }
+    if (__builtin_cpu_supports("sse4.2"))
+    {
+        features |= SS_CPU_SSE42;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        features |= SS_CPU_AVX2;
+    }
+#elif defined(__aarch64__)
+    features |= SS_CPU_NEON;
+#if defined(__ARM_FEATURE_CRC32)
+    features |= SS_CPU_ARM_CRC32;
+#endif
+#endif
+    return features;
+}
+
+uint32_t ss_cpu_features(void)
+{
+    uint32_t features = ss_atomic_load_relaxed(&_ss_cpu_detected);
+    if (features == _SS_CPU_UNKNOWN)
+    {
+        // Detection is idempotent, racing first callers store the same value
+        features = _ss_cpu_detect();
+        ss_atomic_store(&_ss_cpu_detected, features);
+    }
+    return features & ss_atomic_load_relaxed(&_ss_cpu_mask);
+}
+
+void ss_cpu_mask_features(uint32_t mask)
+{
+    ss_atomic_store(&_ss_cpu_mask, mask);
+}
@@ -0,0 +1,36 @@
+/**
+ * @file ss_cpu.h
+ * @brief Runtime CPU feature detection for dispatching accelerated kernels
+ * @author trywen@qq.com
+ * @date 2026-10-18
+ *
+ * Kernels compiled for an instruction set extension check ss_cpu_has() and fall
+ * back to portable C otherwise. Features are detected once and cached.
+ */
+
+#ifndef SS_CPU_H
+#define SS_CPU_H
+
+#include "ss_types.h"
+
+#define SS_CPU_SSE2 0x01      /* x86 SSE2 */
+#define SS_CPU_SSE42 0x02     /* x86 SSE4.2, includes the crc32 instruction */
+#define SS_CPU_AVX2 0x04      /* x86 AVX2 */
+#define SS_CPU_NEON 0x10      /* ARM Advanced SIMD */
+#define SS_CPU_ARM_CRC32 0x20 /* ARMv8 CRC32 extension */
+
+/**
+ * @brief Features of this CPU that this build can emit code for
+ * @return Combination of SS_CPU_* flags, after ss_cpu_mask_features()
+ */
+uint32_t ss_cpu_features(void);
+
+/**
+ * @brief Restrict the reported features, e.g. to exercise portable fallbacks
+ * @param[in] mask Features to keep; ~0u restores everything detected
+ */
+void ss_cpu_mask_features(uint32_t mask);
+
+#define ss_cpu_has(f) ((ss_cpu_features() & (f)) == (f))
+
+#endif /* SS_CPU_H */
@@ -2,39 +2,25 @@
 #ifndef SS_STD_ADAPTER_H
 #define SS_STD_ADAPTER_H
 
+#include "ss_ascii.h"
 #include "ss_version.h"
 
 #if USE_STANDARD_TOLOWER
 #define ss_csl_tolower(c) tolower((int)(c))
 #else
-#define ss_csl_tolower(c) ((((c) > 'A') && ((c) < 'Z')) ? ((c) - 'A' + 'a') : (c))
+#define ss_csl_tolower(c) ss_ascii_tolower(c)
 #endif
 
 #if USE_STANDARD_TOUPPER
 #define ss_csl_toupper(c) toupper((int)(c))
 #else
-#define ss_csl_toupper(c) ((((c) >= 'a') && ((c) <= 'z')) ? ((c) - 'a' + 'A') : (c))
+#define ss_csl_toupper(c) ss_ascii_toupper(c)
 #endif
 
+/* ASCII only, independent of USE_STANDARD_TOLOWER so the vector kernels apply */
 static inline int ss_csl_memicmp(const void* lbuf, const void* rbuf, int count)
 {
-    int f = 0;
-    int l = 0;
-    while (count--)
-    {
-        if ((*(unsigned char*)lbuf == *(unsigned char*)rbuf) ||
-            ((f = ss_csl_tolower(*(unsigned char*)lbuf)) ==
-             (l = ss_csl_tolower(*(unsigned char*)rbuf))))
-        {
-            lbuf = (char*)lbuf + 1;
-            rbuf = (char*)rbuf + 1;
-        }
-        else
-        {
-            break;
-        }
-    }
-    return f - l;
+    return count > 0 ? ss_ascii_memicmp(lbuf, rbuf, (size_t)count) : 0;
 }
 
 static inline int ss_csl_stricmp(const char* dst, const char* src)
@@ -0,0 +1,269 @@
+#include "ss_atomic.h"
+#include "ss_cpu.h"
+#include "ss_hash.h"
+
+#include <time.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define _SS_CRC32C_X86 1
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define _SS_CRC32C_ARM 1
+#endif
+
+// Reflected Castagnoli polynomial
+#define _SS_CRC32C_POLY 0x82f63b78u
+
+// 0 means not drawn yet
+static uint64_t _ss_hash_seed = 0;
+static uint64_t _ss_hash_seed_counter = 0;
+
+static uint64_t _ss_hash_draw_seed(void)
+{
+    struct
+    {
+        uint64_t now;
+        uint64_t ticks;
+        uintptr_t stack;
+        uintptr_t code;
+        uintptr_t data;
+    } entropy;
+    memset(&entropy, 0, sizeof(entropy));
+    entropy.now = (uint64_t)time(NULL);
+    entropy.ticks = (uint64_t)clock();
+    // ASLR places stack, code and data at per-process random addresses
+    entropy.stack = (uintptr_t)&entropy;
+    entropy.code = (uintptr_t)&_ss_hash_draw_seed;
+    entropy.data = (uintptr_t)&_ss_hash_seed;
+    uint64_t seed = ss_hash64(&entropy, sizeof(entropy), SS_HASH64_SECRET2);
+    return seed ? seed : SS_HASH64_SECRET3;
+}
+
+uint64_t ss_hash_process_seed(void)
+{
+    uint64_t seed = ss_atomic_load(&_ss_hash_seed);
+    if (!seed)
+    {
+        // Racing first callers all settle on whichever draw is published first
+        uint64_t expected = 0;
+        seed = _ss_hash_draw_seed();
+        if (!ss_atomic_cas(&_ss_hash_seed, &expected, seed))
+        {
+            seed = expected;
+        }
+    }
+    return seed;
+}
+
+void ss_hash_set_process_seed(uint64_t seed)
+{
+    ss_atomic_store(&_ss_hash_seed, seed ? seed : SS_HASH64_SECRET3);
+}
+
+uint64_t ss_hash_random_seed(void)
+{
+    uint64_t n = ss_atomic_fetch_add(&_ss_hash_seed_counter, (uint64_t)1);
+    return ss_hash64(&n, sizeof(n), ss_hash_process_seed());
+}
+
+/* Incremental ss_hash64(). The one-shot hash only runs its 48-byte lanes while more
+ * than 48 bytes remain, so a full pending block is consumed once the next byte arrives.
+ * The tail load may reach 15 bytes back, hence the 16-byte history in front. */
+
+#define _SS_HASHER_HISTORY 16
+#define _SS_HASHER_BLOCK 48
+
+static void _ss_hasher_init(ss_hasher_t* h, uint64_t seed, int fold)
+{
+    h->seed = seed;
+    seed ^= _ss_hash_mix(seed ^ SS_HASH64_SECRET0, SS_HASH64_SECRET1);
+    h->seeds[0] = h->seeds[1] = h->seeds[2] = seed;
+    h->len = 0;
+    h->used = 0;
+    h->fold = fold;
+}
+
+void ss_hasher_init(ss_hasher_t* h, uint64_t seed)
+{
+    _ss_hasher_init(h, seed, 0);
+}
+
+void ss_hasher_init_case(ss_hasher_t* h, uint64_t seed)
+{
+    _ss_hasher_init(h, seed, 1);
+}
+
+void ss_hasher_update(ss_hasher_t* h, const void* data, size_t len)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    uint8_t* pending = h->buf + _SS_HASHER_HISTORY;
+    h->len += len;
+    while (len > 0)
+    {
+        if (h->used == _SS_HASHER_BLOCK)
+        {
+            _ss_hash64_lanes(pending, h->seeds, h->fold);
+            memcpy(h->buf, pending + _SS_HASHER_BLOCK - _SS_HASHER_HISTORY, _SS_HASHER_HISTORY);
+            h->used = 0;
+        }
+        if (h->used == 0 && len > _SS_HASHER_BLOCK)
+        {
+            // Consume whole blocks straight from the fragment
+            do
+            {
+                _ss_hash64_lanes(p, h->seeds, h->fold);
+                p += _SS_HASHER_BLOCK;
+                len -= _SS_HASHER_BLOCK;
+            } while (len > _SS_HASHER_BLOCK);
+            memcpy(h->buf, p - _SS_HASHER_HISTORY, _SS_HASHER_HISTORY);
+        }
+        size_t n = _SS_HASHER_BLOCK - h->used;
+        n = n < len ? n : len;
+        memcpy(pending + h->used, p, n);
+        h->used += n;
+        p += n;
+        len -= n;
+    }
+}
+
+uint64_t ss_hasher_final(const ss_hasher_t* h)
+{
+    const uint8_t* pending = h->buf + _SS_HASHER_HISTORY;
+    if (h->len <= _SS_HASHER_BLOCK)
+    {
+        // No block consumed yet, the whole key is pending
+        return _ss_hash64(pending, h->used, h->seed, h->fold);
+    }
+    return _ss_hash64_tail(pending, h->used, h->seeds[0] ^ h->seeds[1] ^ h->seeds[2], h->len,
+                           h->fold);
+}
+
+static uint64_t _ss_hash64_slices(const ss_slice_t* parts, size_t count, uint64_t seed, int fold)
+{
+    ss_hasher_t h;
+    size_t i;
+    _ss_hasher_init(&h, seed, fold);
+    for (i = 0; i < count; i++)
+    {
+        ss_hasher_update(&h, parts[i].data, parts[i].size);
+    }
+    return ss_hasher_final(&h);
+}
+
+uint64_t ss_hash64_slices(const ss_slice_t* parts, size_t count, uint64_t seed)
+{
+    return _ss_hash64_slices(parts, count, seed, 0);
+}
+
+uint64_t ss_hash64_slices_case(const ss_slice_t* parts, size_t count, uint64_t seed)
+{
+    return _ss_hash64_slices(parts, count, seed, 1);
+}
+
+/* CRC32C, slicing-by-8 software fallback */
+
+static uint32_t _ss_crc32c_table[8][256];
+static int _ss_crc32c_table_ready = 0;
+
+static void _ss_crc32c_table_init(void)
+{
+    uint32_t i, k;
+    for (i = 0; i < 256; i++)
+    {
+        uint32_t crc = i;
+        for (k = 0; k < 8; k++)
+        {
+            crc = (crc >> 1) ^ (_SS_CRC32C_POLY & (0u - (crc & 1)));
+        }
+        _ss_crc32c_table[0][i] = crc;
+    }
+    for (i = 0; i < 256; i++)
+    {
+        for (k = 1; k < 8; k++)
+        {
+            uint32_t prev = _ss_crc32c_table[k - 1][i];
+            _ss_crc32c_table[k][i] = (prev >> 8) ^ _ss_crc32c_table[0][prev & 0xff];
+        }
+    }
+    ss_atomic_store(&_ss_crc32c_table_ready, 1);
+}
+
+static uint32_t _ss_crc32c_sw(uint32_t crc, const uint8_t* p, size_t len)
+{
+    if (!ss_atomic_load(&_ss_crc32c_table_ready))
+    {
+        _ss_crc32c_table_init();
+    }
+    while (len >= 8)
+    {
+        // Little-endian assembly keeps the result independent of the host byte order
+        uint32_t lo = crc ^ ((uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 |
+                             (uint32_t)p[3] << 24);
+        crc = _ss_crc32c_table[7][lo & 0xff] ^ _ss_crc32c_table[6][(lo >> 8) & 0xff] ^
+              _ss_crc32c_table[5][(lo >> 16) & 0xff] ^ _ss_crc32c_table[4][lo >> 24] ^
+              _ss_crc32c_table[3][p[4]] ^ _ss_crc32c_table[2][p[5]] ^
+              _ss_crc32c_table[1][p[6]] ^ _ss_crc32c_table[0][p[7]];
+        p += 8;
+        len -= 8;
+    }
+    while (len--)
+    {
+        crc = (crc >> 8) ^ _ss_crc32c_table[0][(crc ^ *p++) & 0xff];
+    }
+    return crc;
+}
+
+#if defined(_SS_CRC32C_X86)
+__attribute__((target("sse4.2"))) static uint32_t _ss_crc32c_hw(uint32_t crc, const uint8_t* p,
+                                                                  size_t len)
+{
+    uint64_t c = crc;
+    while (len >= 8)
+    {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        c = _mm_crc32_u64(c, v);
+        p += 8;
+        len -= 8;
+    }
+    crc = (uint32_t)c;
+    while (len--)
+    {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+    return crc;
+}
+#define _SS_CRC32C_HW_FEATURE SS_CPU_SSE42
+#elif defined(_SS_CRC32C_ARM)
+static uint32_t _ss_crc32c_hw(uint32_t crc, const uint8_t* p, size_t len)
+{
+    while (len >= 8)
+    {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        crc = __crc32cd(crc, v);
+        p += 8;
+        len -= 8;
+    }
+    while (len--)
+    {
+        crc = __crc32cb(crc, *p++);
+    }
+    return crc;
+}
+#define _SS_CRC32C_HW_FEATURE SS_CPU_ARM_CRC32
+#endif
+
+uint32_t ss_hash_crc32c_update(uint32_t crc, const void* data, size_t len)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+#if defined(_SS_CRC32C_HW_FEATURE)
+    if (ss_cpu_has(_SS_CRC32C_HW_FEATURE))
+    {
+        return ~_ss_crc32c_hw(crc, p, len);
+    }
+#endif
+    return ~_ss_crc32c_sw(crc, p, len);
+}
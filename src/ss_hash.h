@@ -9,16 +9,24 @@
  * - Memory blocks with case-sensitive/insensitive options
  * - Strings with case-sensitive/insensitive options
  * - Pointer values
+ * - ss_hash64(), a wyhash-style 64-bit block hash, with the ss_hash64_* adapters
+ * - Seeded ss_hash64_*_seeded variants and process/per-map random seeds
+ * - Integer finalizers (fmix64, splitmix64) and the ss_hash_*_mix adapters
+ * - CRC32C with hardware dispatch through ss_cpu.h
+ * - ss_hasher_t, incremental ss_hash64() over keys split into fragments
  *
- * All functions are inline for optimal performance.
+ * All hash functions are inline for optimal performance.
  */
 
 #ifndef SS_HASH_H
 #define SS_HASH_H
 
+#include "ss_ascii.h"
 #include "ss_csl_adapter.h"
+#include "ss_slice.h"
 #include "ss_types.h"
 #include <ctype.h>
+#include <string.h>
 
 /**
  * @brief Hashes a character value
@@ -116,17 +124,87 @@ static inline size_t ss_hash_ulong(const void* value, size_t size)
     return *((unsigned long*)value);
 }
 
+/** Integer finalizers: every input bit affects every output bit */
+
+/**
+ * @brief MurmurHash3 64-bit finalizer
+ */
+static inline uint64_t ss_hash_fmix64(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+/**
+ * @brief splitmix64 output function, including its golden-ratio increment
+ */
+static inline uint64_t ss_hash_splitmix64(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Fibonacci multiply folded once: one multiply, weaker than fmix64 but cheapest
+ */
+static inline uint64_t ss_hash_mulxor64(uint64_t x)
+{
+    x *= 0x9e3779b97f4a7c15ULL;
+    return x ^ (x >> 32);
+}
+
+/** ss_hash_f adapters mixing the integer with ss_hash_fmix64() */
+static inline size_t ss_hash_int_mix(const void* value, size_t size)
+{
+    (void)size;
+    return (size_t)ss_hash_fmix64((uint64_t)(unsigned int)*((const int*)value));
+}
+
+static inline size_t ss_hash_uint_mix(const void* value, size_t size)
+{
+    (void)size;
+    return (size_t)ss_hash_fmix64(*((const unsigned int*)value));
+}
+
+static inline size_t ss_hash_long_mix(const void* value, size_t size)
+{
+    (void)size;
+    return (size_t)ss_hash_fmix64((uint64_t)(unsigned long)*((const long*)value));
+}
+
+static inline size_t ss_hash_ulong_mix(const void* value, size_t size)
+{
+    (void)size;
+    return (size_t)ss_hash_fmix64(*((const unsigned long*)value));
+}
+
+static inline size_t ss_hash_int64_mix(const void* value, size_t size)
+{
+    (void)size;
+    return (size_t)ss_hash_fmix64((uint64_t)*((const int64_t*)value));
+}
+
+static inline size_t ss_hash_uint64_mix(const void* value, size_t size)
+{
+    (void)size;
+    return (size_t)ss_hash_fmix64(*((const uint64_t*)value));
+}
+
 /** Hash calculation for data blocks */
 /**
- * @brief Hashes a memory block
- * @param value Pointer to memory block
- * @param size Size of memory block in bytes
- * @return Computed hash value using polynomial accumulation
+ * @brief Continue ss_hash_mem() over the next fragment of a key
+ * @param h Result of the previous call, 0 to start
+ * @return ss_hash_mem() of everything hashed so far
  */
-static inline size_t ss_hash_mem(const void* value, size_t size)
+static inline size_t ss_hash_mem_update(size_t h, const void* value, size_t size)
 {
     const char* s = (const char*)value;
-    size_t h = 0;
     size_t i;
     for (i = 0; i < size; i++)
     {
@@ -135,6 +213,17 @@ static inline size_t ss_hash_mem(const void* value, size_t size)
     return h;
 }
 
+/**
+ * @brief Hashes a memory block
+ * @param value Pointer to memory block
+ * @param size Size of memory block in bytes
+ * @return Computed hash value using polynomial accumulation
+ */
+static inline size_t ss_hash_mem(const void* value, size_t size)
+{
+    return ss_hash_mem_update(0, value, size);
+}
+
 static inline size_t ss_hash_mem_ptr(const void* value, size_t size)
 {
     (void)size;
@@ -247,10 +336,352 @@ static inline size_t ss_hash_string_case_ptr(const void* value, size_t size)
     return ss_hash_string_case(*((const char**)value), size);
 }
 
+/** 64-bit block hash (wyhash construction) */
+
+#define SS_HASH64_SECRET0 0xa0761d6478bd642fULL
+#define SS_HASH64_SECRET1 0xe7037ed1a0b428dbULL
+#define SS_HASH64_SECRET2 0x8ebc6af09c88c6e3ULL
+#define SS_HASH64_SECRET3 0x589965cc75374cc3ULL
+
+/* 64x64 -> 128 bit multiply, low half into *a and high half into *b */
+static inline void _ss_hash_mum(uint64_t* a, uint64_t* b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline uint64_t _ss_hash_mix(uint64_t a, uint64_t b)
+{
+    _ss_hash_mum(&a, &b);
+    return a ^ b;
+}
+
+/* Native-endian loads, hash values are only stable within one byte order */
+static inline uint64_t _ss_hash_r8(const uint8_t* p, int fold)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return fold ? ss_ascii_toupper64(v) : v;
+}
+
+static inline uint64_t _ss_hash_r4(const uint8_t* p, int fold)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return fold ? ss_ascii_toupper64(v) : v;
+}
+
+static inline uint64_t _ss_hash_r3(const uint8_t* p, size_t len, int fold)
+{
+    uint64_t v = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+    return fold ? ss_ascii_toupper64(v) : v;
+}
+
+/* One step of the three 16-byte lanes, seeds[0] is the main lane */
+static inline void _ss_hash64_lanes(const uint8_t* p, uint64_t seeds[3], int fold)
+{
+    seeds[0] = _ss_hash_mix(_ss_hash_r8(p, fold) ^ SS_HASH64_SECRET1,
+                            _ss_hash_r8(p + 8, fold) ^ seeds[0]);
+    seeds[1] = _ss_hash_mix(_ss_hash_r8(p + 16, fold) ^ SS_HASH64_SECRET2,
+                            _ss_hash_r8(p + 24, fold) ^ seeds[1]);
+    seeds[2] = _ss_hash_mix(_ss_hash_r8(p + 32, fold) ^ SS_HASH64_SECRET3,
+                            _ss_hash_r8(p + 40, fold) ^ seeds[2]);
+}
+
+static inline uint64_t _ss_hash64_finish(uint64_t a, uint64_t b, uint64_t seed, uint64_t len)
+{
+    a ^= SS_HASH64_SECRET1;
+    b ^= seed;
+    _ss_hash_mum(&a, &b);
+    return _ss_hash_mix(a ^ SS_HASH64_SECRET0 ^ len, b ^ SS_HASH64_SECRET1);
+}
+
+/* Last 1..48 bytes of a key longer than 16, the final load may reach back into p[-15] */
+static inline uint64_t _ss_hash64_tail(const uint8_t* p, size_t i, uint64_t seed, uint64_t len,
+                                       int fold)
+{
+    while (i > 16)
+    {
+        seed = _ss_hash_mix(_ss_hash_r8(p, fold) ^ SS_HASH64_SECRET1,
+                            _ss_hash_r8(p + 8, fold) ^ seed);
+        i -= 16;
+        p += 16;
+    }
+    return _ss_hash64_finish(_ss_hash_r8(p + i - 16, fold), _ss_hash_r8(p + i - 8, fold), seed,
+                             len);
+}
+
+static inline uint64_t _ss_hash64(const void* data, size_t len, uint64_t seed, int fold)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    uint64_t a, b;
+    seed ^= _ss_hash_mix(seed ^ SS_HASH64_SECRET0, SS_HASH64_SECRET1);
+    if (len > 16)
+    {
+        size_t i = len;
+        if (i > 48)
+        {
+            // Three independent 16-byte lanes per step
+            uint64_t seeds[3] = {seed, seed, seed};
+            do
+            {
+                _ss_hash64_lanes(p, seeds, fold);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed = seeds[0] ^ seeds[1] ^ seeds[2];
+        }
+        return _ss_hash64_tail(p, i, seed, len, fold);
+    }
+    // Short keys: two overlapping loads cover every byte, no loop
+    if (len >= 4)
+    {
+        size_t off = (len >> 3) << 2;
+        a = (_ss_hash_r4(p, fold) << 32) | _ss_hash_r4(p + off, fold);
+        b = (_ss_hash_r4(p + len - 4, fold) << 32) | _ss_hash_r4(p + len - 4 - off, fold);
+    }
+    else if (len > 0)
+    {
+        a = _ss_hash_r3(p, len, fold);
+        b = 0;
+    }
+    else
+    {
+        a = b = 0;
+    }
+    return _ss_hash64_finish(a, b, seed, len);
+}
+
+/**
+ * @brief 64-bit hash of a memory block
+ * @param data Pointer to memory block
+ * @param len Size of memory block in bytes
+ * @param seed Hash seed
+ * @return 64-bit hash, every input bit affects every output bit
+ *
+ * Consumes 16 bytes per step (48 for long keys); keys of 16 bytes or less
+ * take a branch-light path with no loop.
+ */
+static inline uint64_t ss_hash64(const void* data, size_t len, uint64_t seed)
+{
+    return _ss_hash64(data, len, seed, 0);
+}
+
+/**
+ * @brief ASCII case-insensitive ss_hash64(), equal to ss_hash64() of the upper-cased block
+ */
+static inline uint64_t ss_hash64_case(const void* data, size_t len, uint64_t seed)
+{
+    return _ss_hash64(data, len, seed, 1);
+}
+
+/* Length of a string bounded by size, 0 meaning NUL-terminated */
+static inline size_t _ss_hash_strlen(const char* s, size_t size)
+{
+    if (size == 0)
+    {
+        return strlen(s);
+    }
+    const char* end = (const char*)memchr(s, '\0', size);
+    return end ? (size_t)(end - s) : size;
+}
+
+/** ss_hash_f adapters over ss_hash64(), drop-in for the ss_hash_mem/ss_hash_string set */
+static inline size_t ss_hash64_mem(const void* value, size_t size)
+{
+    return (size_t)ss_hash64(value, size, 0);
+}
+
+static inline size_t ss_hash64_mem_ptr(const void* value, size_t size)
+{
+    return ss_hash64_mem(*((const void**)value), size);
+}
+
+static inline size_t ss_hash64_mem_case(const void* value, size_t size)
+{
+    return (size_t)ss_hash64_case(value, size, 0);
+}
+
+static inline size_t ss_hash64_mem_case_ptr(const void* value, size_t size)
+{
+    return ss_hash64_mem_case(*((const void**)value), size);
+}
+
+/** size is an upper bound, 0 meaning NUL-terminated */
+static inline size_t ss_hash64_string(const void* value, size_t size)
+{
+    return ss_hash64_mem(value, _ss_hash_strlen((const char*)value, size));
+}
+
+static inline size_t ss_hash64_string_ptr(const void* value, size_t size)
+{
+    return ss_hash64_string(*((const char**)value), size);
+}
+
+static inline size_t ss_hash64_string_case(const void* value, size_t size)
+{
+    return ss_hash64_mem_case(value, _ss_hash_strlen((const char*)value, size));
+}
+
+static inline size_t ss_hash64_string_case_ptr(const void* value, size_t size)
+{
+    return ss_hash64_string_case(*((const char**)value), size);
+}
+
+/** ss_hash_seeded_f adapters, the unseeded ss_hash64_* above equal these with seed 0 */
+static inline size_t ss_hash64_mem_seeded(const void* value, size_t size, uint64_t seed)
+{
+    return (size_t)ss_hash64(value, size, seed);
+}
+
+static inline size_t ss_hash64_mem_ptr_seeded(const void* value, size_t size, uint64_t seed)
+{
+    return ss_hash64_mem_seeded(*((const void**)value), size, seed);
+}
+
+static inline size_t ss_hash64_mem_case_seeded(const void* value, size_t size, uint64_t seed)
+{
+    return (size_t)ss_hash64_case(value, size, seed);
+}
+
+static inline size_t ss_hash64_mem_case_ptr_seeded(const void* value, size_t size, uint64_t seed)
+{
+    return ss_hash64_mem_case_seeded(*((const void**)value), size, seed);
+}
+
+static inline size_t ss_hash64_string_seeded(const void* value, size_t size, uint64_t seed)
+{
+    return ss_hash64_mem_seeded(value, _ss_hash_strlen((const char*)value, size), seed);
+}
+
+static inline size_t ss_hash64_string_ptr_seeded(const void* value, size_t size, uint64_t seed)
+{
+    return ss_hash64_string_seeded(*((const char**)value), size, seed);
+}
+
+static inline size_t ss_hash64_string_case_seeded(const void* value, size_t size, uint64_t seed)
+{
+    return ss_hash64_mem_case_seeded(value, _ss_hash_strlen((const char*)value, size), seed);
+}
+
+static inline size_t ss_hash64_string_case_ptr_seeded(const void* value, size_t size,
+                                                      uint64_t seed)
+{
+    return ss_hash64_string_case_seeded(*((const char**)value), size, seed);
+}
+
+/**
+ * @struct ss_hasher_s
+ * @brief Incremental ss_hash64() over a key that arrives in fragments
+ *
+ * @var seed Seed passed to init, used when the key turns out to fit in one block
+ * @var seeds Lane states after the blocks consumed so far
+ * @var len Total bytes hashed so far
+ * @var used Bytes pending in buf after the 16-byte history
+ * @var fold Non-zero for the ss_hash64_case() variant
+ * @var buf Last 16 consumed bytes followed by up to 48 pending ones
+ */
+struct ss_hasher_s
+{
+    uint64_t seed;
+    uint64_t seeds[3];
+    uint64_t len;
+    size_t used;
+    int fold;
+    uint8_t buf[64];
+};
+
+/**
+ * @brief Start a hash equal to ss_hash64(), or ss_hash64_case() with init_case
+ * @param h Hasher state, no cleanup needed
+ * @param seed Hash seed
+ */
+void ss_hasher_init(ss_hasher_t* h, uint64_t seed);
+void ss_hasher_init_case(ss_hasher_t* h, uint64_t seed);
+
+/**
+ * @brief Append the next fragment, fragment boundaries do not affect the result
+ */
+void ss_hasher_update(ss_hasher_t* h, const void* data, size_t len);
+
+/**
+ * @brief Hash of everything appended so far
+ * @return ss_hash64() of the concatenated fragments
+ * @note Leaves the state untouched, more fragments may follow
+ */
+uint64_t ss_hasher_final(const ss_hasher_t* h);
+
+/**
+ * @brief One-shot ss_hasher_t over an array of slices
+ * @return ss_hash64() of the concatenated slices
+ */
+uint64_t ss_hash64_slices(const ss_slice_t* parts, size_t count, uint64_t seed);
+uint64_t ss_hash64_slices_case(const ss_slice_t* parts, size_t count, uint64_t seed);
+
+/**
+ * @brief Process-wide random seed
+ * @return Seed drawn once per process from address-space layout and clock entropy
+ * @note Not cryptographic; it only keeps keys crafted offline from colliding
+ */
+uint64_t ss_hash_process_seed(void);
+
+/**
+ * @brief Override the process seed, e.g. to reproduce a run
+ */
+void ss_hash_set_process_seed(uint64_t seed);
+
+/**
+ * @brief Fresh per-map seed derived from the process seed
+ * @return A different seed on every call
+ */
+uint64_t ss_hash_random_seed(void);
+
+/**
+ * @brief CRC32C (Castagnoli) checksum, zlib-style chaining
+ * @param crc Result of the previous call, 0 to start
+ * @param data Pointer to memory block
+ * @param len Size of memory block in bytes
+ * @return Updated CRC32C
+ *
+ * Runs on the SSE4.2 or ARMv8 crc32c instruction when ss_cpu_has() reports it,
+ * otherwise on slicing-by-8 tables. Both give identical results.
+ */
+uint32_t ss_hash_crc32c_update(uint32_t crc, const void* data, size_t len);
+
+/**
+ * @brief ss_hash_f adapter over ss_hash_crc32c_update()
+ */
+static inline size_t ss_hash_crc32c(const void* value, size_t size)
+{
+    return (size_t)ss_hash_crc32c_update(0, value, size);
+}
+
 static inline size_t ss_hash_ptr(const void* value, size_t size)
 {
     (void)size;
-    return *((unsigned long*)value);
+    return (size_t)(uintptr_t)*((void* const*)value);
+}
+
+/**
+ * @brief Mixed pointer hash, spreads aligned addresses over every bucket
+ * @param value Pointer to the pointer value
+ */
+static inline size_t ss_hash_ptr_mix(const void* value, size_t size)
+{
+    (void)size;
+    return (size_t)ss_hash_fmix64((uint64_t)(uintptr_t)*((void* const*)value));
 }
 
 #endif /* SS_HASH_H */
@@ -9,21 +9,208 @@
 
 ss_bool_t _ss_hashmap_obtree_names_iterate_cb(ss_hashmap_t* map, ss_entry_t* entry, void* param);
 
-ss_bool_t ss_hashmap_init(ss_hashmap_t* map, uint32_t bnum, ss_hash_f hash, ss_compare_f compare)
+#define _ss_hashmap_hash(map, key, ksize)                                                          \
+    ((map)->seeded_hash ? (map)->seeded_hash((key), (ksize), (map)->seed)                          \
+                        : (map)->hash((key), (ksize)))
+
+#if SS_HASHMAP_MIX_INDEX
+#define _ss_hashmap_index(map, khash) ((uint32_t)(ss_hash_fmix64(khash) % (map)->bnum))
+#else
+#define _ss_hashmap_index(map, khash) ((uint32_t)((khash) % (map)->bnum))
+#endif
+
+/* Small map mode: entries live in map->small and are found by a linear scan. Ownership
+ * follows the same borrow rules as the bucket trees. */
+
+static ss_hashmap_slot_t* _ss_hashmap_small_find(ss_hashmap_t* map, const void* key, size_t ksize,
+                                                 size_t khash)
 {
-    // map->buckets = (ss_hashmap_bucket**)calloc(bnum , sizeof(ss_hashmap_bucket*));
-    int size = bnum * sizeof(ss_hashmap_bucket*);
-    void* buckets = ss_malloc(size);
+    size_t i;
+    for (i = 0; i < map->size; i++)
+    {
+        ss_hashmap_slot_t* slot = &map->small[i];
+        if (slot->khash == khash &&
+            map->compare(key, ksize, slot->entry.key, slot->entry.ksize) == 0)
+        {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+static void _ss_hashmap_small_release(ss_hashmap_t* map, ss_entry_t* entry)
+{
+    if (entry->value)
+    {
+        if (!(map->borrow & SS_BORROW_VALUE))
+        {
+            ss_free(entry->value);
+        }
+        else if (map->val_free)
+        {
+            map->val_free(entry->value);
+        }
+    }
+    if (!(map->borrow & SS_BORROW_KEY))
+    {
+        ss_free(entry->key);
+    }
+    else if (map->key_free)
+    {
+        map->key_free(entry->key);
+    }
+}
+
+static ss_bool_t _ss_hashmap_small_set_value(ss_hashmap_t* map, ss_entry_t* entry,
+                                             const void* value, size_t vsize)
+{
+    if (map->borrow & SS_BORROW_VALUE)
+    {
+        if (entry->value && entry->value != value && map->val_free)
+        {
+            map->val_free(entry->value);
+        }
+        entry->value = (void*)value;
+        entry->vsize = value ? vsize : 0;
+        return SS_TRUE;
+    }
+    if (!value || vsize == 0)
+    {
+        if (entry->value)
+        {
+            ss_free(entry->value);
+        }
+        entry->value = NULL;
+        entry->vsize = 0;
+        return SS_TRUE;
+    }
+    if (!entry->value || entry->vsize < vsize)
+    {
+        void* ptr = ss_malloc(vsize);
+        if (!ptr)
+        {
+            return SS_FALSE;
+        }
+        if (entry->value)
+        {
+            ss_free(entry->value);
+        }
+        entry->value = ptr;
+    }
+    memcpy(entry->value, value, vsize);
+    entry->vsize = vsize;
+    return SS_TRUE;
+}
+
+static void _ss_hashmap_small_put(ss_hashmap_t* map, ss_hashmap_slot_t* slot, const void* key,
+                                  size_t ksize, size_t khash, const void* value, size_t vsize)
+{
+    if (map->borrow & SS_BORROW_KEY)
+    {
+        slot->entry.key = (void*)key;
+    }
+    else
+    {
+        slot->entry.key = ss_malloc(ksize);
+        if (!slot->entry.key)
+        {
+            return;
+        }
+        memcpy(slot->entry.key, key, ksize);
+    }
+    slot->entry.ksize = ksize;
+    slot->entry.value = NULL;
+    slot->entry.vsize = 0;
+    slot->khash = khash;
+    if (!_ss_hashmap_small_set_value(map, &slot->entry, value, vsize))
+    {
+        if (!(map->borrow & SS_BORROW_KEY))
+        {
+            ss_free(slot->entry.key);
+        }
+        return;
+    }
+    map->size++;
+}
+
+static ss_hashmap_bucket* _ss_hashmap_bucket_new(ss_hashmap_t* map)
+{
+    ss_hashmap_bucket* bucket = (ss_hashmap_bucket*)ss_malloc(sizeof(ss_hashmap_bucket));
+    if (bucket)
+    {
+        ss_obtree_init(bucket, map->hash, map->compare, NULL);
+        ss_obtree_set_borrow(bucket, map->borrow, map->key_free, map->val_free);
+    }
+    return bucket;
+}
+
+// Move the inline entries into freshly allocated buckets without copying keys or values
+static ss_bool_t _ss_hashmap_promote(ss_hashmap_t* map)
+{
+    size_t i;
+    size_t size = map->bnum * sizeof(ss_hashmap_bucket*);
+    ss_hashmap_bucket** buckets = (ss_hashmap_bucket**)ss_malloc(size);
     if (!buckets)
     {
         return SS_FALSE;
     }
     memset(buckets, 0, size);
-    map->buckets = (ss_hashmap_bucket**)buckets;
-    map->bnum = bnum;
+    for (i = 0; i < map->size; i++)
+    {
+        ss_hashmap_slot_t* slot = &map->small[i];
+        uint32_t bidx = _ss_hashmap_index(map, slot->khash);
+        if (!buckets[bidx])
+        {
+            buckets[bidx] = _ss_hashmap_bucket_new(map);
+            if (!buckets[bidx])
+            {
+                break;
+            }
+        }
+        // The tree adopts the already owned pointers, then resumes the map's ownership rules
+        ss_hashmap_bucket* bucket = buckets[bidx];
+        ss_obtree_set_borrow(bucket, SS_BORROW_KEY | SS_BORROW_VALUE, NULL, NULL);
+        ss_obtree_node_t* node = ss_obtree_set2(bucket, slot->entry.key, slot->entry.ksize,
+                                                slot->khash, slot->entry.value, slot->entry.vsize);
+        ss_obtree_set_borrow(bucket, map->borrow, map->key_free, map->val_free);
+        if (!node)
+        {
+            break;
+        }
+    }
+    if (i < map->size)
+    {
+        // Allocation failure: hand the adopted pointers back and stay small
+        uint32_t b;
+        for (b = 0; b < map->bnum; b++)
+        {
+            if (buckets[b])
+            {
+                ss_obtree_set_borrow(buckets[b], SS_BORROW_KEY | SS_BORROW_VALUE, NULL, NULL);
+                ss_obtree_destroy(buckets[b]);
+                ss_free(buckets[b]);
+            }
+        }
+        ss_free(buckets);
+        return SS_FALSE;
+    }
+    map->buckets = buckets;
+    return SS_TRUE;
+}
+
+ss_bool_t ss_hashmap_init(ss_hashmap_t* map, uint32_t bnum, ss_hash_f hash, ss_compare_f compare)
+{
+    // Buckets are allocated once the map outgrows its inline entries
+    map->buckets = NULL;
+    map->bnum = bnum ? bnum : SS_DEFAULT_HASHMAP_BUCKETS;
     map->size = 0;
     map->hash = hash;
     map->compare = compare;
+    map->seeded_hash = NULL;
+    map->seed = 0;
+    map->borrow = 0;
+    map->key_free = NULL;
+    map->val_free = NULL;
 
     return SS_TRUE;
 }
@@ -31,6 +218,11 @@ ss_bool_t ss_hashmap_init(ss_hashmap_t* map, uint32_t bnum, ss_hash_f hash, ss_c
 void ss_hashmap_destroy(ss_hashmap_t* map)
 {
     uint32_t i;
+    if (!map->buckets)
+    {
+        ss_hashmap_clear(map);
+        return;
+    }
     for (i = 0; i < map->bnum; i++)
     {
         ss_hashmap_bucket* bucket = map->buckets[i];
@@ -42,6 +234,7 @@ void ss_hashmap_destroy(ss_hashmap_t* map)
         }
     }
     ss_free(map->buckets);
+    map->buckets = NULL;
 }
 
 ss_hashmap_t* ss_hashmap_create(uint32_t bnum, ss_hash_f hash, ss_compare_f compare)
@@ -65,11 +258,61 @@ void ss_hashmap_free(ss_hashmap_t* map)
     ss_free(map);
 }
 
+void ss_hashmap_set_borrow(ss_hashmap_t* map, unsigned int borrow, ss_free_f key_free,
+                           ss_free_f val_free)
+{
+    uint32_t i;
+    map->borrow = borrow;
+    map->key_free = key_free;
+    map->val_free = val_free;
+    // Buckets survive ss_hashmap_clear(), keep them in sync
+    for (i = 0; map->buckets && i < map->bnum; i++)
+    {
+        if (map->buckets[i])
+        {
+            ss_obtree_set_borrow(map->buckets[i], borrow, key_free, val_free);
+        }
+    }
+}
+
+void ss_hashmap_set_seed(ss_hashmap_t* map, ss_hash_seeded_f hash, uint64_t seed)
+{
+    map->seeded_hash = hash;
+    map->seed = seed;
+}
+
 void ss_hashmap_put(ss_hashmap_t* map, const void* key, size_t ksize, const void* value,
                     size_t vsize)
 {
-    size_t khash = map->hash(key, ksize);
-    uint32_t bidx = khash % map->bnum;
+    size_t khash = _ss_hashmap_hash(map, key, ksize);
+    if (!map->buckets)
+    {
+        ss_hashmap_slot_t* slot = _ss_hashmap_small_find(map, key, ksize, khash);
+        if (slot)
+        {
+            if (map->borrow & SS_BORROW_KEY && slot->entry.key != key)
+            {
+                if (map->key_free)
+                {
+                    map->key_free(slot->entry.key);
+                }
+                slot->entry.key = (void*)key;
+                slot->entry.ksize = ksize;
+            }
+            _ss_hashmap_small_set_value(map, &slot->entry, value, vsize);
+            return;
+        }
+        if (map->size < SS_HASHMAP_SMALL_SIZE)
+        {
+            _ss_hashmap_small_put(map, &map->small[map->size], key, ksize, khash, value, vsize);
+            return;
+        }
+        if (!_ss_hashmap_promote(map))
+        {
+            return;
+        }
+    }
+    uint32_t bidx = _ss_hashmap_index(map, khash);
     ss_hashmap_bucket* bucket = map->buckets[bidx];
     if (bucket)
     {
@@ -82,8 +325,11 @@ void ss_hashmap_put(ss_hashmap_t* map, const void* key, size_t ksize, const void
     }
     else
     {
-        bucket = (ss_hashmap_bucket*)ss_malloc(sizeof(ss_hashmap_bucket));
-        ss_obtree_init(bucket, map->hash, map->compare, NULL);
+        bucket = _ss_hashmap_bucket_new(map);
+        if (!bucket)
+        {
+            return;
+        }
         ss_obtree_set2(bucket, key, ksize, khash, value, vsize);
         map->size++;
         map->buckets[bidx] = bucket;
@@ -92,8 +338,21 @@ void ss_hashmap_put(ss_hashmap_t* map, const void* key, size_t ksize, const void
 
 void* ss_hashmap_get(ss_hashmap_t* map, const void* key, size_t ksize, size_t* vsize)
 {
-    size_t khash = map->hash(key, ksize);
-    uint32_t bidx = khash % map->bnum;
+    size_t khash = _ss_hashmap_hash(map, key, ksize);
+    if (!map->buckets)
+    {
+        ss_hashmap_slot_t* slot = _ss_hashmap_small_find(map, key, ksize, khash);
+        if (!slot)
+        {
+            return NULL;
+        }
+        if (vsize)
+        {
+            *vsize = slot->entry.vsize;
+        }
+        return slot->entry.value;
+    }
+    uint32_t bidx = _ss_hashmap_index(map, khash);
     ss_hashmap_bucket* bucket = map->buckets[bidx];
     if (bucket && bucket->root)
     {
@@ -112,8 +371,20 @@ void* ss_hashmap_get(ss_hashmap_t* map, const void* key, size_t ksize, size_t* v
 
 ss_bool_t ss_hashmap_remove(ss_hashmap_t* map, const void* key, size_t ksize)
 {
-    size_t khash = map->hash(key, ksize);
-    uint32_t bidx = khash % map->bnum;
+    size_t khash = _ss_hashmap_hash(map, key, ksize);
+    if (!map->buckets)
+    {
+        ss_hashmap_slot_t* slot = _ss_hashmap_small_find(map, key, ksize, khash);
+        if (!slot)
+        {
+            return SS_FALSE;
+        }
+        _ss_hashmap_small_release(map, &slot->entry);
+        // Keep the inline entries dense by moving the last one into the hole
+        *slot = map->small[--map->size];
+        return SS_TRUE;
+    }
+    uint32_t bidx = _ss_hashmap_index(map, khash);
     ss_hashmap_bucket* bucket = map->buckets[bidx];
     if (bucket)
     {
@@ -143,30 +414,27 @@ ss_bool_t _ss_hashmap_obtree_names_iterate_cb(ss_hashmap_t* map, ss_entry_t* ent
     return SS_FALSE;
 }
 
-ss_bool_t _ss_hashmap_bucket_iterate(ss_hashmap_t* map, ss_obtree_t* t, ss_obtree_node_t* node,
-                                     ss_hashmap_iterate_cb_f it, void* param)
+ss_bool_t ss_hashmap_iterate(ss_hashmap_t* map, ss_hashmap_iterate_cb_f it, void* param)
 {
-    if (node)
+    uint32_t i;
+    if (!map->buckets)
     {
-        if (it(map, &node->entry, param))
+        for (i = 0; i < map->size; i++)
         {
-            return SS_TRUE;
+            if (it(map, &map->small[i].entry, param))
+            {
+                return SS_TRUE;
+            }
         }
-        _ss_hashmap_bucket_iterate(map, t, node->left, it, param);
-        _ss_hashmap_bucket_iterate(map, t, node->right, it, param);
+        return SS_FALSE;
     }
-    return SS_FALSE;
-}
-
-ss_bool_t ss_hashmap_iterate(ss_hashmap_t* map, ss_hashmap_iterate_cb_f it, void* param)
-{
-    uint32_t i;
     for (i = 0; i < map->bnum; i++)
     {
         ss_hashmap_bucket* bucket = map->buckets[i];
-        if (bucket && bucket->root)
+        ss_obtree_node_t* node = bucket ? ss_obtree_first(bucket) : NULL;
+        for (; node; node = ss_obtree_next(node))
         {
-            if (_ss_hashmap_bucket_iterate(map, bucket, bucket->root, it, param))
+            if (it(map, &node->entry, param))
             {
                 return SS_TRUE;
             }
@@ -178,6 +446,15 @@ ss_bool_t ss_hashmap_iterate(ss_hashmap_t* map, ss_hashmap_iterate_cb_f it, void
 void ss_hashmap_clear(ss_hashmap_t* map)
 {
     uint32_t i;
+    if (!map->buckets)
+    {
+        for (i = 0; i < map->size; i++)
+        {
+            _ss_hashmap_small_release(map, &map->small[i].entry);
+        }
+        map->size = 0;
+        return;
+    }
     for (i = 0; i < map->bnum; i++)
     {
         ss_hashmap_bucket* bucket = map->buckets[i];
@@ -188,3 +465,61 @@ void ss_hashmap_clear(ss_hashmap_t* map)
     }
     map->size = 0;
 }
+
+void ss_hashmap_stats(ss_hashmap_t* map, ss_hashmap_stats_t* stats)
+{
+    uint32_t i;
+    memset(stats, 0, sizeof(ss_hashmap_stats_t));
+    stats->size = map->size;
+    stats->bnum = map->bnum;
+    if (!map->buckets)
+    {
+        stats->small = SS_TRUE;
+        stats->load_factor = (double)map->size / SS_HASHMAP_SMALL_SIZE;
+        stats->mean_depth = map->size ? (double)(map->size + 1) / 2 : 0.0;
+        stats->bytes = sizeof(ss_hashmap_t);
+        for (i = 0; i < map->size; i++)
+        {
+            if (!(map->borrow & SS_BORROW_KEY))
+            {
+                stats->bytes += map->small[i].entry.ksize;
+            }
+            if (!(map->borrow & SS_BORROW_VALUE))
+            {
+                stats->bytes += map->small[i].entry.vsize;
+            }
+        }
+        return;
+    }
+    stats->load_factor = map->bnum ? (double)map->size / map->bnum : 0.0;
+    stats->bytes = sizeof(ss_hashmap_t) + map->bnum * sizeof(ss_hashmap_bucket*);
+    for (i = 0; i < map->bnum; i++)
+    {
+        ss_hashmap_bucket* bucket = map->buckets[i];
+        if (!bucket)
+        {
+            continue;
+        }
+        ss_obtree_stats_t bstats;
+        ss_obtree_stats(bucket, &bstats);
+        // Emptied buckets keep their tree allocated
+        stats->bytes += bstats.bytes;
+        if (bstats.size == 0)
+        {
+            continue;
+        }
+        stats->used_buckets++;
+        stats->max_height = SS_MAX(stats->max_height, bstats.height);
+        stats->mean_height += (double)bstats.height;
+        stats->mean_depth += bstats.mean_depth * (double)bstats.size;
+        stats->height_histogram[SS_MIN(bstats.height, SS_HASHMAP_HEIGHT_HISTOGRAM_SIZE - 1)]++;
+    }
+    if (stats->used_buckets > 0)
+    {
+        stats->mean_height /= (double)stats->used_buckets;
+    }
+    if (stats->size > 0)
+    {
+        stats->mean_depth /= (double)stats->size;
+    }
+}
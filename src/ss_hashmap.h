@@ -6,6 +6,7 @@
  *
  * Supports custom hash functions and key comparison. Features include:
  * - Automatic resizing based on load factor
+ * - Inline linear storage for small maps, promoted to buckets past SS_HASHMAP_SMALL_SIZE
  * - Separate chaining collision resolution
  * - Key-value pair storage with arbitrary data types
  * - O(1) average case for basic operations
@@ -24,15 +25,42 @@
 
 typedef ss_obtree_t ss_hashmap_bucket;
 
+/* Bucket index is ss_hash_fmix64(khash) % bnum, so identity integer and pointer hashes still
+ * spread; define as 0 when every key hash is already well mixed */
+#ifndef SS_HASHMAP_MIX_INDEX
+#define SS_HASHMAP_MIX_INDEX 1
+#endif
+
+/* Entries held inline before the bucket array is allocated */
+#define SS_HASHMAP_SMALL_SIZE 8
+
+/**
+ * @struct ss_hashmap_slot_s
+ * @brief Inline entry used while the map is small
+ *
+ * @var entry Key-value pair
+ * @var khash Cached key hash, checked before calling compare
+ */
+typedef struct ss_hashmap_slot_s
+{
+    ss_entry_t entry;
+    size_t khash;
+} ss_hashmap_slot_t;
+
 /**
  * @struct ss_hashmap_s
  * @brief Main hash table container structure
  *
- * @var buckets Array of bucket pointers (separate chaining)
+ * @var buckets Array of bucket pointers (separate chaining), NULL while the map is small
  * @var size Total number of stored key-value pairs
- * @var bnum Current bucket count (capacity)
+ * @var bnum Current bucket count (capacity), allocated on promotion
  * @var hash Function pointer for key hashing
  * @var compare Function pointer for key comparison
+ * @var seeded_hash Seeded key hash, used instead of hash when set
+ * @var seed Seed passed to seeded_hash
+ * @var borrow SS_BORROW_KEY / SS_BORROW_VALUE ownership flags
+ * @var key_free Destructor for borrowed keys (may be NULL)
+ * @var val_free Destructor for borrowed values (may be NULL)
  */
 struct ss_hashmap_s
 {
@@ -42,6 +70,48 @@ struct ss_hashmap_s
 
     ss_hash_f hash;       ///< Function pointer for key hashing
     ss_compare_f compare; ///< Function pointer for key comparison
+
+    ss_hash_seeded_f seeded_hash; ///< Seeded key hash, overrides hash when set
+    uint64_t seed;                ///< Seed passed to seeded_hash
+
+    unsigned int borrow; ///< Ownership flags passed to bucket trees
+    ss_free_f key_free;  ///< Destructor for borrowed keys
+    ss_free_f val_free;  ///< Destructor for borrowed values
+
+    ss_hashmap_slot_t small[SS_HASHMAP_SMALL_SIZE]; ///< Inline entries while buckets is NULL
+};
+
+/* Number of bucket height histogram bins, the last bin also counts everything taller */
+#define SS_HASHMAP_HEIGHT_HISTOGRAM_SIZE 16
+
+/**
+ * @struct ss_hashmap_stats_s
+ * @brief Hash table shape statistics
+ *
+ * @var size Number of stored key-value pairs
+ * @var bnum Bucket count
+ * @var used_buckets Buckets holding at least one entry
+ * @var small SS_TRUE while entries are stored inline (no buckets allocated)
+ * @var max_height Tallest bucket tree
+ * @var mean_height Mean tree height over used buckets
+ * @var mean_depth Mean node depth, i.e. comparisons per successful lookup; for small maps
+ *      the mean scan length
+ * @var height_histogram Used bucket count per tree height, index 0 is unused
+ * @var load_factor size / bnum (size / SS_HASHMAP_SMALL_SIZE for small maps)
+ * @var bytes Map structure, bucket array, bucket trees, nodes, owned keys and owned values
+ */
+struct ss_hashmap_stats_s
+{
+    size_t size;
+    uint32_t bnum;
+    ss_bool_t small;
+    uint32_t used_buckets;
+    size_t max_height;
+    double mean_height;
+    double mean_depth;
+    size_t height_histogram[SS_HASHMAP_HEIGHT_HISTOGRAM_SIZE];
+    double load_factor;
+    size_t bytes;
 };
 
 /* If returns true, iteration will stop */
@@ -50,7 +120,7 @@ typedef ss_bool_t (*ss_hashmap_iterate_cb_f)(ss_hashmap_t* map, ss_entry_t* entr
 /**
  * @brief Initialize hashmap with specified parameters
  * @param[in] map Pointer to hashmap structure
- * @param[in] bnum Initial number of buckets
+ * @param[in] bnum Number of buckets allocated once the map outgrows its inline entries
  * @param[in] hash Hash function for keys
  * @param[in] compare Key comparison function
  * @return SS_TRUE if initialization succeeded
@@ -69,6 +139,28 @@ void ss_hashmap_destroy(ss_hashmap_t* map);
 ss_hashmap_t* ss_hashmap_create(uint32_t bnum, ss_hash_f hash, ss_compare_f compare);
 void ss_hashmap_free(ss_hashmap_t* map);
 
+/**
+ * @brief Store caller-owned key and/or value pointers verbatim instead of copies
+ * @param[in] map Hashmap pointer, must be empty
+ * @param[in] borrow Combination of SS_BORROW_KEY and SS_BORROW_VALUE
+ * @param[in] key_free Destructor for borrowed keys on remove/clear/replace (may be NULL)
+ * @param[in] val_free Destructor for borrowed values on remove/clear/replace (may be NULL)
+ * @note With SS_BORROW_VALUE, ss_hashmap_get() returns the stored pointer itself and
+ *       ss_hashmap_put() costs one node allocation and no value copy
+ * @see ss_obtree_set_borrow()
+ */
+void ss_hashmap_set_borrow(ss_hashmap_t* map, unsigned int borrow, ss_free_f key_free,
+                           ss_free_f val_free);
+
+/**
+ * @brief Hash keys with a seeded function instead of the hash given at init
+ * @param[in] map Hashmap pointer, must be empty
+ * @param[in] hash Seeded hash function (NULL restores the unseeded hash)
+ * @param[in] seed Map seed, e.g. ss_hash_random_seed() or ss_hash_process_seed()
+ * @note A random seed keeps crafted keys from piling into one bucket
+ */
+void ss_hashmap_set_seed(ss_hashmap_t* map, ss_hash_seeded_f hash, uint64_t seed);
+
 /**
  * @brief Insert or update key-value pair
  * @param[in] map Hashmap pointer
@@ -101,6 +193,14 @@ ss_bool_t ss_hashmap_iterate(ss_hashmap_t* map, ss_hashmap_iterate_cb_f cb, void
 
 void ss_hashmap_clear(ss_hashmap_t* map);
 
+/**
+ * @brief Collect hash table shape statistics
+ * @param[in] map Hashmap pointer
+ * @param[out] stats Receives the statistics
+ * @note O(n); intended for periodic diagnostics, e.g. spotting poor hash dispersion
+ */
+void ss_hashmap_stats(ss_hashmap_t* map, ss_hashmap_stats_t* stats);
+
 #define ss_hashmap_size(map) ((map)->size)
 
 #endif /* SS_HASHMAP_H */
@@ -0,0 +1,323 @@
+#include "ss_alloc.h"
+#include "ss_atomic.h"
+#include "ss_hash.h"
+#include "ss_intern.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Initial index slot count, always a power of two
+#define _SS_INTERN_TABLE_CAPACITY 64
+// Resize once size exceeds 3/4 of the index capacity
+#define _ss_intern_full(index, n) ((n) * 4 > (index)->capacity * 3)
+
+#define _ss_intern_home(index, hash) ((hash) & ((index)->capacity - 1))
+
+#define _ss_intern_match(e, str, len, hash)                                                        \
+    ((e)->hash == (hash) && (e)->len == (len) && memcmp((e)->str, (str), (len)) == 0)
+
+static inline unsigned int _ss_intern_msb(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - (unsigned int)__builtin_clzll(x);
+#else
+    unsigned int n = 0;
+    while (x >>= 1)
+    {
+        n++;
+    }
+    return n;
+#endif
+}
+
+// Chunk k covers ids [(64 << k) - 64, (128 << k) - 64)
+static inline ss_intern_entry_t* _ss_intern_slot(const ss_intern_t* t, uint32_t id)
+{
+    uint64_t idx = (uint64_t)id + (1ULL << SS_INTERN_CHUNK_BITS);
+    unsigned int k = _ss_intern_msb(idx) - SS_INTERN_CHUNK_BITS;
+    return &t->chunks[k][idx - (1ULL << (k + SS_INTERN_CHUNK_BITS))];
+}
+
+// Build a larger index and publish it; the old one stays linked for readers still probing it
+static ss_bool_t _ss_intern_rehash(ss_intern_t* t, size_t capacity)
+{
+    ss_intern_index_t* index =
+        (ss_intern_index_t*)ss_malloc(sizeof(ss_intern_index_t) + capacity * sizeof(uint32_t));
+    if (!index)
+    {
+        return SS_FALSE;
+    }
+    memset(index->slots, 0, capacity * sizeof(uint32_t));
+    index->next = t->table;
+    index->capacity = capacity;
+
+    size_t mask = capacity - 1;
+    uint32_t id;
+    for (id = 0; id < t->size; id++)
+    {
+        size_t i = _ss_intern_home(index, _ss_intern_slot(t, id)->hash);
+        while (index->slots[i])
+        {
+            i = (i + 1) & mask;
+        }
+        index->slots[i] = id + 1;
+    }
+    ss_atomic_store(&t->table, index);
+    return SS_TRUE;
+}
+
+// Writer side: index slot holding str, or the empty slot where it belongs
+static uint32_t* _ss_intern_lookup(const ss_intern_t* t, const char* str, size_t len, size_t hash)
+{
+    ss_intern_index_t* index = t->table;
+    size_t mask = index->capacity - 1;
+    size_t i = _ss_intern_home(index, hash);
+    while (index->slots[i])
+    {
+        const ss_intern_entry_t* e = _ss_intern_slot(t, index->slots[i] - 1);
+        if (_ss_intern_match(e, str, len, hash))
+        {
+            break;
+        }
+        i = (i + 1) & mask;
+    }
+    return &index->slots[i];
+}
+
+// Reader side: a slot's acquire load makes the entry and string it names visible, and a
+// stale index still holds every string it had, so a miss here is only a miss at that moment
+static const char* _ss_intern_probe(const ss_intern_t* t, const char* str, size_t len,
+                                    size_t hash, uint32_t* id)
+{
+    const ss_intern_index_t* index = ss_atomic_load(&t->table);
+    if (!index)
+    {
+        return NULL;
+    }
+    size_t mask = index->capacity - 1;
+    size_t i = _ss_intern_home(index, hash);
+    uint32_t slot;
+    while ((slot = ss_atomic_load(&index->slots[i])) != 0)
+    {
+        const ss_intern_entry_t* e = _ss_intern_slot(t, slot - 1);
+        if (_ss_intern_match(e, str, len, hash))
+        {
+            if (id)
+            {
+                *id = slot - 1;
+            }
+            return e->str;
+        }
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+static char* _ss_intern_page_alloc(ss_intern_t* t, size_t n)
+{
+    ss_intern_page_t* page = t->pages;
+    if (page && page->size - page->used >= n)
+    {
+        char* p = page->data + page->used;
+        page->used += n;
+        return p;
+    }
+    size_t size = n > SS_INTERN_PAGE_SIZE ? n : SS_INTERN_PAGE_SIZE;
+    page = (ss_intern_page_t*)ss_malloc(sizeof(ss_intern_page_t) + size);
+    if (!page)
+    {
+        return NULL;
+    }
+    page->size = size;
+    page->used = n;
+    if (n > SS_INTERN_PAGE_SIZE && t->pages)
+    {
+        // Oversized string gets a dedicated page, keep filling the current one
+        page->next = t->pages->next;
+        t->pages->next = page;
+    }
+    else
+    {
+        page->next = t->pages;
+        t->pages = page;
+    }
+    return page->data;
+}
+
+ss_bool_t ss_intern_init(ss_intern_t* t)
+{
+    memset(t, 0, sizeof(ss_intern_t));
+    return SS_TRUE;
+}
+
+void ss_intern_destroy(ss_intern_t* t)
+{
+    unsigned int k;
+    for (k = 0; k < SS_INTERN_MAX_CHUNKS; k++)
+    {
+        ss_free(t->chunks[k]);
+        t->chunks[k] = NULL;
+    }
+    while (t->pages)
+    {
+        ss_intern_page_t* next = t->pages->next;
+        ss_free(t->pages);
+        t->pages = next;
+    }
+    while (t->table)
+    {
+        ss_intern_index_t* next = t->table->next;
+        ss_free(t->table);
+        t->table = next;
+    }
+    t->size = 0;
+    t->bytes = 0;
+}
+
+ss_intern_t* ss_intern_create(void)
+{
+    ss_intern_t* t = (ss_intern_t*)ss_malloc(sizeof(ss_intern_t));
+    if (!t)
+    {
+        return NULL;
+    }
+    if (!ss_intern_init(t))
+    {
+        ss_free(t);
+        return NULL;
+    }
+    return t;
+}
+
+void ss_intern_free(ss_intern_t* t)
+{
+    ss_intern_destroy(t);
+    ss_free(t);
+}
+
+void ss_intern_set_lock(ss_intern_t* t, ss_intern_lock_f lock, ss_intern_lock_f unlock,
+                        void* param)
+{
+    t->lock = lock;
+    t->unlock = unlock;
+    t->lock_param = param;
+}
+
+const char* ss_intern_find(ss_intern_t* t, const char* str, size_t len, uint32_t* id)
+{
+    if (!len)
+    {
+        len = strlen(str);
+    }
+    return _ss_intern_probe(t, str, len, ss_hash64_mem(str, len), id);
+}
+
+static const char* _ss_intern_insert(ss_intern_t* t, const char* str, size_t len, size_t hash,
+                                     uint32_t* id)
+{
+    uint32_t* slot = NULL;
+    if (t->table)
+    {
+        slot = _ss_intern_lookup(t, str, len, hash);
+        if (*slot)
+        {
+            if (id)
+            {
+                *id = *slot - 1;
+            }
+            return _ss_intern_slot(t, *slot - 1)->str;
+        }
+    }
+
+    // id + 1 must fit the index slot
+    if (t->size == UINT32_MAX)
+    {
+        return NULL;
+    }
+    uint32_t new_id = t->size;
+    uint64_t idx = (uint64_t)new_id + (1ULL << SS_INTERN_CHUNK_BITS);
+    unsigned int k = _ss_intern_msb(idx) - SS_INTERN_CHUNK_BITS;
+    if (!t->chunks[k])
+    {
+        t->chunks[k] = (ss_intern_entry_t*)ss_malloc(
+            sizeof(ss_intern_entry_t) << (k + SS_INTERN_CHUNK_BITS));
+        if (!t->chunks[k])
+        {
+            return NULL;
+        }
+    }
+    if (!t->table || _ss_intern_full(t->table, (size_t)t->size + 1))
+    {
+        if (!_ss_intern_rehash(t, t->table ? t->table->capacity << 1 : _SS_INTERN_TABLE_CAPACITY))
+        {
+            return NULL;
+        }
+        slot = _ss_intern_lookup(t, str, len, hash);
+    }
+    char* copy = _ss_intern_page_alloc(t, len + 1);
+    if (!copy)
+    {
+        return NULL;
+    }
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+
+    ss_intern_entry_t* e = _ss_intern_slot(t, new_id);
+    e->str = copy;
+    e->len = len;
+    e->hash = hash;
+    // Publish the entry to lock-free readers through its index slot and the size
+    ss_atomic_store(slot, new_id + 1);
+    ss_atomic_store(&t->size, new_id + 1);
+    t->bytes += len + 1;
+    if (id)
+    {
+        *id = new_id;
+    }
+    return copy;
+}
+
+const char* ss_intern(ss_intern_t* t, const char* str, size_t len, uint32_t* id)
+{
+    if (!len)
+    {
+        len = strlen(str);
+    }
+    return _ss_intern_insert(t, str, len, ss_hash64_mem(str, len), id);
+}
+
+const char* ss_intern_sync(ss_intern_t* t, const char* str, size_t len, uint32_t* id)
+{
+    if (!len)
+    {
+        len = strlen(str);
+    }
+    size_t hash = ss_hash64_mem(str, len);
+    // Hits never take the lock, the locked insert re-checks for a racing insert of str
+    const char* s = _ss_intern_probe(t, str, len, hash, id);
+    if (s)
+    {
+        return s;
+    }
+    if (t->lock)
+    {
+        t->lock(t->lock_param);
+    }
+    s = _ss_intern_insert(t, str, len, hash, id);
+    if (t->unlock)
+    {
+        t->unlock(t->lock_param);
+    }
+    return s;
+}
+
+const ss_intern_entry_t* ss_intern_entry(const ss_intern_t* t, uint32_t id)
+{
+    // The acquire load makes the entry stored before size was raised visible
+    if (id >= ss_atomic_load(&t->size))
+    {
+        return NULL;
+    }
+    return _ss_intern_slot(t, id);
+}
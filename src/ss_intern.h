@@ -0,0 +1,170 @@
+/**
+ * @file ss_intern.h
+ * @brief String interning table with dense integer ids
+ * @author trywen@qq.com
+ * @date 2026-10-18
+ *
+ * Stores each distinct string once and hands out a dense uint32_t id plus a stable
+ * const char*. Features include:
+ * - Strings packed into arena pages that never move or shrink
+ * - O(1) id to string lookup through fixed, geometrically sized entry chunks
+ * - Lock-free lookups and id resolution alongside one locked writer
+ *
+ * Concurrent use: every thread that may add strings goes through ss_intern_sync(), which
+ * serves hits without the lock and takes it only to insert. ss_intern_find(),
+ * ss_intern_entry() and ss_intern_str() take no lock at all. Entries and index slots are
+ * published with release stores and read with acquire loads; entry chunks never move and
+ * replaced index tables are kept until ss_intern_destroy(), so a reader never touches
+ * freed memory. Keeping old tables costs at most one more current index in total.
+ * ss_intern() itself does not lock and must not run concurrently with any other call.
+ */
+
+#ifndef SS_INTERN_H
+#define SS_INTERN_H
+
+#include "ss_types.h"
+
+/* Default arena page size in bytes, longer strings get a dedicated page */
+#define SS_INTERN_PAGE_SIZE 4096
+/* The first entry chunk holds 1 << SS_INTERN_CHUNK_BITS entries, each next one doubles */
+#define SS_INTERN_CHUNK_BITS 6
+/* Enough chunks to address every uint32_t id */
+#define SS_INTERN_MAX_CHUNKS (33 - SS_INTERN_CHUNK_BITS)
+
+/**
+ * @struct ss_intern_entry_s
+ * @brief Interned string descriptor
+ */
+typedef struct ss_intern_entry_s
+{
+    const char* str;
+    size_t len;
+    size_t hash;
+} ss_intern_entry_t;
+
+/**
+ * @struct ss_intern_page_s
+ * @brief Arena page holding NUL-terminated interned strings
+ */
+typedef struct ss_intern_page_s
+{
+    struct ss_intern_page_s* next;
+    size_t size;
+    size_t used;
+    char data[];
+} ss_intern_page_t;
+
+/**
+ * @struct ss_intern_index_s
+ * @brief Open-addressed string index holding id + 1, 0 marks an empty slot
+ *
+ * @var next Index this one replaced, kept for lock-free readers still probing it
+ * @var capacity Slot count (power of two)
+ */
+typedef struct ss_intern_index_s
+{
+    struct ss_intern_index_s* next;
+    size_t capacity;
+    uint32_t slots[];
+} ss_intern_index_t;
+
+/**
+ * @brief Lock hook used by ss_intern_sync()
+ * @param param User data given to ss_intern_set_lock()
+ */
+typedef void (*ss_intern_lock_f)(void* param);
+
+/**
+ * @struct ss_intern_s
+ * @brief Interning table container structure
+ *
+ * @var chunks Id to entry storage, chunk k holds 64 << k entries
+ * @var size Number of interned strings (next id)
+ * @var table Current string index, NULL until the first insert
+ * @var pages Arena pages, newest first
+ * @var bytes Bytes used by string data, including terminators
+ */
+struct ss_intern_s
+{
+    ss_intern_entry_t* chunks[SS_INTERN_MAX_CHUNKS];
+    uint32_t size;
+
+    ss_intern_index_t* table;
+
+    ss_intern_page_t* pages;
+    size_t bytes;
+
+    ss_intern_lock_f lock;
+    ss_intern_lock_f unlock;
+    void* lock_param;
+};
+
+/**
+ * @brief Initialize interning table
+ * @return SS_TRUE if initialization succeeded
+ */
+ss_bool_t ss_intern_init(ss_intern_t* t);
+void ss_intern_destroy(ss_intern_t* t);
+
+/**
+ * @brief Create new interning table
+ * @note Caller must free with ss_intern_free()
+ */
+ss_intern_t* ss_intern_create(void);
+void ss_intern_free(ss_intern_t* t);
+
+/**
+ * @brief Set lock hooks taken by ss_intern_sync()
+ * @param[in] lock Acquire callback (NULL to disable locking)
+ * @param[in] unlock Release callback
+ * @param[in] param User data passed to both callbacks, e.g. a mutex
+ */
+void ss_intern_set_lock(ss_intern_t* t, ss_intern_lock_f lock, ss_intern_lock_f unlock,
+                        void* param);
+
+/**
+ * @brief Intern a string
+ * @param[in] t Table pointer
+ * @param[in] str String data
+ * @param[in] len Length in bytes, 0 means NUL-terminated
+ * @param[out] id Receives the string's id (may be NULL)
+ * @return Stable NUL-terminated copy, valid until the table is destroyed; NULL on
+ *         allocation failure
+ */
+const char* ss_intern(ss_intern_t* t, const char* str, size_t len, uint32_t* id);
+
+/**
+ * @brief ss_intern() safe against concurrent callers and lock-free readers
+ *
+ * Strings already interned are found without the lock; only a miss takes the lock set by
+ * ss_intern_set_lock() and inserts.
+ */
+const char* ss_intern_sync(ss_intern_t* t, const char* str, size_t len, uint32_t* id);
+
+/**
+ * @brief Look up a string without interning it, lock-free
+ * @param[out] id Receives the string's id (may be NULL)
+ * @return Stable interned copy, NULL if the string was never interned
+ */
+const char* ss_intern_find(ss_intern_t* t, const char* str, size_t len, uint32_t* id);
+
+/**
+ * @brief Entry of an id, O(1) and lock-free
+ * @return Entry pointer, NULL if id was never handed out
+ */
+const ss_intern_entry_t* ss_intern_entry(const ss_intern_t* t, uint32_t id);
+
+/**
+ * @brief String of an id, O(1) and lock-free
+ * @return Interned string, NULL if id was never handed out
+ */
+static inline const char* ss_intern_str(const ss_intern_t* t, uint32_t id)
+{
+    const ss_intern_entry_t* e = ss_intern_entry(t, id);
+    return e ? e->str : NULL;
+}
+
+#define ss_intern_size(t) ((t)->size)
+#define ss_intern_bytes(t) ((t)->bytes)
+
+#endif /* SS_INTERN_H */
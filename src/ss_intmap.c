@@ -0,0 +1,250 @@
+#include "ss_alloc.h"
+#include "ss_hash.h"
+#include "ss_intmap.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Resize once size exceeds 3/4 of capacity
+#define _ss_intmap_full(m, n) ((n) * 4 > (m)->capacity * 3)
+
+// Every key bit must affect the low bits used for the slot index
+#define _ss_intmap_home(m, key) ((size_t)ss_hash_splitmix64(key) & ((m)->capacity - 1))
+
+static size_t _ss_intmap_round_capacity(size_t n)
+{
+    size_t capacity = SS_DEFAULT_INTMAP_CAPACITY;
+    while (capacity < n)
+    {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+static ss_intmap_slot_t* _ss_intmap_slots_new(size_t capacity)
+{
+    size_t size = capacity * sizeof(ss_intmap_slot_t);
+    ss_intmap_slot_t* slots = (ss_intmap_slot_t*)ss_malloc(size);
+    if (slots)
+    {
+        memset(slots, 0, size);
+    }
+    return slots;
+}
+
+// Key must be non-zero and absent
+static void _ss_intmap_insert_new(ss_intmap_t* m, uint64_t key, uint64_t value)
+{
+    size_t mask = m->capacity - 1;
+    size_t i = _ss_intmap_home(m, key);
+    while (m->slots[i].key)
+    {
+        i = (i + 1) & mask;
+    }
+    m->slots[i].key = key;
+    m->slots[i].value = value;
+}
+
+static ss_bool_t _ss_intmap_rehash(ss_intmap_t* m, size_t capacity)
+{
+    ss_intmap_slot_t* slots = _ss_intmap_slots_new(capacity);
+    if (!slots)
+    {
+        return SS_FALSE;
+    }
+    ss_intmap_slot_t* old = m->slots;
+    size_t old_capacity = m->capacity;
+    size_t i;
+    m->slots = slots;
+    m->capacity = capacity;
+    for (i = 0; i < old_capacity; i++)
+    {
+        if (old[i].key)
+        {
+            _ss_intmap_insert_new(m, old[i].key, old[i].value);
+        }
+    }
+    ss_free(old);
+    return SS_TRUE;
+}
+
+ss_bool_t ss_intmap_init(ss_intmap_t* m, size_t capacity)
+{
+    memset(m, 0, sizeof(ss_intmap_t));
+    m->capacity = _ss_intmap_round_capacity(capacity);
+    m->slots = _ss_intmap_slots_new(m->capacity);
+    return m->slots ? SS_TRUE : SS_FALSE;
+}
+
+void ss_intmap_destroy(ss_intmap_t* m)
+{
+    ss_free(m->slots);
+    m->slots = NULL;
+}
+
+ss_intmap_t* ss_intmap_create(size_t capacity)
+{
+    ss_intmap_t* m = (ss_intmap_t*)ss_malloc(sizeof(ss_intmap_t));
+    if (!m)
+    {
+        return NULL;
+    }
+    if (!ss_intmap_init(m, capacity))
+    {
+        ss_free(m);
+        return NULL;
+    }
+    return m;
+}
+
+void ss_intmap_free(ss_intmap_t* m)
+{
+    ss_intmap_destroy(m);
+    ss_free(m);
+}
+
+ss_bool_t ss_intmap_reserve(ss_intmap_t* m, size_t n)
+{
+    size_t capacity = m->capacity;
+    while (n * 4 > capacity * 3)
+    {
+        capacity <<= 1;
+    }
+    if (capacity == m->capacity)
+    {
+        return SS_TRUE;
+    }
+    return _ss_intmap_rehash(m, capacity);
+}
+
+uint64_t* ss_intmap_find(ss_intmap_t* m, uint64_t key)
+{
+    if (!key)
+    {
+        return m->has_zero ? &m->zero_value : NULL;
+    }
+    size_t mask = m->capacity - 1;
+    size_t i = _ss_intmap_home(m, key);
+    while (m->slots[i].key)
+    {
+        if (m->slots[i].key == key)
+        {
+            return &m->slots[i].value;
+        }
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+ss_bool_t ss_intmap_get(ss_intmap_t* m, uint64_t key, uint64_t* value)
+{
+    uint64_t* v = ss_intmap_find(m, key);
+    if (!v)
+    {
+        return SS_FALSE;
+    }
+    if (value)
+    {
+        *value = *v;
+    }
+    return SS_TRUE;
+}
+
+ss_bool_t ss_intmap_put(ss_intmap_t* m, uint64_t key, uint64_t value)
+{
+    if (!key)
+    {
+        if (!m->has_zero)
+        {
+            m->has_zero = SS_TRUE;
+            m->size++;
+        }
+        m->zero_value = value;
+        return SS_TRUE;
+    }
+    uint64_t* v = ss_intmap_find(m, key);
+    if (v)
+    {
+        *v = value;
+        return SS_TRUE;
+    }
+    if (_ss_intmap_full(m, m->size + 1) && !_ss_intmap_rehash(m, m->capacity << 1))
+    {
+        return SS_FALSE;
+    }
+    _ss_intmap_insert_new(m, key, value);
+    m->size++;
+    return SS_TRUE;
+}
+
+ss_bool_t ss_intmap_remove(ss_intmap_t* m, uint64_t key)
+{
+    if (!key)
+    {
+        if (!m->has_zero)
+        {
+            return SS_FALSE;
+        }
+        m->has_zero = SS_FALSE;
+        m->zero_value = 0;
+        m->size--;
+        return SS_TRUE;
+    }
+    size_t mask = m->capacity - 1;
+    size_t i = _ss_intmap_home(m, key);
+    while (m->slots[i].key != key)
+    {
+        if (!m->slots[i].key)
+        {
+            return SS_FALSE;
+        }
+        i = (i + 1) & mask;
+    }
+    // Backward shift: pull later members of the probe run into the hole
+    size_t j = i;
+    while (SS_TRUE)
+    {
+        j = (j + 1) & mask;
+        if (!m->slots[j].key)
+        {
+            break;
+        }
+        size_t home = _ss_intmap_home(m, m->slots[j].key);
+        // Slot j may move to i only if its home is not cyclically within (i, j]
+        if (((j - home) & mask) >= ((j - i) & mask))
+        {
+            m->slots[i] = m->slots[j];
+            i = j;
+        }
+    }
+    m->slots[i].key = 0;
+    m->slots[i].value = 0;
+    m->size--;
+    return SS_TRUE;
+}
+
+ss_bool_t ss_intmap_iterate(ss_intmap_t* m, ss_intmap_iterate_cb_f cb, void* param)
+{
+    size_t i;
+    if (m->has_zero && cb(m, 0, &m->zero_value, param))
+    {
+        return SS_TRUE;
+    }
+    for (i = 0; i < m->capacity; i++)
+    {
+        if (m->slots[i].key && cb(m, m->slots[i].key, &m->slots[i].value, param))
+        {
+            return SS_TRUE;
+        }
+    }
+    return SS_FALSE;
+}
+
+void ss_intmap_clear(ss_intmap_t* m)
+{
+    memset(m->slots, 0, m->capacity * sizeof(ss_intmap_slot_t));
+    m->size = 0;
+    m->has_zero = SS_FALSE;
+    m->zero_value = 0;
+}
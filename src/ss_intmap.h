@@ -0,0 +1,114 @@
+/**
+ * @file ss_intmap.h
+ * @brief Integer-keyed hash map with inline open-addressed slots
+ * @author trywen@qq.com
+ * @date 2026-10-18
+ *
+ * Maps uint64_t keys to uint64_t (or pointer) values. Features include:
+ * - 16 bytes per slot, no per-entry allocation
+ * - Built-in integer mixer, no hash/compare function pointers
+ * - Linear probing with backward-shift deletion (no tombstones)
+ * - Key 0 is the empty-slot sentinel and is stored on the side, so all keys are usable
+ */
+
+#ifndef SS_INTMAP_H
+#define SS_INTMAP_H
+
+#include "ss_types.h"
+
+/* Default slot count, always a power of two */
+#define SS_DEFAULT_INTMAP_CAPACITY 16
+
+/**
+ * @struct ss_intmap_slot_s
+ * @brief Inline key-value slot, key 0 marks an empty slot
+ */
+typedef struct ss_intmap_slot_s
+{
+    uint64_t key;
+    uint64_t value;
+} ss_intmap_slot_t;
+
+/**
+ * @struct ss_intmap_s
+ * @brief Integer map container structure
+ *
+ * @var slots Slot array
+ * @var capacity Slot count (power of two)
+ * @var size Number of stored pairs, including key 0
+ * @var has_zero SS_TRUE if key 0 is present
+ * @var zero_value Value of key 0
+ */
+struct ss_intmap_s
+{
+    ss_intmap_slot_t* slots;
+    size_t capacity;
+    size_t size;
+    ss_bool_t has_zero;
+    uint64_t zero_value;
+};
+
+/* If returns true, iteration will stop */
+typedef ss_bool_t (*ss_intmap_iterate_cb_f)(ss_intmap_t* m, uint64_t key, uint64_t* value,
+                                            void* param);
+
+/**
+ * @brief Initialize integer map
+ * @param[in] m Pointer to map structure
+ * @param[in] capacity Initial slot count, rounded up to a power of two (0 = default)
+ * @return SS_TRUE if initialization succeeded
+ */
+ss_bool_t ss_intmap_init(ss_intmap_t* m, size_t capacity);
+void ss_intmap_destroy(ss_intmap_t* m);
+
+/**
+ * @brief Create new integer map instance
+ * @note Caller must free with ss_intmap_free()
+ */
+ss_intmap_t* ss_intmap_create(size_t capacity);
+void ss_intmap_free(ss_intmap_t* m);
+
+/**
+ * @brief Ensure room for n pairs without rehashing
+ * @return SS_TRUE on success, SS_FALSE on allocation failure
+ */
+ss_bool_t ss_intmap_reserve(ss_intmap_t* m, size_t n);
+
+/**
+ * @brief Insert or update key-value pair
+ * @return SS_TRUE on success, SS_FALSE on allocation failure
+ */
+ss_bool_t ss_intmap_put(ss_intmap_t* m, uint64_t key, uint64_t value);
+
+/**
+ * @brief Look up the value slot of a key
+ * @return Pointer to the stored value, NULL if not found
+ * @note Returned pointer is valid until the next put or remove
+ */
+uint64_t* ss_intmap_find(ss_intmap_t* m, uint64_t key);
+
+/**
+ * @brief Retrieve value associated with key
+ * @param[out] value Receives the value (may be NULL)
+ * @return SS_TRUE if found
+ */
+ss_bool_t ss_intmap_get(ss_intmap_t* m, uint64_t key, uint64_t* value);
+
+ss_bool_t ss_intmap_remove(ss_intmap_t* m, uint64_t key);
+
+// param: user data for callback. Returns TRUE to stop iteration
+ss_bool_t ss_intmap_iterate(ss_intmap_t* m, ss_intmap_iterate_cb_f cb, void* param);
+
+void ss_intmap_clear(ss_intmap_t* m);
+
+#define ss_intmap_size(m) ((m)->size)
+
+/* Pointer-valued helpers */
+#define ss_intmap_put_ptr(m, key, ptr) ss_intmap_put((m), (key), (uint64_t)(uintptr_t)(ptr))
+static inline void* ss_intmap_get_ptr(ss_intmap_t* m, uint64_t key)
+{
+    uint64_t* v = ss_intmap_find(m, key);
+    return v ? (void*)(uintptr_t)*v : NULL;
+}
+
+#endif /* SS_INTMAP_H */
@@ -0,0 +1,319 @@
+#include "ss_alloc.h"
+#include "ss_itree.h"
+
+#include <string.h>
+
+/* AVL balancing as in ss_obtree, with the subtree maximum of hi maintained alongside */
+
+#define _ss_itree_height(node) ((node) ? (node)->height : 0)
+
+// Ranges sort by lo, then by hi
+#define _ss_itree_less(l, r) ((l)->lo < (r)->lo || ((l)->lo == (r)->lo && (l)->hi < (r)->hi))
+
+#define _ss_itree_overlaps(node, lo, hi) ((node)->lo <= (hi) && (node)->hi >= (lo))
+
+// Recompute height and subtree maximum from the children
+static void _ss_itree_node_update(ss_itree_node_t* node)
+{
+    int lh = _ss_itree_height(node->left);
+    int rh = _ss_itree_height(node->right);
+    node->height = (lh > rh ? lh : rh) + 1;
+    node->max = node->hi;
+    if (node->left && node->left->max > node->max)
+    {
+        node->max = node->left->max;
+    }
+    if (node->right && node->right->max > node->max)
+    {
+        node->max = node->right->max;
+    }
+}
+
+// Point whatever referenced old (parent link or root) at node
+static void _ss_itree_child_replace(ss_itree_t* t, ss_itree_node_t* parent, ss_itree_node_t* old,
+                                    ss_itree_node_t* node)
+{
+    if (!parent)
+    {
+        t->root = node;
+    }
+    else if (parent->left == old)
+    {
+        parent->left = node;
+    }
+    else
+    {
+        parent->right = node;
+    }
+    if (node)
+    {
+        node->parent = parent;
+    }
+}
+
+// Returns the new subtree root, node's right child
+static ss_itree_node_t* _ss_itree_rotate_left(ss_itree_t* t, ss_itree_node_t* node)
+{
+    ss_itree_node_t* pivot = node->right;
+    node->right = pivot->left;
+    if (pivot->left)
+    {
+        pivot->left->parent = node;
+    }
+    _ss_itree_child_replace(t, node->parent, node, pivot);
+    pivot->left = node;
+    node->parent = pivot;
+    _ss_itree_node_update(node);
+    _ss_itree_node_update(pivot);
+    return pivot;
+}
+
+// Returns the new subtree root, node's left child
+static ss_itree_node_t* _ss_itree_rotate_right(ss_itree_t* t, ss_itree_node_t* node)
+{
+    ss_itree_node_t* pivot = node->left;
+    node->left = pivot->right;
+    if (pivot->right)
+    {
+        pivot->right->parent = node;
+    }
+    _ss_itree_child_replace(t, node->parent, node, pivot);
+    pivot->right = node;
+    node->parent = pivot;
+    _ss_itree_node_update(node);
+    _ss_itree_node_update(pivot);
+    return pivot;
+}
+
+// Restore heights, maxima and balance from node up to the root. Unlike ss_obtree this
+// cannot stop once the height settles, since a removed hi may lower every maximum above
+static void _ss_itree_rebalance(ss_itree_t* t, ss_itree_node_t* node)
+{
+    while (node)
+    {
+        int balance = _ss_itree_height(node->left) - _ss_itree_height(node->right);
+        if (balance > 1)
+        {
+            if (_ss_itree_height(node->left->left) < _ss_itree_height(node->left->right))
+            {
+                _ss_itree_rotate_left(t, node->left);
+            }
+            node = _ss_itree_rotate_right(t, node);
+        }
+        else if (balance < -1)
+        {
+            if (_ss_itree_height(node->right->right) < _ss_itree_height(node->right->left))
+            {
+                _ss_itree_rotate_right(t, node->right);
+            }
+            node = _ss_itree_rotate_left(t, node);
+        }
+        else
+        {
+            _ss_itree_node_update(node);
+        }
+        node = node->parent;
+    }
+}
+
+// In-order visit of the ranges overlapping [lo, hi], skipping subtrees whose maximum
+// ends before lo and right subtrees that start after hi
+static ss_bool_t _ss_itree_overlap(ss_itree_t* t, ss_itree_node_t* node, uint64_t lo, uint64_t hi,
+                                   ss_itree_iterate_cb_f cb, void* param)
+{
+    while (node && node->max >= lo)
+    {
+        if (_ss_itree_overlap(t, node->left, lo, hi, cb, param))
+        {
+            return SS_TRUE;
+        }
+        if (node->lo > hi)
+        {
+            return SS_FALSE;
+        }
+        if (node->hi >= lo && cb(t, node, param))
+        {
+            return SS_TRUE;
+        }
+        node = node->right;
+    }
+    return SS_FALSE;
+}
+
+void ss_itree_init(ss_itree_t* t)
+{
+    t->root = NULL;
+    t->size = 0;
+}
+
+void ss_itree_destroy(ss_itree_t* t) { ss_itree_clear(t); }
+
+ss_itree_t* ss_itree_create(void)
+{
+    ss_itree_t* t = (ss_itree_t*)ss_malloc(sizeof(ss_itree_t));
+    if (t)
+    {
+        ss_itree_init(t);
+    }
+    return t;
+}
+
+void ss_itree_free(ss_itree_t* t)
+{
+    if (t)
+    {
+        ss_itree_destroy(t);
+        ss_free(t);
+    }
+}
+
+ss_itree_node_t* ss_itree_insert(ss_itree_t* t, uint64_t lo, uint64_t hi, const void* value,
+                                 size_t vsize)
+{
+    if (lo > hi)
+    {
+        return NULL;
+    }
+    ss_itree_node_t* node = (ss_itree_node_t*)ss_malloc(sizeof(ss_itree_node_t) + vsize);
+    if (!node)
+    {
+        return NULL;
+    }
+    node->left = NULL;
+    node->right = NULL;
+    node->lo = lo;
+    node->hi = hi;
+    node->max = hi;
+    node->height = 1;
+    node->vsize = vsize;
+    if (vsize)
+    {
+        memcpy(ss_itree_node_value(node), value, vsize);
+    }
+
+    // Equal ranges go right, so duplicates keep insertion order
+    ss_itree_node_t *parent = NULL, **link = &t->root;
+    while (*link)
+    {
+        parent = *link;
+        link = _ss_itree_less(node, parent) ? &parent->left : &parent->right;
+    }
+    *link = node;
+    node->parent = parent;
+    _ss_itree_rebalance(t, parent);
+    t->size++;
+    return node;
+}
+
+void ss_itree_remove(ss_itree_t* t, ss_itree_node_t* node)
+{
+    // Lowest node whose subtree changed
+    ss_itree_node_t* fix;
+    if (node->left && node->right)
+    {
+        // The in-order successor node moves into the removed position, so handles to
+        // other nodes stay valid
+        ss_itree_node_t* next = node->right;
+        while (next->left)
+        {
+            next = next->left;
+        }
+        if (next->parent != node)
+        {
+            fix = next->parent;
+            fix->left = next->right;
+            if (next->right)
+            {
+                next->right->parent = fix;
+            }
+            next->right = node->right;
+            node->right->parent = next;
+        }
+        else
+        {
+            fix = next;
+        }
+        next->left = node->left;
+        node->left->parent = next;
+        _ss_itree_child_replace(t, node->parent, node, next);
+    }
+    else
+    {
+        fix = node->parent;
+        _ss_itree_child_replace(t, node->parent, node, node->left ? node->left : node->right);
+    }
+    _ss_itree_rebalance(t, fix);
+    ss_free(node);
+    t->size--;
+}
+
+ss_itree_node_t* ss_itree_find_overlap(ss_itree_t* t, uint64_t lo, uint64_t hi)
+{
+    ss_itree_node_t* node = t->root;
+    while (node && node->max >= lo)
+    {
+        // A left subtree reaching lo holds the answer if there is one: its ranges start
+        // no later than anything to the right
+        if (node->left && node->left->max >= lo)
+        {
+            node = node->left;
+            continue;
+        }
+        if (_ss_itree_overlaps(node, lo, hi))
+        {
+            return node;
+        }
+        if (node->lo > hi)
+        {
+            return NULL;
+        }
+        node = node->right;
+    }
+    return NULL;
+}
+
+ss_bool_t ss_itree_overlap(ss_itree_t* t, uint64_t lo, uint64_t hi, ss_itree_iterate_cb_f cb,
+                           void* param)
+{
+    return lo <= hi && _ss_itree_overlap(t, t->root, lo, hi, cb, param);
+}
+
+ss_bool_t ss_itree_stab(ss_itree_t* t, uint64_t x, ss_itree_iterate_cb_f cb, void* param)
+{
+    return _ss_itree_overlap(t, t->root, x, x, cb, param);
+}
+
+ss_bool_t ss_itree_iterate(ss_itree_t* t, ss_itree_iterate_cb_f cb, void* param)
+{
+    return _ss_itree_overlap(t, t->root, 0, UINT64_MAX, cb, param);
+}
+
+void ss_itree_clear(ss_itree_t* t)
+{
+    ss_itree_node_t* node = t->root;
+    // Free leaves bottom-up, unlinking each from its parent
+    while (node)
+    {
+        if (node->left || node->right)
+        {
+            node = node->left ? node->left : node->right;
+            continue;
+        }
+        ss_itree_node_t* parent = node->parent;
+        if (parent)
+        {
+            if (parent->left == node)
+            {
+                parent->left = NULL;
+            }
+            else
+            {
+                parent->right = NULL;
+            }
+        }
+        ss_free(node);
+        node = parent;
+    }
+    t->root = NULL;
+    t->size = 0;
+}
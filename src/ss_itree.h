@@ -0,0 +1,97 @@
+/**
+ * @file ss_itree.h
+ * @brief Interval tree for stabbing and overlap queries
+ * @author trywen@qq.com
+ * @date 2026-10-18
+ *
+ * Stores closed uint64_t ranges [lo, hi], such as address or port ranges and time
+ * windows, each with a value. Features include:
+ * - AVL tree ordered by (lo, hi), every node keeping the largest hi of its subtree
+ * - Stabbing queries ("which ranges contain x") and overlap queries in O(log n + k)
+ * - First overlapping range in O(log n), for first-match rule lookups
+ * - Duplicate ranges; nodes are removed by handle
+ *
+ * Node handles stay valid until their own node is removed.
+ */
+
+#ifndef SS_ITREE_H
+#define SS_ITREE_H
+
+#include "ss_types.h"
+
+/**
+ * @struct ss_itree_node_s
+ * @brief Tree node, followed by the value bytes
+ *
+ * @var max Largest hi in the subtree rooted here
+ */
+struct ss_itree_node_s
+{
+    ss_itree_node_t* parent;
+    ss_itree_node_t* left;
+    ss_itree_node_t* right;
+    uint64_t lo;
+    uint64_t hi;
+    uint64_t max;
+    int height; // Levels in the subtree rooted here, 1 for a leaf
+    size_t vsize;
+};
+
+/**
+ * @struct ss_itree_s
+ * @brief Interval tree container structure
+ */
+struct ss_itree_s
+{
+    ss_itree_node_t* root;
+    size_t size;
+};
+
+/* If returns true, the query stops. The callback must not modify the tree */
+typedef ss_bool_t (*ss_itree_iterate_cb_f)(ss_itree_t* t, ss_itree_node_t* node, void* param);
+
+void ss_itree_init(ss_itree_t* t);
+void ss_itree_destroy(ss_itree_t* t);
+
+/**
+ * @brief Create new interval tree instance
+ * @note Caller must free with ss_itree_free()
+ */
+ss_itree_t* ss_itree_create(void);
+void ss_itree_free(ss_itree_t* t);
+
+/**
+ * @brief Insert the closed range [lo, hi]
+ * @param[in] value Copied into the node (may be NULL when vsize is 0)
+ * @return Node handle, NULL if lo > hi or allocation failed
+ */
+ss_itree_node_t* ss_itree_insert(ss_itree_t* t, uint64_t lo, uint64_t hi, const void* value,
+                                 size_t vsize);
+
+void ss_itree_remove(ss_itree_t* t, ss_itree_node_t* node);
+
+/**
+ * @brief First range in (lo, hi) order that overlaps [lo, hi], O(log n)
+ * @return NULL if no range overlaps
+ */
+ss_itree_node_t* ss_itree_find_overlap(ss_itree_t* t, uint64_t lo, uint64_t hi);
+
+/**
+ * @brief Visit the ranges overlapping [lo, hi] in (lo, hi) order, O(log n + k)
+ * @return SS_TRUE if the callback stopped the query
+ */
+ss_bool_t ss_itree_overlap(ss_itree_t* t, uint64_t lo, uint64_t hi, ss_itree_iterate_cb_f cb,
+                           void* param);
+
+// Visit the ranges containing x, same as ss_itree_overlap(t, x, x, cb, param)
+ss_bool_t ss_itree_stab(ss_itree_t* t, uint64_t x, ss_itree_iterate_cb_f cb, void* param);
+
+// param: user data for callback. Returns TRUE to stop iteration
+ss_bool_t ss_itree_iterate(ss_itree_t* t, ss_itree_iterate_cb_f cb, void* param);
+
+void ss_itree_clear(ss_itree_t* t);
+
+#define ss_itree_size(t) ((t)->size)
+#define ss_itree_node_value(node) ((void*)((node) + 1))
+
+#endif /* SS_ITREE_H */
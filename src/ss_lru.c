@@ -0,0 +1,297 @@
+#include "ss_alloc.h"
+#include "ss_lru.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define _ss_lru_charge(ksize, vsize) ((ksize) + (vsize))
+
+// Node header, value bytes (kept aligned behind the header), then key bytes
+static ss_lru_node_t* _ss_lru_node_new(const void* key, size_t ksize, const void* value,
+                                       size_t vsize)
+{
+    if (!value)
+    {
+        vsize = 0;
+    }
+    ss_lru_node_t* node = (ss_lru_node_t*)ss_malloc(sizeof(ss_lru_node_t) + vsize + ksize);
+    if (!node)
+    {
+        return NULL;
+    }
+    node->prev = NULL;
+    node->next = NULL;
+    node->entry.value = vsize > 0 ? (void*)(node + 1) : NULL;
+    node->entry.vsize = vsize;
+    node->entry.key = (char*)(node + 1) + vsize;
+    node->entry.ksize = ksize;
+    if (vsize > 0)
+    {
+        memcpy(node->entry.value, value, vsize);
+    }
+    memcpy(node->entry.key, key, ksize);
+    return node;
+}
+
+static void _ss_lru_unlink(ss_lru_t* lru, ss_lru_node_t* node)
+{
+    if (node->prev)
+    {
+        node->prev->next = node->next;
+    }
+    else
+    {
+        lru->head = node->next;
+    }
+    if (node->next)
+    {
+        node->next->prev = node->prev;
+    }
+    else
+    {
+        lru->tail = node->prev;
+    }
+    node->prev = NULL;
+    node->next = NULL;
+}
+
+static void _ss_lru_link_front(ss_lru_t* lru, ss_lru_node_t* node)
+{
+    node->prev = NULL;
+    node->next = lru->head;
+    if (lru->head)
+    {
+        lru->head->prev = node;
+    }
+    else
+    {
+        lru->tail = node;
+    }
+    lru->head = node;
+}
+
+static void _ss_lru_move_front(ss_lru_t* lru, ss_lru_node_t* node)
+{
+    if (lru->head != node)
+    {
+        _ss_lru_unlink(lru, node);
+        _ss_lru_link_front(lru, node);
+    }
+}
+
+// The map borrows key and value from the node, so the stored value is the node itself
+static ss_lru_node_t* _ss_lru_find(ss_lru_t* lru, const void* key, size_t ksize)
+{
+    return (ss_lru_node_t*)ss_hashmap_get(&lru->map, key, ksize, NULL);
+}
+
+static void _ss_lru_node_drop(ss_lru_t* lru, ss_lru_node_t* node)
+{
+    _ss_lru_unlink(lru, node);
+    lru->bytes -= _ss_lru_charge(node->entry.ksize, node->entry.vsize);
+    ss_hashmap_remove(&lru->map, node->entry.key, node->entry.ksize);
+    ss_free(node);
+}
+
+static ss_bool_t _ss_lru_over_capacity(ss_lru_t* lru)
+{
+    return (lru->max_entries && ss_lru_size(lru) > lru->max_entries) ||
+           (lru->max_bytes && lru->bytes > lru->max_bytes);
+}
+
+ss_bool_t ss_lru_init(ss_lru_t* lru, size_t max_entries, size_t max_bytes, ss_hash_f hash,
+                      ss_compare_f compare)
+{
+    memset(lru, 0, sizeof(ss_lru_t));
+    if (!ss_hashmap_init(&lru->map, SS_DEFAULT_HASHMAP_BUCKETS, hash, compare))
+    {
+        return SS_FALSE;
+    }
+    ss_hashmap_set_borrow(&lru->map, SS_BORROW_KEY | SS_BORROW_VALUE, NULL, NULL);
+    lru->max_entries = max_entries;
+    lru->max_bytes = max_bytes;
+    return SS_TRUE;
+}
+
+void ss_lru_destroy(ss_lru_t* lru)
+{
+    ss_lru_clear(lru);
+    ss_hashmap_destroy(&lru->map);
+}
+
+ss_lru_t* ss_lru_create(size_t max_entries, size_t max_bytes, ss_hash_f hash,
+                        ss_compare_f compare)
+{
+    ss_lru_t* lru = (ss_lru_t*)ss_malloc(sizeof(ss_lru_t));
+    if (!lru)
+    {
+        return NULL;
+    }
+    if (!ss_lru_init(lru, max_entries, max_bytes, hash, compare))
+    {
+        ss_free(lru);
+        return NULL;
+    }
+    return lru;
+}
+
+void ss_lru_free(ss_lru_t* lru)
+{
+    ss_lru_destroy(lru);
+    ss_free(lru);
+}
+
+void ss_lru_set_evict_cb(ss_lru_t* lru, ss_lru_evict_cb_f cb, void* param)
+{
+    lru->evict_cb = cb;
+    lru->evict_param = param;
+}
+
+ss_bool_t ss_lru_put(ss_lru_t* lru, const void* key, size_t ksize, const void* value,
+                     size_t vsize)
+{
+    if (!value)
+    {
+        vsize = 0;
+    }
+    if (lru->max_bytes && _ss_lru_charge(ksize, vsize) > lru->max_bytes)
+    {
+        return SS_FALSE;
+    }
+
+    ss_lru_node_t* node = _ss_lru_find(lru, key, ksize);
+    if (node)
+    {
+        if (node->entry.vsize == vsize)
+        {
+            // Same size: overwrite in place
+            if (vsize > 0)
+            {
+                memcpy(node->entry.value, value, vsize);
+            }
+            _ss_lru_move_front(lru, node);
+            return SS_TRUE;
+        }
+        ss_lru_node_t* newnode = _ss_lru_node_new(key, ksize, value, vsize);
+        if (!newnode)
+        {
+            return SS_FALSE;
+        }
+        // Repoint the borrowed key and value at the new node before releasing the old one
+        ss_hashmap_put(&lru->map, newnode->entry.key, ksize, newnode, sizeof(ss_lru_node_t));
+        _ss_lru_unlink(lru, node);
+        lru->bytes -= _ss_lru_charge(node->entry.ksize, node->entry.vsize);
+        ss_free(node);
+        _ss_lru_link_front(lru, newnode);
+        lru->bytes += _ss_lru_charge(ksize, vsize);
+    }
+    else
+    {
+        node = _ss_lru_node_new(key, ksize, value, vsize);
+        if (!node)
+        {
+            return SS_FALSE;
+        }
+        size_t size = ss_lru_size(lru);
+        ss_hashmap_put(&lru->map, node->entry.key, ksize, node, sizeof(ss_lru_node_t));
+        if (ss_lru_size(lru) == size)
+        {
+            ss_free(node);
+            return SS_FALSE;
+        }
+        _ss_lru_link_front(lru, node);
+        lru->bytes += _ss_lru_charge(ksize, vsize);
+    }
+
+    // The new entry sits at the head and fits on its own, so it is never evicted here
+    while (_ss_lru_over_capacity(lru))
+    {
+        ss_lru_evict(lru);
+    }
+    return SS_TRUE;
+}
+
+void* ss_lru_get(ss_lru_t* lru, const void* key, size_t ksize, size_t* vsize)
+{
+    ss_lru_node_t* node = _ss_lru_find(lru, key, ksize);
+    if (!node)
+    {
+        lru->misses++;
+        return NULL;
+    }
+    lru->hits++;
+    _ss_lru_move_front(lru, node);
+    if (vsize)
+    {
+        *vsize = node->entry.vsize;
+    }
+    return node->entry.value;
+}
+
+void* ss_lru_peek(ss_lru_t* lru, const void* key, size_t ksize, size_t* vsize)
+{
+    ss_lru_node_t* node = _ss_lru_find(lru, key, ksize);
+    if (!node)
+    {
+        return NULL;
+    }
+    if (vsize)
+    {
+        *vsize = node->entry.vsize;
+    }
+    return node->entry.value;
+}
+
+ss_bool_t ss_lru_touch(ss_lru_t* lru, const void* key, size_t ksize)
+{
+    ss_lru_node_t* node = _ss_lru_find(lru, key, ksize);
+    if (!node)
+    {
+        return SS_FALSE;
+    }
+    _ss_lru_move_front(lru, node);
+    return SS_TRUE;
+}
+
+ss_bool_t ss_lru_remove(ss_lru_t* lru, const void* key, size_t ksize)
+{
+    ss_lru_node_t* node = _ss_lru_find(lru, key, ksize);
+    if (!node)
+    {
+        return SS_FALSE;
+    }
+    _ss_lru_node_drop(lru, node);
+    return SS_TRUE;
+}
+
+ss_bool_t ss_lru_evict(ss_lru_t* lru)
+{
+    ss_lru_node_t* node = lru->tail;
+    if (!node)
+    {
+        return SS_FALSE;
+    }
+    if (lru->evict_cb)
+    {
+        lru->evict_cb(lru, &node->entry, lru->evict_param);
+    }
+    lru->evictions++;
+    _ss_lru_node_drop(lru, node);
+    return SS_TRUE;
+}
+
+void ss_lru_clear(ss_lru_t* lru)
+{
+    ss_lru_node_t* node = lru->head;
+    while (node)
+    {
+        ss_lru_node_t* next = node->next;
+        ss_free(node);
+        node = next;
+    }
+    lru->head = NULL;
+    lru->tail = NULL;
+    lru->bytes = 0;
+    ss_hashmap_clear(&lru->map);
+}
@@ -0,0 +1,166 @@
+/**
+ * @file ss_lru.h
+ * @brief Bounded least-recently-used cache
+ * @author trywen@qq.com
+ * @date 2026-10-18
+ *
+ * Combines an ss_hashmap index with an intrusive doubly linked recency list.
+ * Features include:
+ * - Entry-count and/or byte capacity limits
+ * - O(1) get/put/touch/evict (one hash probe plus pointer updates on hit)
+ * - Eviction callback and hit/miss/eviction counters
+ */
+
+#ifndef SS_LRU_H
+#define SS_LRU_H
+
+#include "ss_types.h"
+
+#include "ss_hashmap.h"
+
+/**
+ * @struct ss_lru_node_s
+ * @brief Cache node, allocated as a single block followed by value and key bytes
+ *
+ * @var prev Neighbour towards the most recently used end
+ * @var next Neighbour towards the least recently used end
+ * @var entry Key/value view into the bytes stored after the node header
+ */
+struct ss_lru_node_s
+{
+    ss_lru_node_t* prev;
+    ss_lru_node_t* next;
+    ss_entry_t entry;
+};
+
+/**
+ * @brief Eviction callback, invoked before an entry is dropped for capacity reasons
+ * @param lru Cache pointer
+ * @param entry Entry being evicted (key and value remain valid during the call)
+ * @param param User data given to ss_lru_set_evict_cb()
+ */
+typedef void (*ss_lru_evict_cb_f)(ss_lru_t* lru, const ss_entry_t* entry, void* param);
+
+/**
+ * @struct ss_lru_s
+ * @brief LRU cache container structure
+ *
+ * @var map Key to node index
+ * @var head Most recently used node
+ * @var tail Least recently used node
+ * @var max_entries Entry limit (0 = unlimited)
+ * @var max_bytes Byte limit over ksize + vsize of all entries (0 = unlimited)
+ * @var bytes Current byte charge
+ * @var hits Number of ss_lru_get() calls that found the key
+ * @var misses Number of ss_lru_get() calls that did not find the key
+ * @var evictions Number of entries dropped for capacity reasons
+ */
+struct ss_lru_s
+{
+    ss_hashmap_t map;
+    ss_lru_node_t* head;
+    ss_lru_node_t* tail;
+
+    size_t max_entries;
+    size_t max_bytes;
+    size_t bytes;
+
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+
+    ss_lru_evict_cb_f evict_cb;
+    void* evict_param;
+};
+
+/**
+ * @brief Initialize LRU cache
+ * @param[in] lru Pointer to cache structure
+ * @param[in] max_entries Maximum number of entries (0 = unlimited)
+ * @param[in] max_bytes Maximum ksize + vsize total (0 = unlimited)
+ * @param[in] hash Hash function for keys
+ * @param[in] compare Key comparison function
+ * @return SS_TRUE if initialization succeeded
+ */
+ss_bool_t ss_lru_init(ss_lru_t* lru, size_t max_entries, size_t max_bytes, ss_hash_f hash,
+                      ss_compare_f compare);
+void ss_lru_destroy(ss_lru_t* lru);
+
+/**
+ * @brief Create new LRU cache instance
+ * @return Newly allocated cache pointer, NULL on failure
+ * @note Caller must free with ss_lru_free()
+ */
+ss_lru_t* ss_lru_create(size_t max_entries, size_t max_bytes, ss_hash_f hash,
+                        ss_compare_f compare);
+void ss_lru_free(ss_lru_t* lru);
+
+/**
+ * @brief Set callback invoked for every capacity eviction
+ * @param[in] lru Cache pointer
+ * @param[in] cb Callback (NULL to disable)
+ * @param[in] param User data passed to callback
+ */
+void ss_lru_set_evict_cb(ss_lru_t* lru, ss_lru_evict_cb_f cb, void* param);
+
+/**
+ * @brief Insert or update an entry and mark it most recently used
+ * @param[in] lru Cache pointer
+ * @param[in] key Pointer to key data
+ * @param[in] ksize Key data size in bytes
+ * @param[in] value Pointer to value data (may be NULL)
+ * @param[in] vsize Value data size in bytes
+ * @return SS_TRUE on success, SS_FALSE on allocation failure or if the entry alone
+ *         exceeds max_bytes
+ * @note Least recently used entries are evicted until the new entry fits
+ */
+ss_bool_t ss_lru_put(ss_lru_t* lru, const void* key, size_t ksize, const void* value,
+                     size_t vsize);
+
+/**
+ * @brief Look up an entry and mark it most recently used
+ * @param[out] vsize Pointer to receive value size (may be NULL)
+ * @return Pointer to value data, NULL if not found
+ * @note Updates hit/miss counters. Returned pointer is valid until the entry is
+ *       updated, removed or evicted
+ */
+void* ss_lru_get(ss_lru_t* lru, const void* key, size_t ksize, size_t* vsize);
+
+/**
+ * @brief Look up an entry without changing recency or counters
+ */
+void* ss_lru_peek(ss_lru_t* lru, const void* key, size_t ksize, size_t* vsize);
+
+/**
+ * @brief Mark an entry most recently used
+ * @return SS_TRUE if the key exists
+ */
+ss_bool_t ss_lru_touch(ss_lru_t* lru, const void* key, size_t ksize);
+
+/**
+ * @brief Remove an entry without invoking the eviction callback
+ * @return SS_TRUE if the key existed
+ */
+ss_bool_t ss_lru_remove(ss_lru_t* lru, const void* key, size_t ksize);
+
+/**
+ * @brief Evict the least recently used entry
+ * @return SS_TRUE if an entry was evicted, SS_FALSE if the cache is empty
+ */
+ss_bool_t ss_lru_evict(ss_lru_t* lru);
+
+/**
+ * @brief Remove all entries without invoking the eviction callback
+ * @note Counters are preserved
+ */
+void ss_lru_clear(ss_lru_t* lru);
+
+#define ss_lru_size(lru) ss_hashmap_size(&(lru)->map)
+#define ss_lru_bytes(lru) ((lru)->bytes)
+
+/**
+ * @brief Least recently used entry, NULL if empty
+ */
+#define ss_lru_oldest(lru) ((lru)->tail ? &(lru)->tail->entry : NULL)
+
+#endif /* SS_LRU_H */
@@ -5,33 +5,44 @@
 #include <stdlib.h>
 #include <string.h>
 
-static ss_obtree_node_t* _ss_obtree_node_new(const void* key, size_t ksize, size_t khash,
-                                             const void* data, size_t dsize)
+// Fills a node as a leaf with copies (or borrows) of key and data
+static ss_bool_t _ss_obtree_node_init(ss_obtree_t* t, ss_obtree_node_t* node, const void* key,
+                                      size_t ksize, size_t khash, const void* data, size_t dsize)
 {
-    ss_obtree_node_t* node = (ss_obtree_node_t*)ss_malloc(sizeof(ss_obtree_node_t));
-    if (!node)
+    memset(node, 0, sizeof(ss_obtree_node_t));
+    node->height = 1;
+    node->count = 1;
+    if (t->borrow & SS_BORROW_KEY)
     {
-        return NULL;
+        node->entry.key = (void*)key;
     }
-    memset(node, 0, sizeof(ss_obtree_node_t));
-    node->entry.key = ss_malloc(ksize);
-    if (!node->entry.key)
+    else
     {
-        ss_free(node);
-        return NULL;
+        node->entry.key = ss_malloc(ksize);
+        if (!node->entry.key)
+        {
+            return SS_FALSE;
+        }
+        memcpy(node->entry.key, key, ksize);
     }
-    memcpy(node->entry.key, key, ksize);
     node->entry.ksize = ksize;
     node->khash = khash;
 
-    if (data && dsize > 0)
+    if (t->borrow & SS_BORROW_VALUE)
+    {
+        node->entry.value = (void*)data;
+        node->entry.vsize = data ? dsize : 0;
+    }
+    else if (data && dsize > 0)
     {
         node->entry.value = ss_malloc(dsize);
         if (!node->entry.value)
         {
-            ss_free(node->entry.key);
-            ss_free(node);
-            return NULL;
+            if (!(t->borrow & SS_BORROW_KEY))
+            {
+                ss_free(node->entry.key);
+            }
+            return SS_FALSE;
         }
         memcpy(node->entry.value, data, dsize);
         node->entry.vsize = dsize;
@@ -41,25 +52,79 @@ static ss_obtree_node_t* _ss_obtree_node_new(const void* key, size_t ksize, size
         node->entry.value = NULL;
         node->entry.vsize = 0;
     }
+    return SS_TRUE;
+}
 
+static ss_obtree_node_t* _ss_obtree_node_new(ss_obtree_t* t, const void* key, size_t ksize,
+                                             size_t khash, const void* data, size_t dsize)
+{
+    ss_obtree_node_t* node = (ss_obtree_node_t*)ss_malloc(sizeof(ss_obtree_node_t));
+    if (node && !_ss_obtree_node_init(t, node, key, ksize, khash, data, dsize))
+    {
+        ss_free(node);
+        return NULL;
+    }
     return node;
 }
 
-void _ss_obtree_node_free(ss_obtree_node_t* node)
+// Releases the entry of a node, not the node itself
+static void _ss_obtree_node_release(ss_obtree_t* t, ss_obtree_node_t* node)
 {
-    if (node->entry.value)
+    if (t->borrow & SS_BORROW_VALUE)
+    {
+        if (node->entry.value && t->val_free)
+        {
+            t->val_free(node->entry.value);
+        }
+    }
+    else if (node->entry.value)
     {
         ss_free(node->entry.value);
     }
-    ss_free(node->entry.key);
-    ss_free(node);
+    if (t->borrow & SS_BORROW_KEY)
+    {
+        if (t->key_free)
+        {
+            t->key_free(node->entry.key);
+        }
+    }
+    else
+    {
+        ss_free(node->entry.key);
+    }
+}
+
+// Nodes of a bulk-built block stay allocated until the whole block is freed
+#define _ss_obtree_in_block(t, node)                                                               \
+    ((t)->block && (uintptr_t)(node) >= (uintptr_t)(t)->block &&                                   \
+     (uintptr_t)(node) < (uintptr_t)((t)->block + (t)->block_size))
+
+void _ss_obtree_node_free(ss_obtree_t* t, ss_obtree_node_t* node)
+{
+    _ss_obtree_node_release(t, node);
+    if (!_ss_obtree_in_block(t, node))
+    {
+        ss_free(node);
+    }
+}
+
+static void _ss_obtree_block_free(ss_obtree_t* t)
+{
+    ss_free(t->block);
+    t->block = NULL;
+    t->block_size = 0;
 }
 
 int _ss_obtree_node_compare(ss_obtree_t* t, ss_obtree_node_t* node, const void* key, size_t ksize,
                             size_t khash)
 {
     int cmprs;
-    if (khash < node->khash)
+    if (!t->key_hash)
+    {
+        // Sorted mode orders by key alone
+        cmprs = t->key_compare(key, ksize, node->entry.key, node->entry.ksize);
+    }
+    else if (khash < node->khash)
     {
         cmprs = -1;
     }
@@ -168,9 +233,41 @@ ss_bool_t _ss_obtree_node_find(ss_obtree_t* t, const void* key, size_t ksize, si
     */
 }
 
+// Borrowed value: swap the pointer, releasing the previous one if it changed
+static void _ss_obtree_node_data_borrow(ss_obtree_t* t, ss_obtree_node_t* node, const void* data,
+                                        size_t dsize)
+{
+    if (node->entry.value && node->entry.value != data && t->val_free)
+    {
+        t->val_free(node->entry.value);
+    }
+    node->entry.value = (void*)data;
+    node->entry.vsize = data ? dsize : 0;
+}
+
+// Borrowed key: an equal key given by a later set takes over, releasing the previous one
+static void _ss_obtree_node_key_borrow(ss_obtree_t* t, ss_obtree_node_t* node, const void* key,
+                                       size_t ksize)
+{
+    if (node->entry.key != key)
+    {
+        if (t->key_free)
+        {
+            t->key_free(node->entry.key);
+        }
+        node->entry.key = (void*)key;
+        node->entry.ksize = ksize;
+    }
+}
+
 ss_bool_t _ss_obtree_node_data_replace(ss_obtree_t* t, ss_obtree_node_t* node, const void* data,
                                        size_t dsize)
 {
+    if (t->borrow & SS_BORROW_VALUE)
+    {
+        _ss_obtree_node_data_borrow(t, node, data, dsize);
+        return SS_TRUE;
+    }
     if (!data)
     {
         if (node->entry.value)
@@ -222,6 +319,122 @@ ss_bool_t _ss_obtree_node_data_replace(ss_obtree_t* t, ss_obtree_node_t* node, c
     return SS_TRUE;
 }
 
+/* AVL balancing: subtree heights differ by at most one at every node */
+
+#define _ss_obtree_height(node) ((node) ? (node)->height : 0)
+#define _ss_obtree_count(node) ((node) ? (node)->count : 0)
+
+// Recompute height and subtree count from the children
+static void _ss_obtree_node_update(ss_obtree_node_t* node)
+{
+    int lh = _ss_obtree_height(node->left);
+    int rh = _ss_obtree_height(node->right);
+    node->height = (lh > rh ? lh : rh) + 1;
+    node->count = _ss_obtree_count(node->left) + _ss_obtree_count(node->right) + 1;
+}
+
+// Add delta to the subtree counts of node and all its ancestors
+static void _ss_obtree_count_add(ss_obtree_node_t* node, size_t delta)
+{
+    for (; node; node = node->parent)
+    {
+        node->count += delta;
+    }
+}
+
+// Point whatever referenced old (parent link or root) at node
+static void _ss_obtree_child_replace(ss_obtree_t* t, ss_obtree_node_t* parent,
+                                     ss_obtree_node_t* old, ss_obtree_node_t* node)
+{
+    if (!parent)
+    {
+        t->root = node;
+    }
+    else if (parent->left == old)
+    {
+        parent->left = node;
+    }
+    else
+    {
+        parent->right = node;
+    }
+    if (node)
+    {
+        node->parent = parent;
+    }
+}
+
+// Returns the new subtree root, node's right child
+static ss_obtree_node_t* _ss_obtree_rotate_left(ss_obtree_t* t, ss_obtree_node_t* node)
+{
+    ss_obtree_node_t* pivot = node->right;
+    node->right = pivot->left;
+    if (pivot->left)
+    {
+        pivot->left->parent = node;
+    }
+    _ss_obtree_child_replace(t, node->parent, node, pivot);
+    pivot->left = node;
+    node->parent = pivot;
+    _ss_obtree_node_update(node);
+    _ss_obtree_node_update(pivot);
+    return pivot;
+}
+
+// Returns the new subtree root, node's left child
+static ss_obtree_node_t* _ss_obtree_rotate_right(ss_obtree_t* t, ss_obtree_node_t* node)
+{
+    ss_obtree_node_t* pivot = node->left;
+    node->left = pivot->right;
+    if (pivot->right)
+    {
+        pivot->right->parent = node;
+    }
+    _ss_obtree_child_replace(t, node->parent, node, pivot);
+    pivot->right = node;
+    node->parent = pivot;
+    _ss_obtree_node_update(node);
+    _ss_obtree_node_update(pivot);
+    return pivot;
+}
+
+// Restore heights and balance from node up to the root after a subtree changed height
+static void _ss_obtree_rebalance(ss_obtree_t* t, ss_obtree_node_t* node)
+{
+    while (node)
+    {
+        ss_obtree_node_t* parent = node->parent;
+        int height = node->height;
+        int balance = _ss_obtree_height(node->left) - _ss_obtree_height(node->right);
+        if (balance > 1)
+        {
+            if (_ss_obtree_height(node->left->left) < _ss_obtree_height(node->left->right))
+            {
+                _ss_obtree_rotate_left(t, node->left);
+            }
+            node = _ss_obtree_rotate_right(t, node);
+        }
+        else if (balance < -1)
+        {
+            if (_ss_obtree_height(node->right->right) < _ss_obtree_height(node->right->left))
+            {
+                _ss_obtree_rotate_right(t, node->right);
+            }
+            node = _ss_obtree_rotate_left(t, node);
+        }
+        else
+        {
+            _ss_obtree_node_update(node);
+        }
+        if (node->height == height)
+        {
+            // Ancestors see the same subtree height as before
+            break;
+        }
+        node = parent;
+    }
+}
+
 // Query and set node: create new if not found, otherwise update existing value
 ss_obtree_node_t* _ss_obtree_node_find_and_set(ss_obtree_t* t, const void* key, size_t ksize,
                                                size_t khash, const void* data, size_t dsize)
@@ -230,12 +443,16 @@ ss_obtree_node_t* _ss_obtree_node_find_and_set(ss_obtree_t* t, const void* key,
     int cmprs = 0;
     if (_ss_obtree_node_find(t, key, ksize, khash, &retnode, &cmprs))
     {
+        if (t->borrow & SS_BORROW_KEY)
+        {
+            _ss_obtree_node_key_borrow(t, retnode, key, ksize);
+        }
         _ss_obtree_node_data_replace(t, retnode, data, dsize);
         return retnode;
     }
     else
     {
-        ss_obtree_node_t* newnode = _ss_obtree_node_new(key, ksize, khash, data, dsize);
+        ss_obtree_node_t* newnode = _ss_obtree_node_new(t, key, ksize, khash, data, dsize);
         if (newnode)
         {
             if (cmprs < 0)
@@ -248,6 +465,8 @@ ss_obtree_node_t* _ss_obtree_node_find_and_set(ss_obtree_t* t, const void* key,
             }
             newnode->parent = retnode;
             t->size++;
+            _ss_obtree_count_add(retnode, 1);
+            _ss_obtree_rebalance(t, retnode);
         }
         return newnode;
     }
@@ -271,6 +490,9 @@ ss_obtree_node_t* _ss_obtree_left_leaf_find(ss_obtree_node_t* node)
     return node;
 }
 
+// Sorted-mode trees have no hash function and store 0
+#define _ss_obtree_key_hash(t, key, ksize) ((t)->key_hash ? (t)->key_hash(key, ksize) : 0)
+
 void ss_obtree_init(ss_obtree_t* t, ss_hash_f key_hash, ss_compare_f key_compare,
                     ss_compare_f val_compare)
 {
@@ -281,10 +503,23 @@ void ss_obtree_init(ss_obtree_t* t, ss_hash_f key_hash, ss_compare_f key_compare
     t->val_compare = val_compare;
 }
 
+void ss_obtree_init_sorted(ss_obtree_t* t, ss_compare_f key_compare, ss_compare_f val_compare)
+{
+    ss_obtree_init(t, NULL, key_compare, val_compare);
+}
+
+void ss_obtree_set_borrow(ss_obtree_t* t, unsigned int borrow, ss_free_f key_free,
+                          ss_free_f val_free)
+{
+    t->borrow = borrow;
+    t->key_free = key_free;
+    t->val_free = val_free;
+}
+
 ss_obtree_node_t* ss_obtree_set(ss_obtree_t* t, const void* key, size_t ksize, const void* data,
                                 size_t dsize)
 {
-    return ss_obtree_set2(t, key, ksize, t->key_hash(key, ksize), data, dsize);
+    return ss_obtree_set2(t, key, ksize, _ss_obtree_key_hash(t, key, ksize), data, dsize);
 }
 
 ss_obtree_node_t* ss_obtree_set2(ss_obtree_t* t, const void* key, size_t ksize, size_t khash,
@@ -296,7 +531,7 @@ ss_obtree_node_t* ss_obtree_set2(ss_obtree_t* t, const void* key, size_t ksize,
     }
     else
     {
-        t->root = _ss_obtree_node_new(key, ksize, khash, data, dsize);
+        t->root = _ss_obtree_node_new(t, key, ksize, khash, data, dsize);
         t->size++;
         return t->root;
     }
@@ -304,7 +539,7 @@ ss_obtree_node_t* ss_obtree_set2(ss_obtree_t* t, const void* key, size_t ksize,
 
 ss_obtree_node_t* ss_obtree_get(ss_obtree_t* t, const void* key, size_t ksize)
 {
-    return ss_obtree_get2(t, key, ksize, t->key_hash(key, ksize));
+    return ss_obtree_get2(t, key, ksize, _ss_obtree_key_hash(t, key, ksize));
 }
 
 ss_obtree_node_t* ss_obtree_get2(ss_obtree_t* t, const void* key, size_t ksize, size_t khash)
@@ -319,7 +554,7 @@ ss_obtree_node_t* ss_obtree_get2(ss_obtree_t* t, const void* key, size_t ksize,
 }
 ss_bool_t ss_obtree_remove(ss_obtree_t* t, const void* key, size_t ksize)
 {
-    return ss_obtree_remove2(t, key, ksize, t->key_hash(key, ksize));
+    return ss_obtree_remove2(t, key, ksize, _ss_obtree_key_hash(t, key, ksize));
 }
 
 ss_bool_t ss_obtree_remove2(ss_obtree_t* t, const void* key, size_t ksize, size_t khash)
@@ -333,200 +568,785 @@ ss_bool_t ss_obtree_remove2(ss_obtree_t* t, const void* key, size_t ksize, size_
     return SS_FALSE;
 }
 
-ss_bool_t ss_obtree_node_remove(ss_obtree_t* t, ss_obtree_node_t* node)
+// Takes node out of the tree and rebalances, leaving the node itself to the caller
+static void _ss_obtree_node_unlink(ss_obtree_t* t, ss_obtree_node_t* node)
 {
-    if (!t->root)
+    // Lowest node whose subtree lost a level
+    ss_obtree_node_t* fix;
+    if (node->left && node->right)
     {
-        return SS_FALSE;
-    }
-    if (node == t->root)
-    { // Delete root node
-        if (node->left)
+        // The in-order successor node moves into the removed position, so node
+        // handles held by callers keep their entries
+        ss_obtree_node_t* next = _ss_obtree_left_leaf_find(node->right);
+        if (next->parent != node)
         {
-            t->root = node->left;
-            t->root->parent = NULL;
-            if (node->right)
+            fix = next->parent;
+            fix->left = next->right;
+            if (next->right)
             {
-                // If right subtree exists, attach to rightmost leaf of left subtree
-                // Return rightmost leaf node of left subtree
-                ss_obtree_node_t* leaf = _ss_obtree_right_leaf_find(node->left);
-                leaf->right = node->right;
-                node->right->parent = leaf;
+                next->right->parent = fix;
             }
+            next->right = node->right;
+            node->right->parent = next;
         }
         else
         {
-            t->root = node->right;
-            if (t->root) t->root->parent = NULL;
+            fix = next;
         }
+        next->left = node->left;
+        node->left->parent = next;
+        next->height = node->height;
+        next->count = node->count;
+        _ss_obtree_child_replace(t, node->parent, node, next);
     }
     else
     {
-        // Is left child node
-        if (node == node->parent->left)
+        fix = node->parent;
+        _ss_obtree_child_replace(t, node->parent, node, node->left ? node->left : node->right);
+    }
+    // Rotations recompute counts locally, so settle the path first
+    _ss_obtree_count_add(fix, (size_t)-1);
+    _ss_obtree_rebalance(t, fix);
+}
+
+ss_bool_t ss_obtree_node_remove(ss_obtree_t* t, ss_obtree_node_t* node)
+{
+    if (!t->root)
+    {
+        return SS_FALSE;
+    }
+    _ss_obtree_node_unlink(t, node);
+    _ss_obtree_node_free(t, node);
+    t->size--;
+    if (t->size == 0 && t->block)
+    {
+        _ss_obtree_block_free(t);
+    }
+    return SS_TRUE;
+}
+
+// Links nodes[lo, hi) into a perfectly balanced subtree, returns its root
+static ss_obtree_node_t* _ss_obtree_build(ss_obtree_node_t* nodes, size_t lo, size_t hi,
+                                          ss_obtree_node_t* parent)
+{
+    if (lo == hi)
+    {
+        return NULL;
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    ss_obtree_node_t* node = &nodes[mid];
+    node->parent = parent;
+    node->left = _ss_obtree_build(nodes, lo, mid, node);
+    node->right = _ss_obtree_build(nodes, mid + 1, hi, node);
+    _ss_obtree_node_update(node);
+    return node;
+}
+
+ss_bool_t ss_obtree_build_sorted(ss_obtree_t* t, const ss_entry_t* entries, size_t n)
+{
+    size_t i;
+    if (t->root)
+    {
+        return SS_FALSE;
+    }
+    if (n == 0)
+    {
+        return SS_TRUE;
+    }
+    ss_obtree_node_t* nodes =
+        (ss_obtree_node_t*)ss_malloc((unsigned long)(n * sizeof(ss_obtree_node_t)));
+    if (!nodes)
+    {
+        return SS_FALSE;
+    }
+    for (i = 0; i < n; i++)
+    {
+        const ss_entry_t* e = &entries[i];
+        size_t khash = _ss_obtree_key_hash(t, e->key, e->ksize);
+        // Each entry must order strictly after the previous one
+        if ((i > 0 && _ss_obtree_node_compare(t, &nodes[i - 1], e->key, e->ksize, khash) <= 0) ||
+            !_ss_obtree_node_init(t, &nodes[i], e->key, e->ksize, khash, e->value, e->vsize))
         {
-            if (node->right)
+            // Undo the copies; borrowed pointers stay with the caller
+            while (i-- > 0)
             {
-                node->parent->left = node->right;
-                node->right->parent = node->parent;
-                if (node->left)
+                if (!(t->borrow & SS_BORROW_KEY))
                 {
-                    // If right subtree exists, attach to rightmost leaf of left subtree
-                    // Return rightmost leaf node of left subtree
-                    ss_obtree_node_t* leaf = _ss_obtree_left_leaf_find(node->right);
-                    leaf->left = node->left;
-                    node->left->parent = leaf;
+                    ss_free(nodes[i].entry.key);
+                }
+                if (!(t->borrow & SS_BORROW_VALUE) && nodes[i].entry.value)
+                {
+                    ss_free(nodes[i].entry.value);
                 }
             }
-            else
-            {
-                node->parent->left = node->left;
-                if (node->left) node->left->parent = node->parent;
-            }
+            ss_free(nodes);
+            return SS_FALSE;
         }
-        else
-        { // Is right child node
-            if (node->left)
+    }
+    t->block = nodes;
+    t->block_size = n;
+    t->root = _ss_obtree_build(nodes, 0, n, NULL);
+    t->size = n;
+    return SS_TRUE;
+}
+
+/* Split, join and merge: subtrees are cut and relinked with AVL joins, never copied */
+
+// Where a node lives after _ss_obtree_block_detach(), given the block index to copy map
+#define _ss_obtree_block_node(t, map, node)                                                        \
+    (_ss_obtree_in_block(t, node) ? (map)[(node) - (t)->block] : (node))
+
+// Moves the live nodes of a bulk-built block into their own allocations, so that they
+// can leave the tree one by one; O(n)
+static ss_bool_t _ss_obtree_block_detach(ss_obtree_t* t)
+{
+    size_t i, n = 0;
+    if (!t->block)
+    {
+        return SS_TRUE;
+    }
+    ss_obtree_node_t** nodes =
+        (ss_obtree_node_t**)ss_malloc((unsigned long)(t->size * sizeof(ss_obtree_node_t*)));
+    ss_obtree_node_t** map =
+        (ss_obtree_node_t**)ss_malloc((unsigned long)(t->block_size * sizeof(ss_obtree_node_t*)));
+    if (!nodes || !map)
+    {
+        if (nodes)
+        {
+            ss_free(nodes);
+        }
+        if (map)
+        {
+            ss_free(map);
+        }
+        return SS_FALSE;
+    }
+    memset(map, 0, t->block_size * sizeof(ss_obtree_node_t*));
+    for (ss_obtree_node_t* node = ss_obtree_first(t); node; node = ss_obtree_next(node))
+    {
+        nodes[n++] = node;
+        if (_ss_obtree_in_block(t, node))
+        {
+            ss_obtree_node_t* copy = (ss_obtree_node_t*)ss_malloc(sizeof(ss_obtree_node_t));
+            if (!copy)
             {
-                node->parent->right = node->left;
-                node->left->parent = node->parent;
-                if (node->right)
+                for (i = 0; i < t->block_size; i++)
                 {
-                    // If right subtree exists, attach to rightmost leaf of left subtree
-                    // Return rightmost leaf node of left subtree
-                    ss_obtree_node_t* leaf = _ss_obtree_right_leaf_find(node->left);
-                    leaf->right = node->right;
-                    node->right->parent = leaf;
+                    if (map[i])
+                    {
+                        ss_free(map[i]);
+                    }
                 }
+                ss_free(nodes);
+                ss_free(map);
+                return SS_FALSE;
             }
-            else
-            {
-                node->parent->right = node->right;
-                if (node->right) node->right->parent = node->parent;
-            }
+            *copy = *node;
+            map[node - t->block] = copy;
         }
     }
-    _ss_obtree_node_free(node);
-    t->size--;
+    // Old block nodes still hold the original links, so every read below sees them
+    for (i = 0; i < n; i++)
+    {
+        ss_obtree_node_t* node = _ss_obtree_block_node(t, map, nodes[i]);
+        node->parent = _ss_obtree_block_node(t, map, nodes[i]->parent);
+        node->left = _ss_obtree_block_node(t, map, nodes[i]->left);
+        node->right = _ss_obtree_block_node(t, map, nodes[i]->right);
+    }
+    t->root = _ss_obtree_block_node(t, map, t->root);
+    ss_free(nodes);
+    ss_free(map);
+    _ss_obtree_block_free(t);
     return SS_TRUE;
 }
 
-ss_bool_t _ss_obtree_preorder(ss_obtree_t* t, ss_obtree_node_t* node, int* depth,
-                              ss_obtree_iterate_cb_f it, void* param)
+// Gives src's block to dst when dst has none, detaching it otherwise
+static ss_bool_t _ss_obtree_block_move(ss_obtree_t* dst, ss_obtree_t* src)
 {
-    if (node)
+    if (!src->block)
+    {
+        return SS_TRUE;
+    }
+    if (dst->block)
     {
-        if (it(t, node, *depth, param))
+        return _ss_obtree_block_detach(src);
+    }
+    dst->block = src->block;
+    dst->block_size = src->block_size;
+    src->block = NULL;
+    src->block_size = 0;
+    return SS_TRUE;
+}
+
+// Trees exchanging nodes must agree on order and entry ownership
+static ss_bool_t _ss_obtree_compatible(const ss_obtree_t* t, const ss_obtree_t* other)
+{
+    return t->key_hash == other->key_hash && t->key_compare == other->key_compare &&
+           t->borrow == other->borrow && t->key_free == other->key_free &&
+           t->val_free == other->val_free;
+}
+
+// Links left < mid < right into one balanced tree and returns its root. left and right
+// are detached AVL subtrees of any heights; mid is hung where the shorter one fits
+// along the spine of the taller one, which is then rebalanced as after an insert
+static ss_obtree_node_t* _ss_obtree_join3(ss_obtree_node_t* left, ss_obtree_node_t* mid,
+                                          ss_obtree_node_t* right)
+{
+    ss_obtree_t scratch; // Only its root is used by the balancing helpers
+    ss_obtree_node_t *parent = NULL, *node;
+    int lh = _ss_obtree_height(left);
+    int rh = _ss_obtree_height(right);
+
+    if (lh > rh + 1)
+    {
+        scratch.root = left;
+        for (node = left; _ss_obtree_height(node) > rh + 1; node = node->right)
         {
-            return SS_TRUE;
+            parent = node;
         }
-        (*depth)++;
-        if (_ss_obtree_preorder(t, node->left, depth, it, param))
+        mid->left = node;
+        mid->right = right;
+    }
+    else if (rh > lh + 1)
+    {
+        scratch.root = right;
+        for (node = right; _ss_obtree_height(node) > lh + 1; node = node->left)
         {
-            return SS_TRUE;
+            parent = node;
+        }
+        mid->left = left;
+        mid->right = node;
+    }
+    else
+    {
+        scratch.root = mid;
+        mid->left = left;
+        mid->right = right;
+        node = NULL;
+    }
+
+    size_t replaced = _ss_obtree_count(node);
+    if (mid->left)
+    {
+        mid->left->parent = mid;
+    }
+    if (mid->right)
+    {
+        mid->right->parent = mid;
+    }
+    mid->parent = parent;
+    _ss_obtree_node_update(mid);
+    if (parent)
+    {
+        if (lh > rh)
+        {
+            parent->right = mid;
         }
-        if (_ss_obtree_preorder(t, node->right, depth, it, param))
+        else
         {
-            return SS_TRUE;
+            parent->left = mid;
         }
-        (*depth)--;
+        _ss_obtree_count_add(parent, mid->count - replaced);
+        _ss_obtree_rebalance(&scratch, parent);
     }
-    return SS_FALSE;
+    return scratch.root;
 }
 
-ss_bool_t ss_obtree_preorder(ss_obtree_t* t, ss_obtree_iterate_cb_f it, void* param)
+// Splits the detached subtree node into the keys ordered before key (*left) and after
+// it (*right); a node equal to key is unlinked into *match, NULL if there is none
+static void _ss_obtree_split(ss_obtree_t* t, ss_obtree_node_t* node, const void* key,
+                             size_t ksize, size_t khash, ss_obtree_node_t** left,
+                             ss_obtree_node_t** right, ss_obtree_node_t** match)
 {
-    if (!t->root)
+    ss_obtree_node_t *l, *r;
+    if (!node)
+    {
+        *left = *right = NULL;
+        return;
+    }
+    l = node->left;
+    r = node->right;
+    if (l)
+    {
+        l->parent = NULL;
+    }
+    if (r)
+    {
+        r->parent = NULL;
+    }
+    int c = _ss_obtree_node_compare(t, node, key, ksize, khash);
+    if (c == 0)
+    {
+        *left = l;
+        *right = r;
+        *match = node;
+    }
+    else if (c < 0)
+    {
+        _ss_obtree_split(t, l, key, ksize, khash, left, &l, match);
+        *right = _ss_obtree_join3(l, node, r);
+    }
+    else
+    {
+        _ss_obtree_split(t, r, key, ksize, khash, &r, right, match);
+        *left = _ss_obtree_join3(l, node, r);
+    }
+}
+
+// Joins two detached subtrees whose keys are all ordered left before right
+static ss_obtree_node_t* _ss_obtree_join2(ss_obtree_node_t* left, ss_obtree_node_t* right)
+{
+    if (!left || !right)
+    {
+        return left ? left : right;
+    }
+    ss_obtree_t scratch;
+    scratch.root = left;
+    ss_obtree_node_t* mid = _ss_obtree_right_leaf_find(left);
+    _ss_obtree_node_unlink(&scratch, mid);
+    return _ss_obtree_join3(scratch.root, mid, right);
+}
+
+// Union of two detached subtrees of t's order. Nodes of b whose key is already in a are
+// unlinked and freed through t
+static ss_obtree_node_t* _ss_obtree_union(ss_obtree_t* t, ss_obtree_node_t* a, ss_obtree_node_t* b)
+{
+    ss_obtree_node_t *bl, *br, *match = NULL;
+    if (!a || !b)
+    {
+        return a ? a : b;
+    }
+    ss_obtree_node_t* al = a->left;
+    ss_obtree_node_t* ar = a->right;
+    if (al)
+    {
+        al->parent = NULL;
+    }
+    if (ar)
+    {
+        ar->parent = NULL;
+    }
+    _ss_obtree_split(t, b, a->entry.key, a->entry.ksize, a->khash, &bl, &br, &match);
+    if (match)
+    {
+        _ss_obtree_node_free(t, match);
+        t->size--;
+    }
+    al = _ss_obtree_union(t, al, bl);
+    ar = _ss_obtree_union(t, ar, br);
+    return _ss_obtree_join3(al, a, ar);
+}
+
+ss_bool_t ss_obtree_split(ss_obtree_t* t, const void* key, size_t ksize, ss_obtree_t* right)
+{
+    ss_obtree_node_t *l, *r, *match = NULL;
+    if (right->root || !_ss_obtree_block_detach(t))
     {
         return SS_FALSE;
     }
-    int depth = 0;
-    return _ss_obtree_preorder(t, t->root, &depth, it, param);
+    right->key_hash = t->key_hash;
+    right->key_compare = t->key_compare;
+    right->val_compare = t->val_compare;
+    right->borrow = t->borrow;
+    right->key_free = t->key_free;
+    right->val_free = t->val_free;
+
+    _ss_obtree_split(t, t->root, key, ksize, _ss_obtree_key_hash(t, key, ksize), &l, &r, &match);
+    if (match)
+    {
+        r = _ss_obtree_join3(NULL, match, r);
+    }
+    t->root = l;
+    t->size = _ss_obtree_count(l);
+    right->root = r;
+    right->size = _ss_obtree_count(r);
+    return SS_TRUE;
 }
 
-ss_bool_t _ss_obtree_inorder(ss_obtree_t* t, ss_obtree_node_t* node, int* depth,
-                             ss_obtree_iterate_cb_f it, void* param)
+ss_bool_t ss_obtree_join(ss_obtree_t* t, ss_obtree_t* right)
 {
-    if (node)
+    if (!_ss_obtree_compatible(t, right))
     {
-        (*depth)++;
-        _ss_obtree_inorder(t, node->left, depth, it, param);
-        (*depth)--;
-        if (it(t, node, *depth, param))
+        return SS_FALSE;
+    }
+    if (!right->root)
+    {
+        return SS_TRUE;
+    }
+    if (t->root)
+    {
+        ss_obtree_node_t* last = _ss_obtree_right_leaf_find(t->root);
+        ss_obtree_node_t* first = _ss_obtree_left_leaf_find(right->root);
+        if (_ss_obtree_node_compare(t, last, first->entry.key, first->entry.ksize, first->khash) <=
+            0)
         {
-            return SS_TRUE;
+            return SS_FALSE;
         }
-        (*depth)++;
-        _ss_obtree_inorder(t, node->right, depth, it, param);
-        (*depth)--;
     }
-    return SS_FALSE;
+    if (!_ss_obtree_block_move(t, right))
+    {
+        return SS_FALSE;
+    }
+    t->root = _ss_obtree_join2(t->root, right->root);
+    t->size += right->size;
+    right->root = NULL;
+    right->size = 0;
+    return SS_TRUE;
 }
 
-ss_bool_t ss_obtree_inorder(ss_obtree_t* t, ss_obtree_iterate_cb_f it, void* param)
+ss_bool_t ss_obtree_merge(ss_obtree_t* t, ss_obtree_t* other)
 {
-    if (!t->root)
+    if (!_ss_obtree_compatible(t, other) || !_ss_obtree_block_move(t, other))
     {
         return SS_FALSE;
     }
-    int depth = 0;
-    return _ss_obtree_inorder(t, t->root, &depth, it, param);
+    t->size += other->size;
+    t->root = _ss_obtree_union(t, t->root, other->root);
+    other->root = NULL;
+    other->size = 0;
+    return SS_TRUE;
 }
 
-ss_bool_t _ss_obtree_postorder(ss_obtree_t* t, ss_obtree_node_t* node, int* depth,
-                               ss_obtree_iterate_cb_f it, void* param)
+ss_obtree_node_t* ss_obtree_first(ss_obtree_t* t)
 {
-    if (node)
+    return t->root ? _ss_obtree_left_leaf_find(t->root) : NULL;
+}
+
+ss_obtree_node_t* ss_obtree_last(ss_obtree_t* t)
+{
+    return t->root ? _ss_obtree_right_leaf_find(t->root) : NULL;
+}
+
+ss_obtree_node_t* ss_obtree_next(ss_obtree_node_t* node)
+{
+    if (node->right)
     {
-        (*depth)++;
-        _ss_obtree_postorder(t, node->left, depth, it, param);
-        _ss_obtree_postorder(t, node->right, depth, it, param);
-        (*depth)--;
-        if (it(t, node, *depth, param))
+        return _ss_obtree_left_leaf_find(node->right);
+    }
+    // Climb until arriving from a left subtree
+    while (node->parent && node == node->parent->right)
+    {
+        node = node->parent;
+    }
+    return node->parent;
+}
+
+ss_obtree_node_t* ss_obtree_prev(ss_obtree_node_t* node)
+{
+    if (node->left)
+    {
+        return _ss_obtree_right_leaf_find(node->left);
+    }
+    while (node->parent && node == node->parent->left)
+    {
+        node = node->parent;
+    }
+    return node->parent;
+}
+
+// First node ordered after key, or equal to it when inclusive
+static ss_obtree_node_t* _ss_obtree_bound(ss_obtree_t* t, const void* key, size_t ksize,
+                                          ss_bool_t inclusive)
+{
+    size_t khash = _ss_obtree_key_hash(t, key, ksize);
+    ss_obtree_node_t* node = t->root;
+    ss_obtree_node_t* bound = NULL;
+    while (node)
+    {
+        int cmprs = _ss_obtree_node_compare(t, node, key, ksize, khash);
+        if (cmprs < 0 || (cmprs == 0 && inclusive))
         {
-            return SS_TRUE;
+            bound = node;
+            node = node->left;
+        }
+        else
+        {
+            node = node->right;
         }
     }
-    return SS_FALSE;
+    return bound;
 }
 
-ss_bool_t ss_obtree_postorder(ss_obtree_t* t, ss_obtree_iterate_cb_f it, void* param)
+ss_obtree_node_t* ss_obtree_lower_bound(ss_obtree_t* t, const void* key, size_t ksize)
 {
-    if (!t->root)
+    return _ss_obtree_bound(t, key, ksize, SS_TRUE);
+}
+
+ss_obtree_node_t* ss_obtree_upper_bound(ss_obtree_t* t, const void* key, size_t ksize)
+{
+    return _ss_obtree_bound(t, key, ksize, SS_FALSE);
+}
+
+ss_obtree_node_t* ss_obtree_select(ss_obtree_t* t, size_t k)
+{
+    ss_obtree_node_t* node = t->root;
+    while (node)
     {
-        return SS_FALSE;
+        size_t left = _ss_obtree_count(node->left);
+        if (k < left)
+        {
+            node = node->left;
+        }
+        else if (k == left)
+        {
+            return node;
+        }
+        else
+        {
+            k -= left + 1;
+            node = node->right;
+        }
     }
-    int depth = 0;
-    return _ss_obtree_postorder(t, t->root, &depth, it, param);
+    return NULL;
 }
 
-/*
-ss_bool_t ss_obtree_left_iterate(ss_obtree_t* t, ss_obtree_iterate_cb_f it){
+size_t ss_obtree_rank(ss_obtree_t* t, const void* key, size_t ksize)
+{
+    size_t khash = _ss_obtree_key_hash(t, key, ksize);
+    ss_obtree_node_t* node = t->root;
+    size_t rank = 0;
+    while (node)
+    {
+        if (_ss_obtree_node_compare(t, node, key, ksize, khash) > 0)
+        {
+            rank += _ss_obtree_count(node->left) + 1;
+            node = node->right;
+        }
+        else
+        {
+            node = node->left;
+        }
+    }
+    return rank;
+}
 
+void ss_obtree_cursor_init(ss_obtree_cursor_t* c, ss_obtree_t* t)
+{
+    c->tree = t;
+    c->node = NULL;
+}
 
+ss_bool_t ss_obtree_cursor_first(ss_obtree_cursor_t* c)
+{
+    c->node = ss_obtree_first(c->tree);
+    return c->node != NULL;
 }
 
+ss_bool_t ss_obtree_cursor_last(ss_obtree_cursor_t* c)
+{
+    c->node = ss_obtree_last(c->tree);
+    return c->node != NULL;
+}
 
-ss_bool_t ss_obtree_right_iterate(ss_obtree_t* t, ss_obtree_iterate_cb_f it){
+ss_bool_t ss_obtree_cursor_seek(ss_obtree_cursor_t* c, const void* key, size_t ksize)
+{
+    c->node = ss_obtree_lower_bound(c->tree, key, ksize);
+    return c->node != NULL;
+}
 
+ss_bool_t ss_obtree_cursor_next(ss_obtree_cursor_t* c)
+{
+    c->node = c->node ? ss_obtree_next(c->node) : NULL;
+    return c->node != NULL;
 }
-*/
 
-ss_bool_t _ss_obtree_clear_iterate_cb(ss_obtree_t* t, ss_obtree_node_t* node, int depth,
-                                      void* param)
+ss_bool_t ss_obtree_cursor_prev(ss_obtree_cursor_t* c)
 {
-    (void)t;
-    (void)depth;
-    (void)param;
-    _ss_obtree_node_free(node);
-    return SS_TRUE;
+    c->node = c->node ? ss_obtree_prev(c->node) : NULL;
+    return c->node != NULL;
+}
+
+ss_bool_t ss_obtree_range(ss_obtree_t* t, const void* lo, size_t losize, const void* hi,
+                          size_t hisize, ss_obtree_iterate_cb_f it, void* param)
+{
+    ss_obtree_node_t* node = lo ? ss_obtree_lower_bound(t, lo, losize) : ss_obtree_first(t);
+    while (node)
+    {
+        if (hi && t->key_compare(node->entry.key, node->entry.ksize, hi, hisize) >= 0)
+        {
+            break;
+        }
+        // Fetch the successor first so the callback may remove the node
+        ss_obtree_node_t* next = ss_obtree_next(node);
+        if (it(t, node, 0, param))
+        {
+            return SS_TRUE;
+        }
+        node = next;
+    }
+    return SS_FALSE;
+}
+
+/* Traversals walk parent pointers with O(1) extra space, tracking the depth on each step */
+
+ss_bool_t ss_obtree_preorder(ss_obtree_t* t, ss_obtree_iterate_cb_f it, void* param)
+{
+    ss_obtree_node_t* node = t->root;
+    int depth = 0;
+    while (node)
+    {
+        if (it(t, node, depth, param))
+        {
+            return SS_TRUE;
+        }
+        if (node->left || node->right)
+        {
+            node = node->left ? node->left : node->right;
+            depth++;
+            continue;
+        }
+        // Climb to the nearest ancestor with an unvisited right subtree
+        while (node->parent && (node == node->parent->right || !node->parent->right))
+        {
+            node = node->parent;
+            depth--;
+        }
+        node = node->parent ? node->parent->right : NULL;
+    }
+    return SS_FALSE;
+}
+
+ss_bool_t ss_obtree_inorder(ss_obtree_t* t, ss_obtree_iterate_cb_f it, void* param)
+{
+    ss_obtree_node_t* node = t->root;
+    int depth = 0;
+    while (node && node->left)
+    {
+        node = node->left;
+        depth++;
+    }
+    while (node)
+    {
+        if (it(t, node, depth, param))
+        {
+            return SS_TRUE;
+        }
+        if (node->right)
+        {
+            node = node->right;
+            depth++;
+            while (node->left)
+            {
+                node = node->left;
+                depth++;
+            }
+            continue;
+        }
+        while (node->parent && node == node->parent->right)
+        {
+            node = node->parent;
+            depth--;
+        }
+        node = node->parent;
+        depth--;
+    }
+    return SS_FALSE;
+}
+
+// Deepest first node in post-order below node, preferring left children
+static ss_obtree_node_t* _ss_obtree_postorder_first(ss_obtree_node_t* node, int* depth)
+{
+    while (node->left || node->right)
+    {
+        node = node->left ? node->left : node->right;
+        (*depth)++;
+    }
+    return node;
+}
+
+ss_bool_t ss_obtree_postorder(ss_obtree_t* t, ss_obtree_iterate_cb_f it, void* param)
+{
+    int depth = 0;
+    ss_obtree_node_t* node = t->root ? _ss_obtree_postorder_first(t->root, &depth) : NULL;
+    while (node)
+    {
+        // Step before the callback, which may free the node
+        ss_obtree_node_t* parent = node->parent;
+        ss_obtree_node_t* next = parent;
+        int next_depth = depth - 1;
+        if (parent && node == parent->left && parent->right)
+        {
+            next_depth = depth;
+            next = _ss_obtree_postorder_first(parent->right, &next_depth);
+        }
+        if (it(t, node, depth, param))
+        {
+            return SS_TRUE;
+        }
+        node = next;
+        depth = next_depth;
+    }
+    return SS_FALSE;
 }
 
 void ss_obtree_clear(ss_obtree_t* t)
 {
-    ss_obtree_postorder(t, _ss_obtree_clear_iterate_cb, NULL);
+    ss_obtree_node_t* node = t->root;
+    // Free leaves bottom-up, unlinking each from its parent
+    while (node)
+    {
+        if (node->left || node->right)
+        {
+            node = node->left ? node->left : node->right;
+            continue;
+        }
+        ss_obtree_node_t* parent = node->parent;
+        if (parent)
+        {
+            if (parent->left == node)
+            {
+                parent->left = NULL;
+            }
+            else
+            {
+                parent->right = NULL;
+            }
+        }
+        _ss_obtree_node_free(t, node);
+        node = parent;
+    }
+    if (t->block)
+    {
+        _ss_obtree_block_free(t);
+    }
     t->root = NULL;
     t->size = 0;
 }
 
 void ss_obtree_destroy(ss_obtree_t* t) { ss_obtree_clear(t); }
+
+ss_bool_t _ss_obtree_stats_iterate_cb(ss_obtree_t* t, ss_obtree_node_t* node, int depth,
+                                      void* param)
+{
+    ss_obtree_stats_t* stats = (ss_obtree_stats_t*)param;
+    size_t level = (size_t)depth + 1;
+    if (level > stats->height)
+    {
+        stats->height = level;
+    }
+    stats->mean_depth += (double)level;
+    stats->depth_histogram[SS_MIN((size_t)depth, SS_OBTREE_DEPTH_HISTOGRAM_SIZE - 1)]++;
+    stats->bytes += sizeof(ss_obtree_node_t);
+    // Borrowed keys and values belong to the caller
+    if (!(t->borrow & SS_BORROW_KEY))
+    {
+        stats->bytes += node->entry.ksize;
+    }
+    if (!(t->borrow & SS_BORROW_VALUE))
+    {
+        stats->bytes += node->entry.vsize;
+    }
+    return SS_FALSE;
+}
+
+void ss_obtree_stats(ss_obtree_t* t, ss_obtree_stats_t* stats)
+{
+    memset(stats, 0, sizeof(ss_obtree_stats_t));
+    stats->size = t->size;
+    stats->bytes = sizeof(ss_obtree_t);
+    ss_obtree_preorder(t, _ss_obtree_stats_iterate_cb, stats);
+    if (t->size > 0)
+    {
+        stats->mean_depth /= (double)t->size;
+    }
+}
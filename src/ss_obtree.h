@@ -6,6 +6,13 @@
  *
  * Implements an ordered binary tree structure with key-value pairs.
  * Supports insertion, deletion and various traversal methods.
+ * The tree is kept AVL-balanced, so lookups, insertions and removals are O(log n)
+ * even for monotonic hashes or insert/remove churn.
+ *
+ * Trees created by ss_obtree_init() order nodes by key hash and then by key_compare,
+ * which suits hash buckets but not range scans. Trees created by ss_obtree_init_sorted()
+ * order by key_compare alone, so inorder traversal, the bounds and ss_obtree_range()
+ * visit keys in sorted order; the khash arguments of the *2 calls are then ignored.
  */
 
 #ifndef SS_OBTREE_H
@@ -13,6 +20,8 @@
 
 #include "ss_types.h"
 
+#include "ss_alloc.h"
+
 /**
  * @struct ss_obtree_s
  * @brief Ordered binary tree container structure
@@ -21,6 +30,11 @@
  * @var size Total number of nodes in the tree
  * @var hash Hash function for key hashing
  * @var compare Key comparison function
+ * @var borrow SS_BORROW_KEY / SS_BORROW_VALUE ownership flags
+ * @var key_free Destructor for borrowed keys (may be NULL)
+ * @var val_free Destructor for borrowed values (may be NULL)
+ * @var block Node array of ss_obtree_build_sorted(), freed when the tree empties
+ * @var block_size Number of nodes in block
  */
 
 struct ss_obtree_s
@@ -31,6 +45,13 @@ struct ss_obtree_s
     ss_hash_f key_hash;
     ss_compare_f key_compare;
     ss_compare_f val_compare; // 可以为空，如果为空，ss_obtree_set操作时将不会比较值是否相等
+
+    unsigned int borrow;
+    ss_free_f key_free;
+    ss_free_f val_free;
+
+    ss_obtree_node_t* block;
+    size_t block_size;
 };
 
 struct ss_obtree_node_s
@@ -40,6 +61,43 @@ struct ss_obtree_node_s
     ss_obtree_node_t* right;
     ss_entry_t entry;
     size_t khash;
+    int height;   // Levels in the subtree rooted here, 1 for a leaf
+    size_t count; // Nodes in the subtree rooted here, including this one
+};
+
+/* Number of depth histogram bins, the last bin also counts everything deeper */
+#define SS_OBTREE_DEPTH_HISTOGRAM_SIZE 16
+
+/**
+ * @struct ss_obtree_stats_s
+ * @brief Tree shape statistics
+ *
+ * @var size Number of nodes
+ * @var height Number of levels (0 for an empty tree)
+ * @var mean_depth Mean node depth, i.e. comparisons per successful lookup (root = 1)
+ * @var depth_histogram Node count per depth, index 0 holds the root
+ * @var bytes Tree structure, nodes, owned keys and owned values
+ */
+struct ss_obtree_stats_s
+{
+    size_t size;
+    size_t height;
+    double mean_depth;
+    size_t depth_histogram[SS_OBTREE_DEPTH_HISTOGRAM_SIZE];
+    size_t bytes;
+};
+
+/**
+ * @struct ss_obtree_cursor_s
+ * @brief In-order position in a tree, NULL node once stepped past either end
+ *
+ * A cursor survives removals of other nodes, since removal moves nodes instead of
+ * copying entries; removing the node under the cursor invalidates it.
+ */
+struct ss_obtree_cursor_s
+{
+    ss_obtree_t* tree;
+    ss_obtree_node_t* node;
 };
 
 /* If returns true, stop the traversal */
@@ -50,6 +108,28 @@ void ss_obtree_init(ss_obtree_t* t, ss_hash_f key_hash, ss_compare_f key_compare
                     ss_compare_f val_compare);
 void ss_obtree_destroy(ss_obtree_t* t);
 
+/**
+ * @brief Initialize a sorted-map tree ordered by key_compare alone
+ * @param[in] t Tree pointer
+ * @param[in] key_compare Total order on keys
+ * @param[in] val_compare Optional value comparison (may be NULL)
+ */
+void ss_obtree_init_sorted(ss_obtree_t* t, ss_compare_f key_compare, ss_compare_f val_compare);
+
+/**
+ * @brief Store caller-owned key and/or value pointers verbatim instead of copies
+ * @param[in] t Tree pointer, must be empty
+ * @param[in] borrow Combination of SS_BORROW_KEY and SS_BORROW_VALUE
+ * @param[in] key_free Called on a borrowed key when its node is removed or the key
+ *            pointer is replaced by a later set (may be NULL)
+ * @param[in] val_free Called on a borrowed value when its node is removed or the value
+ *            pointer is replaced by a later set (may be NULL)
+ * @note Borrowed pointers must stay valid until released through the destructors
+ *       (or until removal when no destructor is given)
+ */
+void ss_obtree_set_borrow(ss_obtree_t* t, unsigned int borrow, ss_free_f key_free,
+                          ss_free_f val_free);
+
 ss_obtree_node_t* ss_obtree_set(ss_obtree_t* t, const void* key, size_t ksize, const void* data,
                                 size_t dsize);
 ss_obtree_node_t* ss_obtree_set2(ss_obtree_t* t, const void* key, size_t ksize, size_t khash,
@@ -61,6 +141,46 @@ ss_bool_t ss_obtree_remove2(ss_obtree_t* t, const void* key, size_t ksize, size_
 
 ss_bool_t ss_obtree_node_remove(ss_obtree_t* t, ss_obtree_node_t* node);
 
+/**
+ * @brief Fill an empty tree with a perfectly balanced tree in O(n)
+ * @param[in] entries Entries strictly ascending in tree order: by key in sorted mode,
+ *            by hash and then key otherwise (as an in-order traversal yields them)
+ * @param[in] n Number of entries
+ * @return SS_FALSE if the tree is not empty, the entries are out of order or allocation
+ *         failed (the tree is left empty)
+ * @note All nodes come from one contiguous block. Removed block nodes are not returned
+ *       to the allocator until the tree becomes empty or is cleared
+ */
+ss_bool_t ss_obtree_build_sorted(ss_obtree_t* t, const ss_entry_t* entries, size_t n);
+
+/**
+ * @brief Move every node not ordered before key into right, in O(log n)
+ * @param[out] right Empty tree; receives t's order and ownership settings
+ * @return SS_FALSE if right is not empty or allocation failed (t is unchanged)
+ * @note A tree filled by ss_obtree_build_sorted() first moves its nodes out of the
+ *       block, once, in O(n)
+ */
+ss_bool_t ss_obtree_split(ss_obtree_t* t, const void* key, size_t ksize, ss_obtree_t* right);
+
+/**
+ * @brief Append every node of right to t in O(log n), leaving right empty
+ * @return SS_FALSE if the trees differ in order or ownership settings, or a node of
+ *         right is not ordered after every node of t (both are then unchanged)
+ */
+ss_bool_t ss_obtree_join(ss_obtree_t* t, ss_obtree_t* right);
+
+/**
+ * @brief Move every node of other into t, leaving other empty
+ * @return SS_FALSE if the trees differ in order or ownership settings
+ * @note O(m log(n / m + 1)) for the smaller size m; nodes are relinked, not copied.
+ *       Where both trees hold a key, t keeps its entry and other's node is freed
+ */
+ss_bool_t ss_obtree_merge(ss_obtree_t* t, ss_obtree_t* other);
+
+/* Traversals are iterative and need O(1) extra space. Callbacks must not remove nodes,
+ * since removal rebalances the tree under the walk. The post-order callback alone may
+ * free the node it is given without unlinking it, as ss_obtree_clear() does; the tree
+ * must then be initialized again before any other use */
 ss_bool_t ss_obtree_preorder(ss_obtree_t* t, ss_obtree_iterate_cb_f it,
                              void* param); // Preorder traversal
 ss_bool_t ss_obtree_inorder(ss_obtree_t* t, ss_obtree_iterate_cb_f it,
@@ -68,6 +188,70 @@ ss_bool_t ss_obtree_inorder(ss_obtree_t* t, ss_obtree_iterate_cb_f it,
 ss_bool_t ss_obtree_postorder(ss_obtree_t* t, ss_obtree_iterate_cb_f it,
                               void* param); // Postorder traversal
 
+/* Smallest and largest nodes, NULL for an empty tree */
+ss_obtree_node_t* ss_obtree_first(ss_obtree_t* t);
+ss_obtree_node_t* ss_obtree_last(ss_obtree_t* t);
+
+/* In-order successor and predecessor in O(1) amortized, NULL past either end */
+ss_obtree_node_t* ss_obtree_next(ss_obtree_node_t* node);
+ss_obtree_node_t* ss_obtree_prev(ss_obtree_node_t* node);
+
+/**
+ * @brief Cursor stepping in-order without callbacks, O(1) amortized per step
+ * @note first/last/seek/next/prev return SS_FALSE when the cursor ends up on no node
+ */
+void ss_obtree_cursor_init(ss_obtree_cursor_t* c, ss_obtree_t* t);
+ss_bool_t ss_obtree_cursor_first(ss_obtree_cursor_t* c);
+ss_bool_t ss_obtree_cursor_last(ss_obtree_cursor_t* c);
+// Moves to the first node not ordered before key, as ss_obtree_lower_bound()
+ss_bool_t ss_obtree_cursor_seek(ss_obtree_cursor_t* c, const void* key, size_t ksize);
+ss_bool_t ss_obtree_cursor_next(ss_obtree_cursor_t* c);
+ss_bool_t ss_obtree_cursor_prev(ss_obtree_cursor_t* c);
+
+#define ss_obtree_cursor_node(c) ((c)->node)
+
+/**
+ * @brief First node not ordered before key; in sorted mode the first key not less than key
+ * @return Node, or NULL if every key is less
+ */
+ss_obtree_node_t* ss_obtree_lower_bound(ss_obtree_t* t, const void* key, size_t ksize);
+
+/**
+ * @brief First node ordered after key; in sorted mode the first key greater than key
+ * @return Node, or NULL if no key is greater
+ */
+ss_obtree_node_t* ss_obtree_upper_bound(ss_obtree_t* t, const void* key, size_t ksize);
+
+/**
+ * @brief Node at in-order position k, counting from 0, in O(log n)
+ * @return Node, or NULL if k >= size; in sorted mode k = size / 2 is the median
+ */
+ss_obtree_node_t* ss_obtree_select(ss_obtree_t* t, size_t k);
+
+/**
+ * @brief Number of nodes ordered before key in O(log n), whether or not key is present
+ * @note In sorted mode this is the count of smaller keys, the inverse of ss_obtree_select()
+ */
+size_t ss_obtree_rank(ss_obtree_t* t, const void* key, size_t ksize);
+
+/**
+ * @brief Visit the keys in [lo, hi) in ascending order (sorted mode), O(log n + k)
+ * @param[in] lo Inclusive lower key, NULL to start at the first node
+ * @param[in] hi Exclusive upper key, NULL to run to the last node
+ * @param[in] it Callback, receives depth 0; it may remove the node it is given
+ * @return SS_TRUE if the callback stopped the scan
+ */
+ss_bool_t ss_obtree_range(ss_obtree_t* t, const void* lo, size_t losize, const void* hi,
+                          size_t hisize, ss_obtree_iterate_cb_f it, void* param);
+
 void ss_obtree_clear(ss_obtree_t* t);
 
+/**
+ * @brief Collect tree shape statistics
+ * @param[in] t Tree pointer
+ * @param[out] stats Receives the statistics
+ * @note O(n); intended for periodic diagnostics, not hot paths
+ */
+void ss_obtree_stats(ss_obtree_t* t, ss_obtree_stats_t* stats);
+
 #endif /* SS_OBTREE_H */
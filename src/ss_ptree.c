@@ -0,0 +1,343 @@
+#include "ss_alloc.h"
+#include "ss_atomic.h"
+#include "ss_ptree.h"
+
+#include <string.h>
+
+#define _ss_ptree_align(n) (((n) + SS_PTR_SIZE - 1) & ~(SS_PTR_SIZE - 1))
+
+#define _ss_ptree_height(node) ((node) ? (node)->height : 0)
+
+static void _ss_ptree_lock(ss_ptree_t* t)
+{
+    int expected = 0;
+    while (!ss_atomic_cas(&t->lock, &expected, 1))
+    {
+        expected = 0;
+    }
+}
+
+#define _ss_ptree_unlock(t) ss_atomic_store(&(t)->lock, 0)
+
+static void _ss_ptree_retain(ss_ptree_node_t* node)
+{
+    if (node)
+    {
+        ss_atomic_fetch_add(&node->refs, (size_t)1);
+    }
+}
+
+// Drop one reference; a node losing its last one frees itself and drops its children's
+static void _ss_ptree_release(ss_ptree_node_t* node)
+{
+    while (node && ss_atomic_fetch_sub(&node->refs, (size_t)1) == 1)
+    {
+        ss_ptree_node_t* right = node->right;
+        _ss_ptree_release(node->left);
+        ss_free(node);
+        node = right;
+    }
+}
+
+// New node holding its own reference to each child; the caller owns the returned one
+static ss_ptree_node_t* _ss_ptree_node_new(const void* key, size_t ksize, const void* value,
+                                           size_t vsize, ss_ptree_node_t* left,
+                                           ss_ptree_node_t* right)
+{
+    size_t voff = _ss_ptree_align(ksize);
+    ss_ptree_node_t* node = (ss_ptree_node_t*)ss_malloc(sizeof(ss_ptree_node_t) + voff + vsize);
+    if (!node)
+    {
+        return NULL;
+    }
+    node->left = left;
+    node->right = right;
+    node->refs = 1;
+    node->height = SS_MAX(_ss_ptree_height(left), _ss_ptree_height(right)) + 1;
+    node->entry.key = node + 1;
+    node->entry.ksize = ksize;
+    node->entry.value = (unsigned char*)(node + 1) + voff;
+    node->entry.vsize = vsize;
+    if (ksize)
+    {
+        memcpy(node->entry.key, key, ksize);
+    }
+    if (vsize)
+    {
+        memcpy(node->entry.value, value, vsize);
+    }
+    _ss_ptree_retain(left);
+    _ss_ptree_retain(right);
+    return node;
+}
+
+#define _ss_ptree_node_copy(src, left, right)                                                      \
+    _ss_ptree_node_new((src)->entry.key, (src)->entry.ksize, (src)->entry.value,                  \
+                       (src)->entry.vsize, left, right)
+
+// New node with src's entry over two borrowed subtrees whose heights differ by at most 2,
+// rotating copies of the taller side when they differ by 2
+static ss_ptree_node_t* _ss_ptree_balance(const ss_ptree_node_t* src, ss_ptree_node_t* left,
+                                          ss_ptree_node_t* right)
+{
+    ss_ptree_node_t *inner, *outer, *result;
+    int lh = _ss_ptree_height(left);
+    int rh = _ss_ptree_height(right);
+
+    if (lh > rh + 1)
+    {
+        if (_ss_ptree_height(left->left) >= _ss_ptree_height(left->right))
+        {
+            inner = _ss_ptree_node_copy(src, left->right, right);
+            result = inner ? _ss_ptree_node_copy(left, left->left, inner) : NULL;
+            _ss_ptree_release(inner);
+            return result;
+        }
+        outer = _ss_ptree_node_copy(left, left->left, left->right->left);
+        inner = _ss_ptree_node_copy(src, left->right->right, right);
+        result = outer && inner ? _ss_ptree_node_copy(left->right, outer, inner) : NULL;
+        _ss_ptree_release(outer);
+        _ss_ptree_release(inner);
+        return result;
+    }
+    if (rh > lh + 1)
+    {
+        if (_ss_ptree_height(right->right) >= _ss_ptree_height(right->left))
+        {
+            inner = _ss_ptree_node_copy(src, left, right->left);
+            result = inner ? _ss_ptree_node_copy(right, inner, right->right) : NULL;
+            _ss_ptree_release(inner);
+            return result;
+        }
+        inner = _ss_ptree_node_copy(src, left, right->left->left);
+        outer = _ss_ptree_node_copy(right, right->left->right, right->right);
+        result = outer && inner ? _ss_ptree_node_copy(right->left, inner, outer) : NULL;
+        _ss_ptree_release(outer);
+        _ss_ptree_release(inner);
+        return result;
+    }
+    return _ss_ptree_node_copy(src, left, right);
+}
+
+// Copy of the subtree with key set; NULL on allocation failure
+static ss_ptree_node_t* _ss_ptree_set(ss_ptree_t* t, ss_ptree_node_t* node, const void* key,
+                                      size_t ksize, const void* value, size_t vsize,
+                                      ss_bool_t* added)
+{
+    if (!node)
+    {
+        *added = SS_TRUE;
+        return _ss_ptree_node_new(key, ksize, value, vsize, NULL, NULL);
+    }
+
+    int c = t->key_compare(key, ksize, node->entry.key, node->entry.ksize);
+    if (c == 0)
+    {
+        return _ss_ptree_node_new(key, ksize, value, vsize, node->left, node->right);
+    }
+
+    ss_ptree_node_t* child =
+        _ss_ptree_set(t, c < 0 ? node->left : node->right, key, ksize, value, vsize, added);
+    if (!child)
+    {
+        return NULL;
+    }
+    ss_ptree_node_t* result = c < 0 ? _ss_ptree_balance(node, child, node->right)
+                                    : _ss_ptree_balance(node, node->left, child);
+    _ss_ptree_release(child);
+    return result;
+}
+
+// Copy of the subtree without key, possibly NULL when it empties; *status is 1 when
+// removed, 0 when absent and -1 on allocation failure
+static ss_ptree_node_t* _ss_ptree_remove(ss_ptree_t* t, ss_ptree_node_t* node, const void* key,
+                                         size_t ksize, int* status)
+{
+    ss_ptree_node_t *child, *result;
+
+    if (!node)
+    {
+        *status = 0;
+        return NULL;
+    }
+
+    int c = t->key_compare(key, ksize, node->entry.key, node->entry.ksize);
+    if (c == 0)
+    {
+        *status = 1;
+        if (!node->left || !node->right)
+        {
+            child = node->left ? node->left : node->right;
+            _ss_ptree_retain(child);
+            return child;
+        }
+        // Two children: the successor's entry takes this node's place
+        const ss_ptree_node_t* next = node->right;
+        while (next->left)
+        {
+            next = next->left;
+        }
+        child = _ss_ptree_remove(t, node->right, next->entry.key, next->entry.ksize, status);
+        if (*status != 1)
+        {
+            return NULL;
+        }
+        result = _ss_ptree_balance(next, node->left, child);
+    }
+    else
+    {
+        child = _ss_ptree_remove(t, c < 0 ? node->left : node->right, key, ksize, status);
+        if (*status != 1)
+        {
+            return NULL;
+        }
+        result = c < 0 ? _ss_ptree_balance(node, child, node->right)
+                       : _ss_ptree_balance(node, node->left, child);
+    }
+    _ss_ptree_release(child);
+    if (!result)
+    {
+        *status = -1;
+    }
+    return result;
+}
+
+// Swap in a new version and drop the tree's reference to the old one
+static void _ss_ptree_publish(ss_ptree_t* t, ss_ptree_node_t* root, size_t size)
+{
+    _ss_ptree_lock(t);
+    ss_ptree_node_t* old = t->root;
+    t->root = root;
+    t->size = size;
+    _ss_ptree_unlock(t);
+    _ss_ptree_release(old);
+}
+
+static const ss_entry_t* _ss_ptree_find(const ss_ptree_node_t* node, ss_compare_f key_compare,
+                                        const void* key, size_t ksize)
+{
+    while (node)
+    {
+        int c = key_compare(key, ksize, node->entry.key, node->entry.ksize);
+        if (c == 0)
+        {
+            return &node->entry;
+        }
+        node = c < 0 ? node->left : node->right;
+    }
+    return NULL;
+}
+
+// In-order walk pruned to [lo, hi), recursion depth bounded by the AVL height
+static ss_bool_t _ss_ptree_range(const ss_ptree_snapshot_t* s, const ss_ptree_node_t* node,
+                                 const void* lo, size_t losize, const void* hi, size_t hisize,
+                                 ss_ptree_iterate_cb_f cb, void* param)
+{
+    while (node)
+    {
+        const ss_entry_t* e = &node->entry;
+        if (lo && s->key_compare(e->key, e->ksize, lo, losize) < 0)
+        {
+            node = node->right;
+            continue;
+        }
+        if (hi && s->key_compare(e->key, e->ksize, hi, hisize) >= 0)
+        {
+            node = node->left;
+            continue;
+        }
+        if (_ss_ptree_range(s, node->left, lo, losize, NULL, 0, cb, param) || cb(s, e, param))
+        {
+            return SS_TRUE;
+        }
+        // Everything on the right is above lo
+        lo = NULL;
+        node = node->right;
+    }
+    return SS_FALSE;
+}
+
+void ss_ptree_init(ss_ptree_t* t, ss_compare_f key_compare)
+{
+    t->root = NULL;
+    t->size = 0;
+    t->key_compare = key_compare;
+    t->lock = 0;
+}
+
+void ss_ptree_destroy(ss_ptree_t* t)
+{
+    ss_ptree_clear(t);
+}
+
+ss_bool_t ss_ptree_set(ss_ptree_t* t, const void* key, size_t ksize, const void* value,
+                       size_t vsize)
+{
+    ss_bool_t added = SS_FALSE;
+    ss_ptree_node_t* root = _ss_ptree_set(t, t->root, key, ksize, value, vsize, &added);
+    if (!root)
+    {
+        return SS_FALSE;
+    }
+    _ss_ptree_publish(t, root, t->size + (added ? 1 : 0));
+    return SS_TRUE;
+}
+
+ss_bool_t ss_ptree_remove(ss_ptree_t* t, const void* key, size_t ksize)
+{
+    int status = 0;
+    ss_ptree_node_t* root = _ss_ptree_remove(t, t->root, key, ksize, &status);
+    if (status != 1)
+    {
+        return SS_FALSE;
+    }
+    _ss_ptree_publish(t, root, t->size - 1);
+    return SS_TRUE;
+}
+
+const ss_entry_t* ss_ptree_get(ss_ptree_t* t, const void* key, size_t ksize)
+{
+    return _ss_ptree_find(t->root, t->key_compare, key, ksize);
+}
+
+void ss_ptree_clear(ss_ptree_t* t)
+{
+    _ss_ptree_publish(t, NULL, 0);
+}
+
+void ss_ptree_snapshot(ss_ptree_t* t, ss_ptree_snapshot_t* s)
+{
+    // The lock keeps the writer from dropping the root between the load and the retain
+    _ss_ptree_lock(t);
+    s->root = t->root;
+    s->size = t->size;
+    _ss_ptree_retain(s->root);
+    _ss_ptree_unlock(t);
+    s->key_compare = t->key_compare;
+}
+
+void ss_ptree_snapshot_release(ss_ptree_snapshot_t* s)
+{
+    _ss_ptree_release(s->root);
+    s->root = NULL;
+    s->size = 0;
+}
+
+const ss_entry_t* ss_ptree_snapshot_get(const ss_ptree_snapshot_t* s, const void* key,
+                                        size_t ksize)
+{
+    return _ss_ptree_find(s->root, s->key_compare, key, ksize);
+}
+
+ss_bool_t ss_ptree_snapshot_range(const ss_ptree_snapshot_t* s, const void* lo, size_t losize,
+                                  const void* hi, size_t hisize, ss_ptree_iterate_cb_f cb,
+                                  void* param)
+{
+    return _ss_ptree_range(s, s->root, lo, losize, hi, hisize, cb, param);
+}
+
+ss_bool_t ss_ptree_snapshot_iterate(const ss_ptree_snapshot_t* s, ss_ptree_iterate_cb_f cb,
+                                    void* param)
+{
+    return _ss_ptree_range(s, s->root, NULL, 0, NULL, 0, cb, param);
+}
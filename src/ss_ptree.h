@@ -0,0 +1,140 @@
+/**
+ * @file ss_ptree.h
+ * @brief Persistent ordered tree with O(1) snapshots
+ * @author trywen@qq.com
+ * @date 2026-10-18
+ *
+ * AVL-balanced sorted map built by path copying. Features include:
+ * - Updates copy only the O(log n) nodes on the search path and share the rest
+ * - Every published version is immutable, so a snapshot is one reference count increment
+ * - Snapshots stay readable after later updates and after the tree is destroyed
+ * - Shared subtrees are reference-counted and freed when the last version drops them
+ *
+ * One writer at a time updates the tree; the caller serializes writers. Snapshots may
+ * be taken and read from any thread while the writer runs: the writer builds the new
+ * version without holding anything and takes a short spin lock only to swap the root,
+ * so readers never block it for longer than a pointer load.
+ *
+ * Nodes have no parent pointers, which would tie a node to a single version; this is
+ * why ss_obtree cannot share subtrees and this tree exists beside it.
+ */
+
+#ifndef SS_PTREE_H
+#define SS_PTREE_H
+
+#include "ss_types.h"
+
+/**
+ * @struct ss_ptree_node_s
+ * @brief Immutable node, followed by the key bytes and the value bytes
+ */
+struct ss_ptree_node_s
+{
+    ss_ptree_node_t* left;
+    ss_ptree_node_t* right;
+    size_t refs; // Parent nodes, roots and snapshots holding this node
+    int height;  // Levels in the subtree rooted here, 1 for a leaf
+    ss_entry_t entry;
+};
+
+/**
+ * @struct ss_ptree_s
+ * @brief Persistent tree handle, owns a reference to the current version
+ *
+ * @var root Root of the current version, NULL when empty
+ * @var size Number of entries in the current version
+ * @var key_compare Total order on keys
+ * @var lock Guards root and size against concurrent snapshots
+ */
+struct ss_ptree_s
+{
+    ss_ptree_node_t* root;
+    size_t size;
+    ss_compare_f key_compare;
+    int lock;
+};
+
+/**
+ * @struct ss_ptree_snapshot_s
+ * @brief One version of a tree, readable until ss_ptree_snapshot_release()
+ */
+struct ss_ptree_snapshot_s
+{
+    ss_ptree_node_t* root;
+    size_t size;
+    ss_compare_f key_compare;
+};
+
+/* If returns true, iteration will stop. The entry belongs to the snapshot */
+typedef ss_bool_t (*ss_ptree_iterate_cb_f)(const ss_ptree_snapshot_t* s, const ss_entry_t* entry,
+                                           void* param);
+
+void ss_ptree_init(ss_ptree_t* t, ss_compare_f key_compare);
+
+/**
+ * @brief Drop the current version
+ * @note Outstanding snapshots stay valid and free their nodes when released
+ */
+void ss_ptree_destroy(ss_ptree_t* t);
+
+/**
+ * @brief Insert or replace a key-value pair, publishing a new version
+ * @param[in] key Copied into the new node
+ * @param[in] value Copied into the new node (may be NULL when vsize is 0)
+ * @return SS_FALSE on allocation failure, the current version is then unchanged
+ */
+ss_bool_t ss_ptree_set(ss_ptree_t* t, const void* key, size_t ksize, const void* value,
+                       size_t vsize);
+
+/**
+ * @brief Remove a key, publishing a new version
+ * @return SS_FALSE if the key is absent or allocation failed (nothing is published)
+ */
+ss_bool_t ss_ptree_remove(ss_ptree_t* t, const void* key, size_t ksize);
+
+/**
+ * @brief Look up a key in the current version
+ * @return Entry owned by the tree, NULL if not found
+ * @note Writer thread only; valid until the next update. Other threads read snapshots
+ */
+const ss_entry_t* ss_ptree_get(ss_ptree_t* t, const void* key, size_t ksize);
+
+/* Drop all entries, publishing an empty version */
+void ss_ptree_clear(ss_ptree_t* t);
+
+#define ss_ptree_size(t) ((t)->size)
+
+/**
+ * @brief Capture the current version in O(1)
+ * @param[out] s Snapshot, must be released with ss_ptree_snapshot_release()
+ * @note Safe to call from any thread while the writer updates the tree
+ */
+void ss_ptree_snapshot(ss_ptree_t* t, ss_ptree_snapshot_t* s);
+
+/* Release the snapshot's reference, freeing nodes no other version shares */
+void ss_ptree_snapshot_release(ss_ptree_snapshot_t* s);
+
+/**
+ * @brief Look up a key in a snapshot
+ * @return Entry owned by the snapshot, NULL if not found
+ */
+const ss_entry_t* ss_ptree_snapshot_get(const ss_ptree_snapshot_t* s, const void* key,
+                                        size_t ksize);
+
+/**
+ * @brief Visit the keys in [lo, hi) in ascending order, O(log n + k)
+ * @param[in] lo Inclusive lower key, NULL to start at the first entry
+ * @param[in] hi Exclusive upper key, NULL to run to the last entry
+ * @return SS_TRUE if the callback stopped the scan
+ */
+ss_bool_t ss_ptree_snapshot_range(const ss_ptree_snapshot_t* s, const void* lo, size_t losize,
+                                  const void* hi, size_t hisize, ss_ptree_iterate_cb_f cb,
+                                  void* param);
+
+// param: user data for callback. Returns TRUE to stop iteration
+ss_bool_t ss_ptree_snapshot_iterate(const ss_ptree_snapshot_t* s, ss_ptree_iterate_cb_f cb,
+                                    void* param);
+
+#define ss_ptree_snapshot_size(s) ((s)->size)
+
+#endif /* SS_PTREE_H */
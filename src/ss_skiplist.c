@@ -0,0 +1,519 @@
+#include "ss_alloc.h"
+#include "ss_atomic.h"
+#include "ss_skiplist.h"
+
+#include <string.h>
+
+#define _ss_skiplist_align(n) (((n) + SS_PTR_SIZE - 1) & ~(SS_PTR_SIZE - 1))
+
+#define _ss_skiplist_marked(p) ((p) & (uintptr_t)1)
+#define _ss_skiplist_ptr(p) ((ss_skiplist_node_t*)((p) & ~(uintptr_t)1))
+
+// Node order against a search key, the head sentinel is never compared
+#define _ss_skiplist_compare(sl, node, k, n)                                                       \
+    (sl)->key_compare((node)->entry.key, (node)->entry.ksize, k, n)
+
+static ss_skiplist_node_t* _ss_skiplist_node_new(const void* key, size_t ksize, const void* value,
+                                                 size_t vsize, uint32_t height)
+{
+    size_t koff = _ss_skiplist_align(sizeof(ss_skiplist_node_t) + height * sizeof(uintptr_t));
+    size_t voff = koff + _ss_skiplist_align(ksize);
+    ss_skiplist_node_t* node = (ss_skiplist_node_t*)ss_malloc(voff + vsize);
+    if (!node)
+    {
+        return NULL;
+    }
+    node->limbo = NULL;
+    node->entry.key = (unsigned char*)node + koff;
+    node->entry.ksize = ksize;
+    node->entry.value = (unsigned char*)node + voff;
+    node->entry.vsize = vsize;
+    node->owners = 2;
+    node->height = height;
+    memset(node->next, 0, height * sizeof(uintptr_t));
+    if (ksize)
+    {
+        memcpy(node->entry.key, key, ksize);
+    }
+    if (vsize)
+    {
+        memcpy(node->entry.value, value, vsize);
+    }
+    return node;
+}
+
+static void _ss_skiplist_free_limbo(ss_skiplist_node_t* node)
+{
+    while (node)
+    {
+        ss_skiplist_node_t* next = node->limbo;
+        ss_free(node);
+        node = next;
+    }
+}
+
+// Move the global epoch on once every pinned handle has seen the current one
+static void _ss_skiplist_try_advance(ss_skiplist_t* sl)
+{
+    size_t epoch = ss_atomic_load(&sl->epoch);
+    ss_atomic_fence();
+    for (size_t i = 0; i < SS_SKIPLIST_MAX_THREADS; i++)
+    {
+        size_t pinned = ss_atomic_load(&sl->threads[i].epoch);
+        if ((pinned & 1) && (pinned >> 1) != epoch)
+        {
+            return;
+        }
+    }
+    ss_atomic_cas(&sl->epoch, &epoch, epoch + 1);
+}
+
+static void _ss_skiplist_enter(ss_skiplist_thread_t* th)
+{
+    if (th->depth++ > 0)
+    {
+        return;
+    }
+    size_t epoch = ss_atomic_load(&th->list->epoch);
+    ss_atomic_store(&th->epoch, (epoch << 1) | 1);
+    ss_atomic_fence(); // Publish the pin before reading any node
+
+    // Nodes retired two epochs ago can no longer be reached by any pinned handle
+    for (size_t i = 0; i < 3; i++)
+    {
+        if (th->limbo[i] && th->limbo_epoch[i] + 2 <= epoch)
+        {
+            _ss_skiplist_free_limbo(th->limbo[i]);
+            th->limbo[i] = NULL;
+        }
+    }
+}
+
+static void _ss_skiplist_leave(ss_skiplist_thread_t* th)
+{
+    if (--th->depth == 0)
+    {
+        ss_atomic_store(&th->epoch, (size_t)0);
+    }
+}
+
+// Queue an unlinked node until every handle pinned when it was reachable has left
+static void _ss_skiplist_retire(ss_skiplist_thread_t* th, ss_skiplist_node_t* node)
+{
+    ss_skiplist_t* sl = th->list;
+    ss_atomic_fence();
+    size_t epoch = ss_atomic_load(&sl->epoch);
+    size_t i = epoch % 3;
+    if (th->limbo_epoch[i] != epoch)
+    {
+        // The list holds nodes from three or more epochs back
+        _ss_skiplist_free_limbo(th->limbo[i]);
+        th->limbo[i] = NULL;
+        th->limbo_epoch[i] = epoch;
+    }
+    node->limbo = th->limbo[i];
+    th->limbo[i] = node;
+    if (++th->retired % SS_SKIPLIST_RETIRE_BATCH == 0)
+    {
+        _ss_skiplist_try_advance(sl);
+    }
+}
+
+static uint32_t _ss_skiplist_random_height(ss_skiplist_thread_t* th)
+{
+    uint32_t x = th->seed; // xorshift32
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    th->seed = x;
+
+    uint32_t height = 1;
+    while ((x & 1) && height < SS_SKIPLIST_MAX_LEVEL)
+    {
+        height++;
+        x >>= 1;
+    }
+    return height;
+}
+
+// Fill preds/succs with the neighbours of key at every level, unlinking marked nodes on
+// the way; returns SS_TRUE if succs[0] holds the key
+static ss_bool_t _ss_skiplist_find(ss_skiplist_t* sl, const void* key, size_t ksize,
+                                   ss_skiplist_node_t** preds, ss_skiplist_node_t** succs)
+{
+    ss_skiplist_node_t *pred, *curr;
+    uintptr_t next;
+    int level, c = 1;
+
+retry:
+    pred = sl->head;
+    for (level = SS_SKIPLIST_MAX_LEVEL - 1; level >= 0; level--)
+    {
+        curr = _ss_skiplist_ptr(ss_atomic_load(&pred->next[level]));
+        while (curr)
+        {
+            next = ss_atomic_load(&curr->next[level]);
+            while (_ss_skiplist_marked(next))
+            {
+                uintptr_t expected = (uintptr_t)curr;
+                if (!ss_atomic_cas(&pred->next[level], &expected, next & ~(uintptr_t)1))
+                {
+                    goto retry; // pred changed or was marked itself
+                }
+                curr = _ss_skiplist_ptr(next);
+                if (!curr)
+                {
+                    break;
+                }
+                next = ss_atomic_load(&curr->next[level]);
+            }
+            if (!curr || (c = _ss_skiplist_compare(sl, curr, key, ksize)) >= 0)
+            {
+                break;
+            }
+            pred = curr;
+            curr = _ss_skiplist_ptr(next);
+        }
+        preds[level] = pred;
+        succs[level] = curr;
+    }
+    return succs[0] && c == 0;
+}
+
+// First live node not less than key, read-only; a NULL key gives the first live node
+static ss_skiplist_node_t* _ss_skiplist_seek(ss_skiplist_t* sl, const void* key, size_t ksize)
+{
+    ss_skiplist_node_t *pred = sl->head, *curr = NULL;
+    uintptr_t next;
+
+    for (int level = SS_SKIPLIST_MAX_LEVEL - 1; level >= 0; level--)
+    {
+        curr = _ss_skiplist_ptr(ss_atomic_load(&pred->next[level]));
+        while (curr)
+        {
+            next = ss_atomic_load(&curr->next[level]);
+            if (!_ss_skiplist_marked(next))
+            {
+                if (!key || _ss_skiplist_compare(sl, curr, key, ksize) >= 0)
+                {
+                    break;
+                }
+                pred = curr;
+            }
+            curr = _ss_skiplist_ptr(next);
+        }
+    }
+    return curr;
+}
+
+// Unlink a node marked at every level, matching it by identity. A search for its key is
+// not enough: an insert of the same key may have linked its new node in front of this one
+// at an upper level, so the walk goes on through every node with an equal key
+static void _ss_skiplist_unlink(ss_skiplist_t* sl, ss_skiplist_node_t* node)
+{
+    ss_skiplist_node_t *pred, *prev, *curr;
+    uintptr_t next;
+    int level;
+
+retry:
+    pred = sl->head; // Last node with a smaller key, where the next level starts
+    for (level = SS_SKIPLIST_MAX_LEVEL - 1; level >= 0; level--)
+    {
+        prev = pred;
+        curr = _ss_skiplist_ptr(ss_atomic_load(&prev->next[level]));
+        while (curr)
+        {
+            next = ss_atomic_load(&curr->next[level]);
+            if (_ss_skiplist_marked(next))
+            {
+                uintptr_t expected = (uintptr_t)curr;
+                if (!ss_atomic_cas(&prev->next[level], &expected, next & ~(uintptr_t)1))
+                {
+                    goto retry;
+                }
+                if (curr == node)
+                {
+                    break; // Gone from this level, and no one links a released node
+                }
+                curr = _ss_skiplist_ptr(next);
+                continue;
+            }
+            int c = _ss_skiplist_compare(sl, curr, node->entry.key, node->entry.ksize);
+            if (c > 0)
+            {
+                break;
+            }
+            if (c < 0)
+            {
+                pred = curr;
+            }
+            prev = curr;
+            curr = _ss_skiplist_ptr(next);
+        }
+    }
+}
+
+// Drop the inserter's or remover's claim; the last one unlinks the node for good
+static void _ss_skiplist_release(ss_skiplist_thread_t* th, ss_skiplist_node_t* node)
+{
+    if (ss_atomic_fetch_sub(&node->owners, (uint32_t)1) == 1)
+    {
+        // Marked at every level and no longer being linked, so once unlinked it is
+        // unreachable and only pinned handles may still hold it
+        _ss_skiplist_unlink(th->list, node);
+        _ss_skiplist_retire(th, node);
+    }
+}
+
+ss_bool_t ss_skiplist_init(ss_skiplist_t* sl, ss_compare_f key_compare)
+{
+    memset(sl, 0, sizeof(*sl));
+    sl->head = _ss_skiplist_node_new(NULL, 0, NULL, 0, SS_SKIPLIST_MAX_LEVEL);
+    if (!sl->head)
+    {
+        return SS_FALSE;
+    }
+    sl->key_compare = key_compare;
+    for (size_t i = 0; i < SS_SKIPLIST_MAX_THREADS; i++)
+    {
+        sl->threads[i].list = sl;
+    }
+    return SS_TRUE;
+}
+
+void ss_skiplist_destroy(ss_skiplist_t* sl)
+{
+    if (!sl->head)
+    {
+        return;
+    }
+    uintptr_t p = sl->head->next[0];
+    while (p)
+    {
+        ss_skiplist_node_t* node = _ss_skiplist_ptr(p);
+        p = node->next[0];
+        ss_free(node);
+    }
+    ss_free(sl->head);
+    sl->head = NULL;
+    for (size_t i = 0; i < SS_SKIPLIST_MAX_THREADS; i++)
+    {
+        for (size_t j = 0; j < 3; j++)
+        {
+            _ss_skiplist_free_limbo(sl->threads[i].limbo[j]);
+            sl->threads[i].limbo[j] = NULL;
+        }
+    }
+    sl->size = 0;
+}
+
+ss_skiplist_t* ss_skiplist_create(ss_compare_f key_compare)
+{
+    ss_skiplist_t* sl = (ss_skiplist_t*)ss_malloc(sizeof(ss_skiplist_t));
+    if (sl && !ss_skiplist_init(sl, key_compare))
+    {
+        ss_free(sl);
+        return NULL;
+    }
+    return sl;
+}
+
+void ss_skiplist_free(ss_skiplist_t* sl)
+{
+    if (sl)
+    {
+        ss_skiplist_destroy(sl);
+        ss_free(sl);
+    }
+}
+
+ss_skiplist_thread_t* ss_skiplist_attach(ss_skiplist_t* sl)
+{
+    for (size_t i = 0; i < SS_SKIPLIST_MAX_THREADS; i++)
+    {
+        ss_skiplist_thread_t* th = &sl->threads[i];
+        int expected = 0;
+        if (ss_atomic_cas(&th->used, &expected, 1))
+        {
+            th->depth = 0;
+            th->seed = (uint32_t)(i * 2654435761u) | 1;
+            return th;
+        }
+    }
+    return NULL;
+}
+
+void ss_skiplist_detach(ss_skiplist_thread_t* th)
+{
+    ss_atomic_store(&th->used, 0);
+}
+
+ss_bool_t ss_skiplist_insert(ss_skiplist_thread_t* th, const void* key, size_t ksize,
+                             const void* value, size_t vsize)
+{
+    ss_skiplist_t* sl = th->list;
+    ss_skiplist_node_t *preds[SS_SKIPLIST_MAX_LEVEL], *succs[SS_SKIPLIST_MAX_LEVEL];
+    uintptr_t expected;
+
+    _ss_skiplist_enter(th);
+    if (_ss_skiplist_find(sl, key, ksize, preds, succs))
+    {
+        _ss_skiplist_leave(th);
+        return SS_FALSE;
+    }
+    uint32_t height = _ss_skiplist_random_height(th);
+    ss_skiplist_node_t* node = _ss_skiplist_node_new(key, ksize, value, vsize, height);
+    if (!node)
+    {
+        _ss_skiplist_leave(th);
+        return SS_FALSE;
+    }
+
+    // Linking level 0 inserts the key; the upper levels are only shortcuts
+    for (;;)
+    {
+        for (uint32_t level = 0; level < height; level++)
+        {
+            node->next[level] = (uintptr_t)succs[level];
+        }
+        expected = (uintptr_t)succs[0];
+        if (ss_atomic_cas(&preds[0]->next[0], &expected, (uintptr_t)node))
+        {
+            break;
+        }
+        if (_ss_skiplist_find(sl, key, ksize, preds, succs))
+        {
+            ss_free(node); // Never published
+            _ss_skiplist_leave(th);
+            return SS_FALSE;
+        }
+    }
+    ss_atomic_fetch_add(&sl->size, (size_t)1);
+
+    for (uint32_t level = 1; level < height; level++)
+    {
+        for (;;)
+        {
+            uintptr_t next = ss_atomic_load(&node->next[level]);
+            if (_ss_skiplist_marked(next))
+            {
+                goto done; // Being removed, stop building the tower
+            }
+            if (next != (uintptr_t)succs[level] &&
+                !ss_atomic_cas(&node->next[level], &next, (uintptr_t)succs[level]))
+            {
+                goto done;
+            }
+            expected = (uintptr_t)succs[level];
+            if (ss_atomic_cas(&preds[level]->next[level], &expected, (uintptr_t)node))
+            {
+                break;
+            }
+            if (!_ss_skiplist_find(sl, key, ksize, preds, succs) || succs[0] != node)
+            {
+                goto done;
+            }
+        }
+    }
+done:
+    _ss_skiplist_release(th, node);
+    _ss_skiplist_leave(th);
+    return SS_TRUE;
+}
+
+ss_bool_t ss_skiplist_get(ss_skiplist_thread_t* th, const void* key, size_t ksize, void* value,
+                          size_t vsize)
+{
+    ss_skiplist_t* sl = th->list;
+    ss_bool_t found = SS_FALSE;
+
+    _ss_skiplist_enter(th);
+    ss_skiplist_node_t* node = _ss_skiplist_seek(sl, key, ksize);
+    if (node && _ss_skiplist_compare(sl, node, key, ksize) == 0)
+    {
+        if (value)
+        {
+            memcpy(value, node->entry.value, SS_MIN(vsize, node->entry.vsize));
+        }
+        found = SS_TRUE;
+    }
+    _ss_skiplist_leave(th);
+    return found;
+}
+
+ss_bool_t ss_skiplist_remove(ss_skiplist_thread_t* th, const void* key, size_t ksize)
+{
+    ss_skiplist_t* sl = th->list;
+    ss_skiplist_node_t *preds[SS_SKIPLIST_MAX_LEVEL], *succs[SS_SKIPLIST_MAX_LEVEL];
+    ss_skiplist_node_t* node;
+    uintptr_t next;
+
+    _ss_skiplist_enter(th);
+    for (;;)
+    {
+        if (!_ss_skiplist_find(sl, key, ksize, preds, succs))
+        {
+            _ss_skiplist_leave(th);
+            return SS_FALSE;
+        }
+        node = succs[0];
+
+        // Mark top-down so searches stop linking through the node before it disappears
+        for (uint32_t level = node->height - 1; level > 0; level--)
+        {
+            next = ss_atomic_load(&node->next[level]);
+            while (!_ss_skiplist_marked(next) &&
+                   !ss_atomic_cas(&node->next[level], &next, next | 1))
+            {
+            }
+        }
+        // Marking level 0 is the removal; losing that race means another remover won
+        next = ss_atomic_load(&node->next[0]);
+        while (!_ss_skiplist_marked(next) && !ss_atomic_cas(&node->next[0], &next, next | 1))
+        {
+        }
+        if (!_ss_skiplist_marked(next))
+        {
+            break;
+        }
+    }
+    ss_atomic_fetch_add(&sl->size, (size_t)-1);
+    _ss_skiplist_release(th, node);
+    _ss_skiplist_leave(th);
+    return SS_TRUE;
+}
+
+ss_bool_t ss_skiplist_range(ss_skiplist_thread_t* th, const void* lo, size_t losize,
+                            const void* hi, size_t hisize, ss_skiplist_iterate_cb_f cb,
+                            void* param)
+{
+    ss_skiplist_t* sl = th->list;
+    ss_bool_t stopped = SS_FALSE;
+
+    _ss_skiplist_enter(th);
+    ss_skiplist_node_t* node = _ss_skiplist_seek(sl, lo, losize);
+    while (node)
+    {
+        uintptr_t next = ss_atomic_load(&node->next[0]);
+        if (!_ss_skiplist_marked(next))
+        {
+            if (hi && _ss_skiplist_compare(sl, node, hi, hisize) >= 0)
+            {
+                break;
+            }
+            if (cb(sl, &node->entry, param))
+            {
+                stopped = SS_TRUE;
+                break;
+            }
+        }
+        node = _ss_skiplist_ptr(next);
+    }
+    _ss_skiplist_leave(th);
+    return stopped;
+}
+
+ss_bool_t ss_skiplist_iterate(ss_skiplist_thread_t* th, ss_skiplist_iterate_cb_f cb, void* param)
+{
+    return ss_skiplist_range(th, NULL, 0, NULL, 0, cb, param);
+}
@@ -0,0 +1,153 @@
+/**
+ * @file ss_skiplist.h
+ * @brief Lock-free concurrent skip list ordered map
+ * @author trywen@qq.com
+ * @date 2026-10-18
+ *
+ * Ordered map that many threads can search and update at once. Features include:
+ * - Lock-free insert, search and remove by CAS on the forward pointers
+ * - Logical deletion: a removed node is first marked at every level, then unlinked
+ * - Epoch-based reclamation, so readers never touch freed nodes and never take locks
+ * - Ordered range iteration, weakly consistent under concurrent updates
+ *
+ * Each thread works through its own handle from ss_skiplist_attach(). Every call pins
+ * the handle to the current epoch; unlinked nodes wait on the handle's limbo lists
+ * until no thread can still be pinned in the epoch that saw them.
+ *
+ * Entries are immutable once inserted: inserting an existing key fails, replace a
+ * value by removing and inserting again.
+ */
+
+#ifndef SS_SKIPLIST_H
+#define SS_SKIPLIST_H
+
+#include "ss_types.h"
+
+/* Tower height limit, ample for 2^32 entries at p = 1/2 */
+#define SS_SKIPLIST_MAX_LEVEL 32
+
+/* Handles that can be attached at once */
+#define SS_SKIPLIST_MAX_THREADS 64
+
+/* Retirements between two attempts to advance the global epoch */
+#define SS_SKIPLIST_RETIRE_BATCH 64
+
+/**
+ * @struct ss_skiplist_node_s
+ * @brief Node header: forward pointers, then the key bytes and the value bytes
+ *
+ * @var next height forward pointers, bit 0 set once the node is deleted at that level
+ */
+struct ss_skiplist_node_s
+{
+    ss_skiplist_node_t* limbo; // Link on a handle's limbo list after unlinking
+    ss_entry_t entry;
+    uint32_t owners; // Inserter and remover still working on the node
+    uint32_t height;
+    uintptr_t next[];
+};
+
+/**
+ * @struct ss_skiplist_thread_s
+ * @brief Per-thread handle, one slot of the list's handle table
+ *
+ * @var epoch (global epoch << 1) | 1 while inside a call, 0 outside
+ * @var limbo Unlinked nodes by the epoch they were retired in, modulo 3
+ */
+struct ss_skiplist_thread_s
+{
+    ss_skiplist_t* list;
+    size_t epoch;
+    int used;
+    int depth; // Nested pins, callbacks may call back into the list
+    uint32_t seed;
+    size_t retired;
+    ss_skiplist_node_t* limbo[3];
+    size_t limbo_epoch[3];
+};
+
+/**
+ * @struct ss_skiplist_s
+ * @brief Skip list container structure
+ *
+ * @var head Sentinel with a full tower, ordered before every key
+ * @var size Number of entries, approximate while updates are in flight
+ * @var epoch Global reclamation epoch
+ */
+struct ss_skiplist_s
+{
+    ss_skiplist_node_t* head;
+    size_t size;
+    ss_compare_f key_compare;
+    size_t epoch;
+    ss_skiplist_thread_t threads[SS_SKIPLIST_MAX_THREADS];
+};
+
+/* If returns true, iteration will stop. The entry is valid during the callback only */
+typedef ss_bool_t (*ss_skiplist_iterate_cb_f)(ss_skiplist_t* sl, const ss_entry_t* entry,
+                                              void* param);
+
+/**
+ * @brief Initialize skip list
+ * @return SS_FALSE on allocation failure
+ */
+ss_bool_t ss_skiplist_init(ss_skiplist_t* sl, ss_compare_f key_compare);
+
+/**
+ * @brief Free all nodes, including those waiting for reclamation
+ * @note No other thread may use the list, attached handles become invalid
+ */
+void ss_skiplist_destroy(ss_skiplist_t* sl);
+
+/**
+ * @brief Create new skip list instance
+ * @note Caller must free with ss_skiplist_free()
+ */
+ss_skiplist_t* ss_skiplist_create(ss_compare_f key_compare);
+void ss_skiplist_free(ss_skiplist_t* sl);
+
+/**
+ * @brief Claim a handle for the calling thread
+ * @return NULL when SS_SKIPLIST_MAX_THREADS handles are attached
+ * @note A handle must be used by one thread at a time
+ */
+ss_skiplist_thread_t* ss_skiplist_attach(ss_skiplist_t* sl);
+
+/* Return a handle; nodes still on its limbo lists are freed by a later owner or destroy */
+void ss_skiplist_detach(ss_skiplist_thread_t* th);
+
+/**
+ * @brief Insert a key-value pair if the key is absent
+ * @return SS_FALSE if the key is present or allocation failed
+ */
+ss_bool_t ss_skiplist_insert(ss_skiplist_thread_t* th, const void* key, size_t ksize,
+                             const void* value, size_t vsize);
+
+/**
+ * @brief Look up a key
+ * @param[out] value Receives up to vsize bytes of the stored value (may be NULL)
+ * @return SS_TRUE if found
+ */
+ss_bool_t ss_skiplist_get(ss_skiplist_thread_t* th, const void* key, size_t ksize, void* value,
+                          size_t vsize);
+
+ss_bool_t ss_skiplist_remove(ss_skiplist_thread_t* th, const void* key, size_t ksize);
+
+/**
+ * @brief Visit the keys in [lo, hi) in ascending order
+ * @param[in] lo Inclusive lower key, NULL to start at the first entry
+ * @param[in] hi Exclusive upper key, NULL to run to the last entry
+ * @return SS_TRUE if the callback stopped the scan
+ * @note Sees every entry present for the whole scan, and may or may not see entries
+ *       inserted or removed during it
+ */
+ss_bool_t ss_skiplist_range(ss_skiplist_thread_t* th, const void* lo, size_t losize,
+                            const void* hi, size_t hisize, ss_skiplist_iterate_cb_f cb,
+                            void* param);
+
+// param: user data for callback. Returns TRUE to stop iteration
+ss_bool_t ss_skiplist_iterate(ss_skiplist_thread_t* th, ss_skiplist_iterate_cb_f cb, void* param);
+
+#define ss_skiplist_size(sl) ((sl)->size)
+
+#endif /* SS_SKIPLIST_H */
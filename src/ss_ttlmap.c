@@ -0,0 +1,335 @@
+#include "ss_alloc.h"
+#include "ss_ttlmap.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define _SS_TTLMAP_LEVEL_SHIFT(level) (SS_TTLMAP_WHEEL_BITS * (level))
+
+// Node header, value bytes (kept aligned behind the header), then key bytes
+static ss_ttlmap_node_t* _ss_ttlmap_node_new(const void* key, size_t ksize, const void* value,
+                                             size_t vsize)
+{
+    if (!value)
+    {
+        vsize = 0;
+    }
+    ss_ttlmap_node_t* node =
+        (ss_ttlmap_node_t*)ss_malloc(sizeof(ss_ttlmap_node_t) + vsize + ksize);
+    if (!node)
+    {
+        return NULL;
+    }
+    memset(node, 0, sizeof(ss_ttlmap_node_t));
+    node->entry.value = vsize > 0 ? (void*)(node + 1) : NULL;
+    node->entry.vsize = vsize;
+    node->entry.key = (char*)(node + 1) + vsize;
+    node->entry.ksize = ksize;
+    if (vsize > 0)
+    {
+        memcpy(node->entry.value, value, vsize);
+    }
+    memcpy(node->entry.key, key, ksize);
+    return node;
+}
+
+static uint64_t _ss_ttlmap_deadline(ss_ttlmap_t* m, uint64_t ttl)
+{
+    // Saturate instead of wrapping around
+    return ttl > UINT64_MAX - m->now ? UINT64_MAX : m->now + ttl;
+}
+
+static void _ss_ttlmap_unlink(ss_ttlmap_t* m, ss_ttlmap_node_t* node)
+{
+    *node->pprev = node->next;
+    if (node->next)
+    {
+        node->next->pprev = node->pprev;
+    }
+    node->next = NULL;
+    node->pprev = NULL;
+    m->level_size[node->level]--;
+}
+
+static void _ss_ttlmap_schedule(ss_ttlmap_t* m, ss_ttlmap_node_t* node)
+{
+    uint64_t delta = node->expire > m->now ? node->expire - m->now : 0;
+    uint64_t slot_time;
+    if (delta > SS_TTLMAP_MAX_DELAY)
+    {
+        // Park in the top level, the node is re-scheduled when that slot cascades
+        delta = SS_TTLMAP_MAX_DELAY;
+        slot_time = m->now + SS_TTLMAP_MAX_DELAY;
+    }
+    else
+    {
+        slot_time = m->now + delta;
+    }
+
+    unsigned int level = 0;
+    while (level < SS_TTLMAP_WHEEL_LEVELS - 1 &&
+           delta >= (1ULL << _SS_TTLMAP_LEVEL_SHIFT(level + 1)))
+    {
+        level++;
+    }
+    ss_ttlmap_node_t** slot =
+        &m->wheel[level][(slot_time >> _SS_TTLMAP_LEVEL_SHIFT(level)) & SS_TTLMAP_WHEEL_MASK];
+
+    node->level = level;
+    node->pprev = slot;
+    node->next = *slot;
+    if (*slot)
+    {
+        (*slot)->pprev = &node->next;
+    }
+    *slot = node;
+    m->level_size[level]++;
+}
+
+static void _ss_ttlmap_cascade(ss_ttlmap_t* m, unsigned int level, size_t idx)
+{
+    ss_ttlmap_node_t* node = m->wheel[level][idx];
+    m->wheel[level][idx] = NULL;
+    while (node)
+    {
+        ss_ttlmap_node_t* next = node->next;
+        m->level_size[level]--;
+        _ss_ttlmap_schedule(m, node);
+        node = next;
+    }
+}
+
+// Move to the next tick, cascading upper level slots whose span starts there
+static void _ss_ttlmap_advance(ss_ttlmap_t* m)
+{
+    unsigned int level;
+    m->now++;
+    for (level = 1; level < SS_TTLMAP_WHEEL_LEVELS; level++)
+    {
+        if ((m->now >> _SS_TTLMAP_LEVEL_SHIFT(level - 1)) & SS_TTLMAP_WHEEL_MASK)
+        {
+            break;
+        }
+        _ss_ttlmap_cascade(m, level,
+                           (m->now >> _SS_TTLMAP_LEVEL_SHIFT(level)) & SS_TTLMAP_WHEEL_MASK);
+    }
+}
+
+// The map borrows key and value from the node, so the stored value is the node itself
+static ss_ttlmap_node_t* _ss_ttlmap_find(ss_ttlmap_t* m, const void* key, size_t ksize)
+{
+    return (ss_ttlmap_node_t*)ss_hashmap_get(&m->map, key, ksize, NULL);
+}
+
+static void _ss_ttlmap_node_drop(ss_ttlmap_t* m, ss_ttlmap_node_t* node)
+{
+    _ss_ttlmap_unlink(m, node);
+    ss_hashmap_remove(&m->map, node->entry.key, node->entry.ksize);
+    ss_free(node);
+}
+
+ss_bool_t ss_ttlmap_init(ss_ttlmap_t* m, uint64_t now, ss_hash_f hash, ss_compare_f compare)
+{
+    memset(m, 0, sizeof(ss_ttlmap_t));
+    if (!ss_hashmap_init(&m->map, SS_DEFAULT_HASHMAP_BUCKETS, hash, compare))
+    {
+        return SS_FALSE;
+    }
+    ss_hashmap_set_borrow(&m->map, SS_BORROW_KEY | SS_BORROW_VALUE, NULL, NULL);
+    m->now = now;
+    return SS_TRUE;
+}
+
+void ss_ttlmap_destroy(ss_ttlmap_t* m)
+{
+    ss_ttlmap_clear(m);
+    ss_hashmap_destroy(&m->map);
+}
+
+ss_ttlmap_t* ss_ttlmap_create(uint64_t now, ss_hash_f hash, ss_compare_f compare)
+{
+    ss_ttlmap_t* m = (ss_ttlmap_t*)ss_malloc(sizeof(ss_ttlmap_t));
+    if (!m)
+    {
+        return NULL;
+    }
+    if (!ss_ttlmap_init(m, now, hash, compare))
+    {
+        ss_free(m);
+        return NULL;
+    }
+    return m;
+}
+
+void ss_ttlmap_free(ss_ttlmap_t* m)
+{
+    ss_ttlmap_destroy(m);
+    ss_free(m);
+}
+
+void ss_ttlmap_set_expire_cb(ss_ttlmap_t* m, ss_ttlmap_expire_cb_f cb, void* param)
+{
+    m->expire_cb = cb;
+    m->expire_param = param;
+}
+
+ss_bool_t ss_ttlmap_put(ss_ttlmap_t* m, const void* key, size_t ksize, const void* value,
+                        size_t vsize, uint64_t ttl)
+{
+    if (!value)
+    {
+        vsize = 0;
+    }
+    ss_ttlmap_node_t* old = _ss_ttlmap_find(m, key, ksize);
+    ss_ttlmap_node_t* node;
+    if (old && old->entry.vsize == vsize)
+    {
+        // Same size: overwrite in place and reschedule
+        node = old;
+        if (vsize > 0)
+        {
+            memcpy(node->entry.value, value, vsize);
+        }
+        _ss_ttlmap_unlink(m, node);
+    }
+    else
+    {
+        node = _ss_ttlmap_node_new(key, ksize, value, vsize);
+        if (!node)
+        {
+            return SS_FALSE;
+        }
+        if (old)
+        {
+            // Repoint the borrowed key and value at the new node before releasing the old one
+            ss_hashmap_put(&m->map, node->entry.key, ksize, node, sizeof(ss_ttlmap_node_t));
+            _ss_ttlmap_unlink(m, old);
+            ss_free(old);
+        }
+        else
+        {
+            size_t size = ss_ttlmap_size(m);
+            ss_hashmap_put(&m->map, node->entry.key, ksize, node, sizeof(ss_ttlmap_node_t));
+            if (ss_ttlmap_size(m) == size)
+            {
+                ss_free(node);
+                return SS_FALSE;
+            }
+        }
+    }
+    node->expire = _ss_ttlmap_deadline(m, ttl);
+    _ss_ttlmap_schedule(m, node);
+    return SS_TRUE;
+}
+
+void* ss_ttlmap_get(ss_ttlmap_t* m, const void* key, size_t ksize, size_t* vsize)
+{
+    ss_ttlmap_node_t* node = _ss_ttlmap_find(m, key, ksize);
+    if (!node || node->expire <= m->now)
+    {
+        return NULL;
+    }
+    if (vsize)
+    {
+        *vsize = node->entry.vsize;
+    }
+    return node->entry.value;
+}
+
+ss_bool_t ss_ttlmap_refresh(ss_ttlmap_t* m, const void* key, size_t ksize, uint64_t ttl)
+{
+    ss_ttlmap_node_t* node = _ss_ttlmap_find(m, key, ksize);
+    if (!node)
+    {
+        return SS_FALSE;
+    }
+    _ss_ttlmap_unlink(m, node);
+    node->expire = _ss_ttlmap_deadline(m, ttl);
+    _ss_ttlmap_schedule(m, node);
+    return SS_TRUE;
+}
+
+ss_bool_t ss_ttlmap_remove(ss_ttlmap_t* m, const void* key, size_t ksize)
+{
+    ss_ttlmap_node_t* node = _ss_ttlmap_find(m, key, ksize);
+    if (!node)
+    {
+        return SS_FALSE;
+    }
+    _ss_ttlmap_node_drop(m, node);
+    return SS_TRUE;
+}
+
+size_t ss_ttlmap_expire_until(ss_ttlmap_t* m, uint64_t now, size_t max)
+{
+    size_t n = 0;
+    while (SS_TRUE)
+    {
+        ss_ttlmap_node_t** slot = &m->wheel[0][m->now & SS_TTLMAP_WHEEL_MASK];
+        while (*slot)
+        {
+            if (max && n >= max)
+            {
+                return n;
+            }
+            ss_ttlmap_node_t* node = *slot;
+            if (node->expire > m->now)
+            {
+                _ss_ttlmap_unlink(m, node);
+                _ss_ttlmap_schedule(m, node);
+                continue;
+            }
+            if (m->expire_cb)
+            {
+                m->expire_cb(m, &node->entry, m->expire_param);
+            }
+            _ss_ttlmap_node_drop(m, node);
+            n++;
+        }
+        if (m->now >= now)
+        {
+            break;
+        }
+        if (ss_ttlmap_size(m) == 0)
+        {
+            m->now = now;
+            break;
+        }
+        if (m->level_size[0] == 0)
+        {
+            // Nothing can fire before the next level 0 wrap, skip straight to it
+            uint64_t last = m->now | SS_TTLMAP_WHEEL_MASK;
+            if (last >= now)
+            {
+                m->now = now;
+                break;
+            }
+            m->now = last;
+        }
+        _ss_ttlmap_advance(m);
+    }
+    return n;
+}
+
+void ss_ttlmap_clear(ss_ttlmap_t* m)
+{
+    unsigned int level;
+    size_t idx;
+    for (level = 0; level < SS_TTLMAP_WHEEL_LEVELS; level++)
+    {
+        for (idx = 0; idx < SS_TTLMAP_WHEEL_SIZE; idx++)
+        {
+            ss_ttlmap_node_t* node = m->wheel[level][idx];
+            while (node)
+            {
+                ss_ttlmap_node_t* next = node->next;
+                ss_free(node);
+                node = next;
+            }
+            m->wheel[level][idx] = NULL;
+        }
+        m->level_size[level] = 0;
+    }
+    ss_hashmap_clear(&m->map);
+}
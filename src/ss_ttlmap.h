@@ -0,0 +1,157 @@
+/**
+ * @file ss_ttlmap.h
+ * @brief Hash map with per-entry expiry driven by a hierarchical timing wheel
+ * @author trywen@qq.com
+ * @date 2026-10-18
+ *
+ * Entries are indexed by an ss_hashmap and scheduled on a 4-level timing wheel
+ * of 64 slots each. Features include:
+ * - O(1) insert, refresh, remove and per-entry expiry
+ * - Expiry driven by the caller's clock through ss_ttlmap_expire_until()
+ * - Reclamation in bounded batches, resumable on the next call
+ *
+ * Time is an abstract monotonic tick count chosen by the caller (e.g. milliseconds).
+ * Delays longer than the wheel horizon are parked in the top level and re-scheduled
+ * as the wheel turns.
+ */
+
+#ifndef SS_TTLMAP_H
+#define SS_TTLMAP_H
+
+#include "ss_types.h"
+
+#include "ss_hashmap.h"
+
+#define SS_TTLMAP_WHEEL_BITS 6
+#define SS_TTLMAP_WHEEL_SIZE (1 << SS_TTLMAP_WHEEL_BITS)
+#define SS_TTLMAP_WHEEL_MASK (SS_TTLMAP_WHEEL_SIZE - 1)
+#define SS_TTLMAP_WHEEL_LEVELS 4
+/* Largest delay that can be scheduled without parking */
+#define SS_TTLMAP_MAX_DELAY ((1ULL << (SS_TTLMAP_WHEEL_BITS * SS_TTLMAP_WHEEL_LEVELS)) - 1)
+
+/**
+ * @struct ss_ttlmap_node_s
+ * @brief Map node, allocated as a single block followed by value and key bytes
+ *
+ * @var next Next node in the same wheel slot
+ * @var pprev Address of the pointer referencing this node
+ * @var expire Absolute expiry tick
+ * @var level Wheel level currently holding the node
+ * @var entry Key/value view into the bytes stored after the node header
+ */
+struct ss_ttlmap_node_s
+{
+    ss_ttlmap_node_t* next;
+    ss_ttlmap_node_t** pprev;
+    uint64_t expire;
+    unsigned int level;
+    ss_entry_t entry;
+};
+
+/**
+ * @brief Expiry callback, invoked before an expired entry is released
+ * @param m Map pointer
+ * @param entry Entry being expired (key and value remain valid during the call)
+ * @param param User data given to ss_ttlmap_set_expire_cb()
+ */
+typedef void (*ss_ttlmap_expire_cb_f)(ss_ttlmap_t* m, const ss_entry_t* entry, void* param);
+
+/**
+ * @struct ss_ttlmap_s
+ * @brief TTL map container structure
+ *
+ * @var map Key to node index
+ * @var wheel Timing wheel slots, level 0 has one tick per slot
+ * @var level_size Number of nodes held by each level
+ * @var now Tick currently being processed
+ */
+struct ss_ttlmap_s
+{
+    ss_hashmap_t map;
+    ss_ttlmap_node_t* wheel[SS_TTLMAP_WHEEL_LEVELS][SS_TTLMAP_WHEEL_SIZE];
+    size_t level_size[SS_TTLMAP_WHEEL_LEVELS];
+    uint64_t now;
+
+    ss_ttlmap_expire_cb_f expire_cb;
+    void* expire_param;
+};
+
+/**
+ * @brief Initialize TTL map
+ * @param[in] m Pointer to map structure
+ * @param[in] now Starting tick of the wheel
+ * @param[in] hash Hash function for keys
+ * @param[in] compare Key comparison function
+ * @return SS_TRUE if initialization succeeded
+ */
+ss_bool_t ss_ttlmap_init(ss_ttlmap_t* m, uint64_t now, ss_hash_f hash, ss_compare_f compare);
+void ss_ttlmap_destroy(ss_ttlmap_t* m);
+
+/**
+ * @brief Create new TTL map instance
+ * @return Newly allocated map pointer, NULL on failure
+ * @note Caller must free with ss_ttlmap_free()
+ */
+ss_ttlmap_t* ss_ttlmap_create(uint64_t now, ss_hash_f hash, ss_compare_f compare);
+void ss_ttlmap_free(ss_ttlmap_t* m);
+
+/**
+ * @brief Set callback invoked for every expired entry
+ * @param[in] m Map pointer
+ * @param[in] cb Callback (NULL to disable)
+ * @param[in] param User data passed to callback
+ */
+void ss_ttlmap_set_expire_cb(ss_ttlmap_t* m, ss_ttlmap_expire_cb_f cb, void* param);
+
+/**
+ * @brief Insert or update an entry expiring ttl ticks after the wheel's current tick
+ * @param[in] m Map pointer
+ * @param[in] key Pointer to key data
+ * @param[in] ksize Key data size in bytes
+ * @param[in] value Pointer to value data (may be NULL)
+ * @param[in] vsize Value data size in bytes
+ * @param[in] ttl Time to live in ticks
+ * @return SS_TRUE on success, SS_FALSE on allocation failure
+ */
+ss_bool_t ss_ttlmap_put(ss_ttlmap_t* m, const void* key, size_t ksize, const void* value,
+                        size_t vsize, uint64_t ttl);
+
+/**
+ * @brief Look up a live entry
+ * @param[out] vsize Pointer to receive value size (may be NULL)
+ * @return Pointer to value data, NULL if not found or already due
+ */
+void* ss_ttlmap_get(ss_ttlmap_t* m, const void* key, size_t ksize, size_t* vsize);
+
+/**
+ * @brief Reschedule an entry to expire ttl ticks after the wheel's current tick
+ * @return SS_TRUE if the key exists
+ */
+ss_bool_t ss_ttlmap_refresh(ss_ttlmap_t* m, const void* key, size_t ksize, uint64_t ttl);
+
+/**
+ * @brief Remove an entry without invoking the expiry callback
+ * @return SS_TRUE if the key existed
+ */
+ss_bool_t ss_ttlmap_remove(ss_ttlmap_t* m, const void* key, size_t ksize);
+
+/**
+ * @brief Advance the wheel up to now and release due entries
+ * @param[in] m Map pointer
+ * @param[in] now Current time in ticks
+ * @param[in] max Maximum number of entries to release (0 = unlimited)
+ * @return Number of entries released
+ * @note When max is reached the wheel stops at the tick being processed; the next
+ *       call resumes from there
+ */
+size_t ss_ttlmap_expire_until(ss_ttlmap_t* m, uint64_t now, size_t max);
+
+/**
+ * @brief Remove all entries without invoking the expiry callback
+ */
+void ss_ttlmap_clear(ss_ttlmap_t* m);
+
+#define ss_ttlmap_size(m) ss_hashmap_size(&(m)->map)
+#define ss_ttlmap_now(m) ((m)->now)
+
+#endif /* SS_TTLMAP_H */
@@ -31,8 +31,14 @@ typedef struct ss_string_s ss_string_t;
 typedef struct ss_obtree_s ss_obtree_t;
 /** @brief Node structure for ordered binary tree */
 typedef struct ss_obtree_node_s ss_obtree_node_t;
+/** @brief Shape statistics of an ordered binary tree */
+typedef struct ss_obtree_stats_s ss_obtree_stats_t;
+/** @brief In-order cursor over an ordered binary tree */
+typedef struct ss_obtree_cursor_s ss_obtree_cursor_t;
 /** @brief Hash map container */
 typedef struct ss_hashmap_s ss_hashmap_t;
+/** @brief Shape statistics of a hash map */
+typedef struct ss_hashmap_stats_s ss_hashmap_stats_t;
 /** @brief Linked list container */
 typedef struct ss_list_s ss_list_t;
 /** @brief Node structure for linked list */
@@ -41,6 +47,44 @@ typedef struct ss_list_node_s ss_list_node_t;
 typedef struct ss_bigbitset_s ss_bigbitset_t;
 /** @brief Compact bit array implementation */
 typedef struct ss_bitarray_s ss_bitarray_t;
+/** @brief Bounded LRU cache */
+typedef struct ss_lru_s ss_lru_t;
+/** @brief Node structure for LRU cache */
+typedef struct ss_lru_node_s ss_lru_node_t;
+/** @brief Hash map with per-entry expiry */
+typedef struct ss_ttlmap_s ss_ttlmap_t;
+/** @brief Node structure for TTL map */
+typedef struct ss_ttlmap_node_s ss_ttlmap_node_t;
+/** @brief Integer-keyed hash map */
+typedef struct ss_intmap_s ss_intmap_t;
+/** @brief String interning table */
+typedef struct ss_intern_s ss_intern_t;
+/** @brief Concurrent counter map */
+typedef struct ss_countermap_s ss_countermap_t;
+/** @brief Node structure for counter map */
+typedef struct ss_countermap_node_s ss_countermap_node_t;
+/** @brief Incremental hash state */
+typedef struct ss_hasher_s ss_hasher_t;
+/** @brief B+tree container */
+typedef struct ss_btree_s ss_btree_t;
+/** @brief Node structure for B+tree */
+typedef struct ss_btree_node_s ss_btree_node_t;
+/** @brief Persistent tree with snapshots */
+typedef struct ss_ptree_s ss_ptree_t;
+/** @brief Node structure for persistent tree, shared between versions */
+typedef struct ss_ptree_node_s ss_ptree_node_t;
+/** @brief Read-only version of a persistent tree */
+typedef struct ss_ptree_snapshot_s ss_ptree_snapshot_t;
+/** @brief Concurrent skip list */
+typedef struct ss_skiplist_s ss_skiplist_t;
+/** @brief Node structure for skip list */
+typedef struct ss_skiplist_node_s ss_skiplist_node_t;
+/** @brief Per-thread skip list handle */
+typedef struct ss_skiplist_thread_s ss_skiplist_thread_t;
+/** @brief Interval tree container */
+typedef struct ss_itree_s ss_itree_t;
+/** @brief Node structure for interval tree */
+typedef struct ss_itree_node_s ss_itree_node_t;
 
 /* Boolean type definition */
 /**
@@ -79,6 +123,16 @@ struct ss_entry_s
  */
 typedef size_t (*ss_hash_f)(const void* value, size_t size);
 
+/**
+ * @typedef ss_hash_seeded_f
+ * @brief Seeded hash function prototype
+ * @param value Pointer to data to hash
+ * @param size Size of data in bytes
+ * @param seed Hash seed, different seeds give unrelated hash values
+ * @return Computed hash value
+ */
+typedef size_t (*ss_hash_seeded_f)(const void* value, size_t size, uint64_t seed);
+
 /**
  * @typedef ss_compare_f
  * @brief Comparison function prototype
@@ -90,6 +144,11 @@ typedef size_t (*ss_hash_f)(const void* value, size_t size);
  */
 typedef int (*ss_compare_f)(const void* lvalue, size_t lsize, const void* rvalue, size_t rsize);
 
+/* Ownership flags: the container stores the caller's key/value pointer verbatim
+ * instead of copying the pointed-to bytes */
+#define SS_BORROW_KEY 0x1
+#define SS_BORROW_VALUE 0x2
+
 #define SS_TRUE true
 #define SS_FALSE false
 
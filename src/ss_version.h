@@ -11,6 +11,10 @@
 #define SS_STRUCT_LITERAL_ENABLED
 #endif
 
+#if defined(__GNUC__) || defined(__clang__)
+#define SS_ATOMIC_ENABLED
+#endif
+
 #ifdef HAVE_CTYPE_H
 #include <ctype.h>
 #define USE_STANDARD_TOLOWER 1
@@ -9,6 +9,17 @@ void test_hashmap();
 void test_alloc();
 void test_compare();
 void test_hash();
+void test_lru();
+void test_ttlmap();
+void test_intmap();
+void test_intern();
+void test_countermap();
+void test_cpu();
+void test_ascii();
+void test_btree();
+void test_ptree();
+void test_skiplist();
+void test_itree();
 void log_env();
 
 int main()
@@ -24,6 +35,17 @@ int main()
     test_alloc();
     test_compare();
     test_hash();
+    test_lru();
+    test_ttlmap();
+    test_intmap();
+    test_intern();
+    test_countermap();
+    test_cpu();
+    test_ascii();
+    test_btree();
+    test_ptree();
+    test_skiplist();
+    test_itree();
 
     log_env();
 
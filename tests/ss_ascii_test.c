@@ -0,0 +1,107 @@
+#include "ss_ascii.h"
+#include "ss_cpu.h"
+#include "ss_csl_adapter.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+// Helper function giving the sign of a comparison result
+static int sign_of(int v)
+{
+    return (v > 0) - (v < 0);
+}
+
+// Helper function comparing byte by byte, the reference for the vector kernels
+static int reference_memicmp(const unsigned char* l, const unsigned char* r, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        int lc = (l[i] >= 'A' && l[i] <= 'Z') ? l[i] + 32 : l[i];
+        int rc = (r[i] >= 'A' && r[i] <= 'Z') ? r[i] + 32 : r[i];
+        if (lc != rc)
+        {
+            return lc - rc;
+        }
+    }
+    return 0;
+}
+
+void test_ascii()
+{
+    printf("\n=== Starting ss_ascii tests ===\n");
+
+    // Test the letter boundaries the old ss_csl_tolower fallback got wrong
+    assert(ss_ascii_tolower('A') == 'a' && ss_ascii_tolower('Z') == 'z');
+    assert(ss_ascii_tolower('@') == '@' && ss_ascii_tolower('[') == '[');
+    assert(ss_ascii_toupper('a') == 'A' && ss_ascii_toupper('z') == 'Z');
+    assert(ss_ascii_toupper('`') == '`' && ss_ascii_toupper('{') == '{');
+    assert(ss_csl_memicmp("Zone-A", "zONE-a", 6) == 0);
+    assert(ss_csl_memicmp("abc", "abd", 0) == 0);
+    printf("[OK] ss_ascii_tolower/toupper: Boundary tests passed\n");
+
+    // Test every byte value with and without the run-time AVX2 kernel; lengths cover the
+    // SWAR words, the baseline vectors and their overlapping last blocks
+    unsigned char src[300], dst[300], expected[300];
+    for (size_t i = 0; i < sizeof(src); i++)
+    {
+        src[i] = (unsigned char)(i * 7 + 3);
+    }
+    for (size_t i = 0; i < sizeof(src); i++)
+    {
+        expected[i] = (unsigned char)ss_ascii_toupper(src[i]);
+    }
+    uint32_t masks[] = {~0u, 0};
+    for (size_t k = 0; k < sizeof(masks) / sizeof(masks[0]); k++)
+    {
+        ss_cpu_mask_features(masks[k]);
+        for (size_t off = 0; off < 4; off++)
+        {
+            for (size_t len = 0; len + off <= sizeof(src); len++)
+            {
+                memset(dst, 0xee, sizeof(dst));
+                ss_ascii_toupper_block(dst, src + off, len);
+                assert(memcmp(dst, expected + off, len) == 0);
+                assert(len == sizeof(dst) || dst[len] == 0xee); // No write past the end
+            }
+        }
+    }
+    ss_cpu_mask_features(~0u);
+    memcpy(dst, src, sizeof(src));
+    ss_ascii_toupper_block(dst, dst, sizeof(dst)); // In place
+    assert(memcmp(dst, expected, sizeof(dst)) == 0);
+    printf("[OK] ss_ascii_toupper_block: Kernel parity tests passed\n");
+
+    // Test a mismatch at every position, including case-only and letter/punctuation pairs
+    unsigned char lbuf[100], rbuf[100];
+    for (size_t i = 0; i < sizeof(lbuf); i++)
+    {
+        lbuf[i] = (unsigned char)('a' + i % 26);
+        rbuf[i] = (unsigned char)ss_ascii_toupper(lbuf[i]);
+    }
+    for (size_t k = 0; k < sizeof(masks) / sizeof(masks[0]); k++)
+    {
+        ss_cpu_mask_features(masks[k]);
+        for (size_t len = 0; len <= sizeof(lbuf); len++)
+        {
+            assert(ss_ascii_memicmp(lbuf, rbuf, len) == 0);
+        }
+        for (size_t pos = 0; pos < sizeof(lbuf); pos++)
+        {
+            unsigned char saved = rbuf[pos];
+            const unsigned char probes[] = {'_', '[', '@', '{', 0x80, 0xe1, 0};
+            for (size_t p = 0; p < sizeof(probes); p++)
+            {
+                rbuf[pos] = probes[p];
+                int got = ss_ascii_memicmp(lbuf, rbuf, sizeof(lbuf));
+                assert(got == reference_memicmp(lbuf, rbuf, sizeof(lbuf)));
+                assert(sign_of(ss_ascii_memicmp(rbuf, lbuf, sizeof(lbuf))) == -sign_of(got));
+                assert(ss_ascii_memicmp(lbuf, rbuf, pos) == 0); // Prefix before the change
+            }
+            rbuf[pos] = saved;
+        }
+    }
+    ss_cpu_mask_features(~0u);
+    printf("[OK] ss_ascii_memicmp: Kernel parity tests passed\n");
+
+    printf("=== All ss_ascii tests passed ===\n");
+}
@@ -0,0 +1,295 @@
+#include "ss_btree.h"
+#include "ss_compare.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_KEYS (1 << 14)
+
+// Helper function comparing two stored keys the way the tree does
+static int key_order(ss_btree_t* t, const void* l, const void* r)
+{
+    if (t->key_compare)
+    {
+        return t->key_compare(l, t->ksize, r, t->ksize);
+    }
+    uint64_t a, b;
+    memcpy(&a, l, sizeof(a));
+    memcpy(&b, r, sizeof(b));
+    return (a > b) - (a < b);
+}
+
+// Helper function checking order, separator bounds, fill and leaf depth below node
+static size_t verify_node(ss_btree_t* t, ss_btree_node_t* node, const void* lo, const void* hi,
+                          size_t level)
+{
+    const unsigned char* keys = (const unsigned char*)(node + 1);
+    size_t i, size = 0;
+    assert(node->count <= (node->leaf ? t->leaf_cap : t->inner_cap));
+    assert(node == t->root || node->count > 0);
+    for (i = 0; i < node->count; i++)
+    {
+        const void* key = keys + i * t->ksize;
+        assert(i == 0 || key_order(t, keys + (i - 1) * t->ksize, key) < 0);
+        assert(!lo || key_order(t, lo, key) <= 0);
+        assert(!hi || key_order(t, key, hi) < 0);
+    }
+    if (node->leaf)
+    {
+        assert(level == t->height);
+        return node->count;
+    }
+    ss_btree_node_t** children = (ss_btree_node_t**)((unsigned char*)node + t->inner_coff);
+    for (i = 0; i <= node->count; i++)
+    {
+        const void* clo = i > 0 ? keys + (i - 1) * t->ksize : lo;
+        const void* chi = i < node->count ? keys + i * t->ksize : hi;
+        size += verify_node(t, children[i], clo, chi, level + 1);
+    }
+    return size;
+}
+
+// Helper function checking the whole tree and its leaf chain
+static void verify_tree(ss_btree_t* t)
+{
+    if (!t->root)
+    {
+        assert(t->size == 0 && t->height == 0 && !t->first && !t->last);
+        assert(t->leaves == 0 && t->inners == 0);
+        return;
+    }
+    assert(verify_node(t, t->root, NULL, NULL, 1) == t->size);
+    size_t size = 0;
+    ss_btree_node_t* prev = NULL;
+    for (ss_btree_node_t* leaf = t->first; leaf; leaf = leaf->next)
+    {
+        assert(leaf->leaf && leaf->prev == prev);
+        size += leaf->count;
+        prev = leaf;
+    }
+    assert(prev == t->last && size == t->size);
+}
+
+// Helper function summing values of a scan, param[0] is the visit count
+static ss_bool_t sum_values(ss_btree_t* t, const ss_entry_t* entry, void* param)
+{
+    (void)t; // Unused
+    uint64_t* acc = (uint64_t*)param;
+    uint64_t value;
+    memcpy(&value, entry->value, sizeof(value));
+    acc[0]++;
+    acc[1] += value;
+    return acc[0] == acc[2]; // Stop after a limit, 0 for none
+}
+
+// Helper function giving the i-th key of a scrambled permutation of 0, 3, 6, ...
+static uint64_t scrambled(size_t i)
+{
+    return (uint64_t)((i * 2654435761u) % TEST_KEYS) * 3;
+}
+
+void test_btree()
+{
+    printf("\n=== Starting ss_btree tests ===\n");
+
+    // Test creation and initialization
+    ss_btree_t t;
+    assert(!ss_btree_init(&t, 4, 8, NULL)); // Native keys are 8 bytes
+    assert(!ss_btree_init(&t, 0, 8, ss_compare_int));
+    ss_btree_t* dynamic_tree = ss_btree_create(sizeof(uint64_t), sizeof(uint64_t), NULL);
+    assert(dynamic_tree != NULL && ss_btree_size(dynamic_tree) == 0);
+    ss_btree_free(dynamic_tree);
+    assert(ss_btree_init(&t, sizeof(uint64_t), sizeof(uint64_t), NULL));
+    assert(t.leaf_bytes <= SS_BTREE_NODE_BYTES && t.inner_bytes <= SS_BTREE_NODE_BYTES);
+    assert(t.leaf_cap >= 16 && t.inner_cap >= 16);
+    printf("[OK] ss_btree_init/create: Initialization test passed\n");
+
+    // Test put/get in scrambled order
+    size_t i;
+    for (i = 0; i < TEST_KEYS; i++)
+    {
+        uint64_t key = scrambled(i);
+        uint64_t value = key * 2;
+        assert(ss_btree_put(&t, &key, &value));
+    }
+    assert(ss_btree_size(&t) == TEST_KEYS);
+    verify_tree(&t);
+    assert(t.height >= 3);
+    uint64_t key, value;
+    for (key = 0; key < TEST_KEYS * 3; key++)
+    {
+        ss_bool_t found = ss_btree_get(&t, &key, &value);
+        assert(found == (key % 3 == 0));
+        assert(!found || value == key * 2);
+    }
+    key = 300;
+    value = 1;
+    assert(ss_btree_put(&t, &key, &value)); // Update
+    *(uint64_t*)ss_btree_find(&t, &key) += 1;
+    assert(ss_btree_get(&t, &key, &value) && value == 2);
+    assert(ss_btree_size(&t) == TEST_KEYS);
+    value = key * 2;
+    ss_btree_put(&t, &key, &value);
+    printf("[OK] ss_btree_put/get: Put and get test passed\n");
+
+    // Test iteration both ways and seeking
+    ss_btree_iter_t it;
+    uint64_t expect = 0;
+    for (ss_bool_t valid = ss_btree_seek_first(&t, &it); valid; valid = ss_btree_next(&t, &it))
+    {
+        assert(*(uint64_t*)ss_btree_iter_key(&t, &it) == expect);
+        assert(*(uint64_t*)ss_btree_iter_value(&t, &it) == expect * 2);
+        expect += 3;
+    }
+    assert(expect == TEST_KEYS * 3);
+    for (ss_bool_t valid = ss_btree_seek_last(&t, &it); valid; valid = ss_btree_prev(&t, &it))
+    {
+        expect -= 3;
+        assert(*(uint64_t*)ss_btree_iter_key(&t, &it) == expect);
+    }
+    assert(expect == 0);
+    key = 301;
+    assert(ss_btree_seek(&t, &key, &it) && *(uint64_t*)ss_btree_iter_key(&t, &it) == 303);
+    key = 303;
+    assert(ss_btree_seek(&t, &key, &it) && *(uint64_t*)ss_btree_iter_key(&t, &it) == 303);
+    assert(ss_btree_prev(&t, &it) && *(uint64_t*)ss_btree_iter_key(&t, &it) == 300);
+    key = TEST_KEYS * 3;
+    assert(!ss_btree_seek(&t, &key, &it));
+    printf("[OK] ss_btree_seek/next/prev: Iteration test passed\n");
+
+    // Test range scans
+    uint64_t acc[3] = {0, 0, 0};
+    uint64_t lo = 100, hi = 200; // 102 .. 198
+    assert(!ss_btree_range(&t, &lo, &hi, sum_values, acc));
+    assert(acc[0] == 33 && acc[1] == (102 + 198) * 33);
+    memset(acc, 0, sizeof(acc));
+    acc[2] = 5;
+    assert(ss_btree_range(&t, NULL, NULL, sum_values, acc)); // Stopped
+    assert(acc[0] == 5 && acc[1] == (0 + 3 + 6 + 9 + 12) * 2);
+    memset(acc, 0, sizeof(acc));
+    assert(!ss_btree_iterate(&t, sum_values, acc) && acc[0] == TEST_KEYS);
+    printf("[OK] ss_btree_range: Range scan test passed\n");
+
+    // Test removal down to an empty tree, checking invariants along the way
+    for (i = 0; i < TEST_KEYS; i += 2)
+    {
+        key = scrambled(i);
+        assert(ss_btree_remove(&t, &key));
+        assert(!ss_btree_remove(&t, &key));
+        if (i % 512 == 0)
+        {
+            verify_tree(&t);
+        }
+    }
+    verify_tree(&t);
+    assert(ss_btree_size(&t) == TEST_KEYS / 2);
+    for (i = 0; i < TEST_KEYS; i++)
+    {
+        key = scrambled(i);
+        assert((ss_btree_find(&t, &key) != NULL) == (i % 2 == 1));
+    }
+    for (i = TEST_KEYS; i-- > 0;)
+    {
+        key = scrambled(i);
+        assert(ss_btree_remove(&t, &key) == (i % 2 == 1));
+        if (i % 512 == 1)
+        {
+            verify_tree(&t);
+        }
+    }
+    verify_tree(&t);
+    assert(ss_btree_size(&t) == 0 && t.root == NULL);
+    assert(!ss_btree_seek_first(&t, &it) && !ss_btree_remove(&t, &key));
+    printf("[OK] ss_btree_remove: Remove and rebalance test passed\n");
+
+    // Ascending and descending inserts fill the leaves completely
+    for (key = 0; key < TEST_KEYS; key++)
+    {
+        ss_btree_put(&t, &key, NULL);
+    }
+    verify_tree(&t);
+    assert(t.leaves == (TEST_KEYS + t.leaf_cap - 1) / t.leaf_cap);
+    ss_btree_clear(&t);
+    for (key = TEST_KEYS; key-- > 0;)
+    {
+        ss_btree_put(&t, &key, NULL);
+    }
+    verify_tree(&t);
+    assert(t.leaves == (TEST_KEYS + t.leaf_cap - 1) / t.leaf_cap);
+    assert(ss_btree_bytes(&t) < TEST_KEYS * 2 * sizeof(uint64_t) * 5 / 4); // Near the raw pairs
+    ss_btree_destroy(&t);
+    printf("[OK] ss_btree_put: Sequential fill test passed\n");
+
+    // Test bulk load against incremental inserts
+    static uint64_t keys[TEST_KEYS], values[TEST_KEYS];
+    for (i = 0; i < TEST_KEYS; i++)
+    {
+        keys[i] = i * 5;
+        values[i] = i;
+    }
+    size_t sizes[] = {0, 1, 7, 100, 1000, TEST_KEYS};
+    for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++)
+    {
+        ss_btree_init(&t, sizeof(uint64_t), sizeof(uint64_t), NULL);
+        assert(ss_btree_bulk_load(&t, keys, values, sizes[k]));
+        verify_tree(&t);
+        assert(ss_btree_size(&t) == sizes[k]);
+        for (i = 0; i < sizes[k]; i++)
+        {
+            assert(ss_btree_get(&t, &keys[i], &value) && value == i);
+        }
+        // Updates and removals keep working on the packed nodes
+        for (i = 0; i < sizes[k]; i += 3)
+        {
+            key = keys[i] + 1;
+            ss_btree_put(&t, &key, NULL);
+            ss_btree_remove(&t, &keys[i]);
+        }
+        verify_tree(&t);
+        assert(ss_btree_size(&t) == sizes[k]);
+        ss_btree_destroy(&t);
+    }
+    ss_btree_init(&t, sizeof(uint64_t), 0, NULL);
+    keys[10] = keys[9]; // Duplicate
+    assert(!ss_btree_bulk_load(&t, keys, NULL, 100));
+    assert(t.root == NULL && t.leaves == 0 && t.inners == 0);
+    assert(ss_btree_bulk_load(&t, keys, NULL, 10));
+    assert(!ss_btree_bulk_load(&t, keys, NULL, 10)); // Not empty
+    ss_btree_destroy(&t);
+    printf("[OK] ss_btree_bulk_load: Bulk load test passed\n");
+
+    // Test a comparator-ordered set of ints, including negative keys
+    ss_btree_init(&t, sizeof(int), 0, ss_compare_int);
+    for (int k = 0; k < 2000; k++)
+    {
+        int v = (k * 7919) % 2000 - 1000;
+        assert(ss_btree_put(&t, &v, NULL));
+    }
+    verify_tree(&t);
+    assert(ss_btree_seek_first(&t, &it) && *(int*)ss_btree_iter_key(&t, &it) == -1000);
+    for (int k = -1000; k < 1000; k += 2)
+    {
+        assert(ss_btree_remove(&t, &k));
+    }
+    verify_tree(&t);
+    assert(ss_btree_size(&t) == 1000);
+    ss_btree_destroy(&t);
+
+    // Test variable-size keys stored as pointers
+    const char* words[] = {"pear", "apple", "fig", "banana", "cherry", "date", "grape"};
+    ss_btree_init(&t, sizeof(const char*), sizeof(int), ss_compare_string_ptr);
+    for (int k = 0; k < 7; k++)
+    {
+        assert(ss_btree_put(&t, &words[k], &k));
+    }
+    const char* probe = "c";
+    assert(ss_btree_seek(&t, &probe, &it));
+    assert(strcmp(*(const char**)ss_btree_iter_key(&t, &it), "cherry") == 0);
+    probe = "fig";
+    int index = -1;
+    assert(ss_btree_get(&t, &probe, &index) && index == 2);
+    ss_btree_destroy(&t);
+    printf("[OK] ss_btree comparators: Int and string pointer key test passed\n");
+
+    printf("=== All ss_btree tests passed ===\n");
+}
@@ -122,5 +122,20 @@ void test_compare()
     assert(ss_compare_data_case(&cdata1, 0, &cdata3, 0) == 0);
     printf("[OK] ss_compare_data_case: Case-insensitive data structure comparison tests passed\n");
 
+    // Test fragmented keys against contiguous ones
+    ss_slice_t parts[3] = {{"tenant", 6}, {NULL, 0}, {"/path", 5}};
+    assert(ss_compare_slices(parts, 3, "tenant/path", 11) == 0);
+    assert(ss_compare_slices(parts, 3, "tenant/patg", 11) > 0);
+    assert(ss_compare_slices(parts, 3, "tenant/pati", 11) < 0);
+    assert(ss_compare_slices(parts, 3, "tenant/pat", 10) > 0);   // Longer than rvalue
+    assert(ss_compare_slices(parts, 3, "tenant/paths", 12) < 0); // Shorter than rvalue
+    assert(ss_compare_slices(parts, 1, "tenant", 6) == 0);
+    assert(ss_compare_slices(parts, 0, "", 0) == 0);
+    assert(ss_compare_slices(parts, 0, "a", 1) < 0);
+    assert(ss_compare_slices_case(parts, 3, "TENANT/Path", 11) == 0);
+    assert(ss_compare_slices_case(parts, 3, "TENANT/Pat", 10) > 0);
+    assert(ss_compare_slices(parts, 3, "TENANT/Path", 11) != 0);
+    printf("[OK] ss_compare_slices: Fragmented key comparison tests passed\n");
+
     printf("=== All ss_compare tests passed ===\n\n");
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "ss_countermap.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+// Helper function collecting snapshot values by key
+static ss_bool_t collect_counter(ss_countermap_t* m, const void* key, size_t ksize, int64_t value,
+                                 void* param)
+{
+    (void)m; // Unused
+    int64_t* values = (int64_t*)param;
+    if (ksize == 3 && memcmp(key, "rx", 3) == 0)
+    {
+        values[0] = value;
+    }
+    else if (ksize == 3 && memcmp(key, "tx", 3) == 0)
+    {
+        values[1] = value;
+    }
+    values[2]++;
+    return SS_FALSE;
+}
+
+// Helper function stopping after the first key
+static ss_bool_t stop_first(ss_countermap_t* m, const void* key, size_t ksize, int64_t value,
+                            void* param)
+{
+    (void)m;     // Unused
+    (void)key;   // Unused
+    (void)ksize; // Unused
+    (void)value; // Unused
+    (*(int*)param)++;
+    return SS_TRUE;
+}
+
+void test_countermap()
+{
+    printf("\n=== Starting ss_countermap tests ===\n");
+
+    // Test creation and initialization
+    ss_countermap_t* dynamic_map = ss_countermap_create(100, 0, NULL, NULL);
+    assert(dynamic_map != NULL);
+    assert(dynamic_map->bnum == 128 && dynamic_map->nshards == 1 && dynamic_map->stride == 1);
+    assert(ss_countermap_size(dynamic_map) == 0);
+    ss_countermap_free(dynamic_map);
+    printf("[OK] ss_countermap_create/free: Dynamic map creation test passed\n");
+
+    ss_countermap_t m;
+    assert(ss_countermap_init(&m, 4, 0, ss_hash_mem, ss_compare_mem));
+
+    // Test add inserts missing keys and accumulates
+    assert(ss_countermap_add(&m, "rx", 3, 5));
+    assert(ss_countermap_add(&m, "rx", 3, -2));
+    assert(ss_countermap_add(&m, "tx", 3, 7));
+    assert(ss_countermap_get(&m, "rx", 3) == 3);
+    assert(ss_countermap_get(&m, "tx", 3) == 7);
+    assert(ss_countermap_get(&m, "err", 4) == 0);
+    assert(ss_countermap_find(&m, "err", 4) == NULL);
+    assert(ss_countermap_size(&m) == 2);
+    printf("[OK] ss_countermap_add/get: Add and get test passed\n");
+
+    // Test cached node handles and chains in a tiny bucket array
+    ss_countermap_node_t* rx = ss_countermap_ref(&m, "rx", 3);
+    assert(rx != NULL && rx == ss_countermap_find(&m, "rx", 3));
+    ss_countermap_node_add(&m, rx, 0, 10);
+    assert(ss_countermap_node_value(&m, rx) == 13);
+    char key[16];
+    for (int i = 0; i < 100; i++)
+    {
+        snprintf(key, sizeof(key), "k%d", i);
+        assert(ss_countermap_add(&m, key, strlen(key), i));
+    }
+    assert(ss_countermap_size(&m) == 102);
+    assert(ss_countermap_ref(&m, "rx", 3) == rx); // Handle survives later inserts
+    for (int i = 0; i < 100; i++)
+    {
+        snprintf(key, sizeof(key), "k%d", i);
+        assert(ss_countermap_get(&m, key, strlen(key)) == i);
+    }
+    printf("[OK] ss_countermap_ref: Node handle test passed\n");
+
+    // Test snapshot without and with reset
+    int64_t values[3] = {0, 0, 0};
+    assert(!ss_countermap_snapshot(&m, collect_counter, values, SS_FALSE));
+    assert(values[0] == 13 && values[1] == 7 && values[2] == 102);
+    assert(!ss_countermap_snapshot(&m, collect_counter, values, SS_TRUE));
+    assert(ss_countermap_get(&m, "rx", 3) == 0 && ss_countermap_get(&m, "k99", 3) == 0);
+    assert(ss_countermap_size(&m) == 102); // Keys stay registered
+    ss_countermap_add(&m, "tx", 3, 1);
+    memset(values, 0, sizeof(values));
+    assert(!ss_countermap_snapshot(&m, collect_counter, values, SS_TRUE));
+    assert(values[0] == 0 && values[1] == 1);
+    int visited = 0;
+    assert(ss_countermap_snapshot(&m, stop_first, &visited, SS_FALSE));
+    assert(visited == 1);
+    printf("[OK] ss_countermap_snapshot: Snapshot and reset test passed\n");
+
+    // Test clear
+    ss_countermap_clear(&m);
+    assert(ss_countermap_size(&m) == 0);
+    assert(ss_countermap_get(&m, "tx", 3) == 0);
+    ss_countermap_destroy(&m);
+    printf("[OK] ss_countermap_clear: Clear test passed\n");
+
+    // Test sharded counters merge on read
+    ss_countermap_t* sharded = ss_countermap_create(0, 4, NULL, NULL);
+    assert(sharded != NULL && sharded->bnum == SS_DEFAULT_COUNTERMAP_BUCKETS);
+    assert(sharded->stride * sizeof(int64_t) == SS_COUNTERMAP_SHARD_STRIDE);
+    ss_countermap_node_t* node = ss_countermap_ref(sharded, "req", 4);
+    for (size_t shard = 0; shard < 8; shard++)
+    {
+        ss_countermap_node_add(sharded, node, shard, (int64_t)shard + 1); // Shard index wraps
+    }
+    assert(node->counters[0] == 1 + 5);
+    assert(node->counters[3 * sharded->stride] == 4 + 8);
+    assert(ss_countermap_get(sharded, "req", 4) == 36);
+    assert(ss_countermap_add_shard(sharded, "req", 4, 2, 4));
+    memset(values, 0, sizeof(values));
+    assert(!ss_countermap_snapshot(sharded, collect_counter, values, SS_TRUE));
+    assert(values[2] == 1);
+    assert(ss_countermap_node_value(sharded, node) == 0);
+    ss_countermap_free(sharded);
+    printf("[OK] ss_countermap: Sharded counter test passed\n");
+
+    printf("=== All ss_countermap tests passed ===\n");
+}
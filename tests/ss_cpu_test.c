@@ -0,0 +1,34 @@
+#include "ss_cpu.h"
+#include <assert.h>
+#include <stdio.h>
+
+void test_cpu()
+{
+    printf("\n=== Starting ss_cpu tests ===\n");
+
+    // Test detection is cached and stable
+    uint32_t features = ss_cpu_features();
+    assert(ss_cpu_features() == features);
+    printf("ss_cpu_features: 0x%x\n", (unsigned)features);
+#if defined(__x86_64__)
+    assert(ss_cpu_has(SS_CPU_SSE2)); // Baseline of x86-64
+    assert(!(features & (SS_CPU_NEON | SS_CPU_ARM_CRC32)));
+#elif defined(__aarch64__)
+    assert(ss_cpu_has(SS_CPU_NEON));
+    assert(!(features & (SS_CPU_SSE2 | SS_CPU_SSE42 | SS_CPU_AVX2)));
+#endif
+    printf("[OK] ss_cpu_features: Detection test passed\n");
+
+    // Test masking hides features and restores them
+    ss_cpu_mask_features(~(uint32_t)SS_CPU_SSE42);
+    assert(!ss_cpu_has(SS_CPU_SSE42));
+    assert(ss_cpu_features() == (features & ~(uint32_t)SS_CPU_SSE42));
+    ss_cpu_mask_features(0);
+    assert(ss_cpu_features() == 0);
+    assert(ss_cpu_has(0)); // Nothing required
+    ss_cpu_mask_features(~0u);
+    assert(ss_cpu_features() == features);
+    printf("[OK] ss_cpu_mask_features: Masking test passed\n");
+
+    printf("=== All ss_cpu tests passed ===\n");
+}
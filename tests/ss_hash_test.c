@@ -1,3 +1,4 @@
+#include "ss_cpu.h"
 #include "ss_hash.h"
 #include <assert.h>
 #include <limits.h>
@@ -233,6 +234,249 @@ static void test_pointer_hash()
     assert(h1 == h3); // Same pointer value should have same hash
     assert(h1 != h2); // Different pointer values should have different hash
     printf("[OK] ss_hash_ptr: Pointer hash tests passed\n");
+
+    // Test mixed pointer hash spreads aligned addresses over the low bits
+    assert(ss_hash_ptr_mix(&ptr1, 0) == ss_hash_ptr_mix(&ptr3, 0));
+    int low_bits[16] = {0};
+    for (uintptr_t i = 0; i < 256; i++)
+    {
+        void* p = (void*)(0x100000 + i * 64);
+        assert((ss_hash_ptr(&p, 0) & 15) == 0); // Identity hash: one bucket of 16
+        low_bits[ss_hash_ptr_mix(&p, 0) & 15]++;
+    }
+    for (int i = 0; i < 16; i++)
+    {
+        assert(low_bits[i] > 4);
+    }
+    printf("[OK] ss_hash_ptr_mix: Mixed pointer hash tests passed\n");
+}
+
+static void test_integer_mix()
+{
+    printf("\n=== Testing integer mixing functions ===\n");
+
+    // Known values
+    assert(ss_hash_fmix64(0) == 0);
+    assert(ss_hash_splitmix64(0) == 0xe220a8397b1dcdafULL);
+    assert(ss_hash_mulxor64(1) == (0x9e3779b97f4a7c15ULL ^ 0x9e3779b9ULL));
+
+    // Strided IDs keep distinct hashes and fill the low bits
+    int buckets[3][64];
+    memset(buckets, 0, sizeof(buckets));
+    for (uint64_t id = 0; id < 64 * 64; id++)
+    {
+        uint64_t key = id * 1024;
+        buckets[0][ss_hash_fmix64(key) & 63]++;
+        buckets[1][ss_hash_splitmix64(key) & 63]++;
+        buckets[2][ss_hash_mulxor64(key) & 63]++;
+        assert(ss_hash_fmix64(key) != ss_hash_fmix64(key + 1024));
+    }
+    for (int m = 0; m < 3; m++)
+    {
+        for (int b = 0; b < 64; b++)
+        {
+            assert(buckets[m][b] > 16 && buckets[m][b] < 128);
+        }
+    }
+    printf("[OK] ss_hash_fmix64/splitmix64/mulxor64: Strided ID spread tests passed\n");
+
+    // ss_hash_f adapters
+    int i1 = -1;
+    unsigned int u1 = UINT_MAX;
+    long l1 = -1;
+    unsigned long ul1 = (unsigned long)-1;
+    int64_t s64 = 42;
+    uint64_t u64 = 42;
+    assert(ss_hash_int_mix(&i1, 0) == ss_hash_uint_mix(&u1, 0));
+    assert(ss_hash_long_mix(&l1, 0) == ss_hash_ulong_mix(&ul1, 0));
+    assert(ss_hash_int64_mix(&s64, 0) == ss_hash_uint64_mix(&u64, 0));
+    assert(ss_hash_uint64_mix(&u64, 0) == (size_t)ss_hash_fmix64(42));
+    printf("[OK] ss_hash_*_mix: Integer adapter tests passed\n");
+}
+
+static void test_hash64()
+{
+    printf("\n=== Testing 64-bit hash functions ===\n");
+
+    // Test every length through the short, medium and long paths
+    unsigned char buf[200];
+    for (size_t i = 0; i < sizeof(buf); i++)
+    {
+        buf[i] = (unsigned char)(i * 7 + 1);
+    }
+    uint64_t seen[sizeof(buf) + 1];
+    for (size_t len = 0; len <= sizeof(buf); len++)
+    {
+        seen[len] = ss_hash64(buf, len, 0);
+        assert(seen[len] == ss_hash64(buf, len, 0)); // Deterministic
+        for (size_t j = 0; j < len; j++)
+        {
+            assert(seen[j] != seen[len]); // Prefixes hash differently
+        }
+    }
+    printf("[OK] ss_hash64: Length coverage tests passed\n");
+
+    // Test single bit flips change the hash at each path
+    size_t lens[] = {1, 3, 4, 8, 16, 17, 48, 49, 100};
+    for (size_t k = 0; k < sizeof(lens) / sizeof(lens[0]); k++)
+    {
+        uint64_t h = ss_hash64(buf, lens[k], 0);
+        for (size_t bit = 0; bit < lens[k] * 8; bit++)
+        {
+            buf[bit / 8] ^= (unsigned char)(1u << (bit % 8));
+            assert(ss_hash64(buf, lens[k], 0) != h);
+            buf[bit / 8] ^= (unsigned char)(1u << (bit % 8));
+        }
+        assert(ss_hash64(buf, lens[k], 1) != h); // Seed changes the hash
+    }
+    printf("[OK] ss_hash64: Bit flip and seed tests passed\n");
+
+    // Test case folding matches hashing the upper-cased block
+    char mixed[256];
+    char upper[256];
+    for (int c = 0; c < 256; c++)
+    {
+        mixed[c] = (char)c;
+        upper[c] = (char)((c >= 'a' && c <= 'z') ? c - 'a' + 'A' : c);
+    }
+    for (size_t len = 0; len <= sizeof(mixed); len += 5)
+    {
+        assert(ss_hash64_case(mixed, len, 0) == ss_hash64(upper, len, 0));
+    }
+    assert(ss_hash64_case(mixed + 'a', 2, 0) == ss_hash64(upper + 'A', 2, 0));
+    assert(ss_hash64_mem_case("Content-Length", 14) == ss_hash64_mem("CONTENT-LENGTH", 14));
+    assert(ss_hash64_mem_case("[", 1) != ss_hash64_mem_case("{", 1)); // Not letters
+    printf("[OK] ss_hash64_case: Case folding tests passed\n");
+
+    // Test ss_hash_f adapters
+    const char* s1 = "application";
+    const char* s2 = "APPETITE";
+    assert(ss_hash64_mem("hello", 5) != ss_hash64_mem("world", 5));
+    assert(ss_hash64_mem_ptr(&s1, 3) == ss_hash64_mem("app", 3));
+    assert(ss_hash64_mem_case_ptr(&s2, 3) == ss_hash64_mem_case(s1, 3));
+    assert(ss_hash64_string(s1, 0) == ss_hash64_mem(s1, strlen(s1)));
+    assert(ss_hash64_string("abc\0def", 6) == ss_hash64_string("abc", 0));
+    assert(ss_hash64_string_ptr(&s1, 3) == ss_hash64_string("appetite", 3));
+    assert(ss_hash64_string_case(s2, 0) == ss_hash64_string_case("appetite", 0));
+    assert(ss_hash64_string_case_ptr(&s2, 3) == ss_hash64_string_case(s1, 3));
+    printf("[OK] ss_hash64_*: Adapter tests passed\n");
+
+    // Test seeded adapters and seeds
+    assert(ss_hash64_mem_seeded("hello", 5, 0) == ss_hash64_mem("hello", 5));
+    assert(ss_hash64_mem_seeded("hello", 5, 1) != ss_hash64_mem_seeded("hello", 5, 2));
+    assert(ss_hash64_mem_ptr_seeded(&s1, 3, 9) == ss_hash64_mem_seeded("app", 3, 9));
+    assert(ss_hash64_mem_case_ptr_seeded(&s2, 3, 9) == ss_hash64_mem_case_seeded("app", 3, 9));
+    assert(ss_hash64_string_seeded(s1, 0, 7) == ss_hash64_mem_seeded(s1, strlen(s1), 7));
+    assert(ss_hash64_string_ptr_seeded(&s1, 3, 7) == ss_hash64_string_seeded("app", 0, 7));
+    assert(ss_hash64_string_case_ptr_seeded(&s2, 0, 7) ==
+           ss_hash64_string_case_seeded("appetite", 0, 7));
+    uint64_t process_seed = ss_hash_process_seed();
+    assert(process_seed != 0 && ss_hash_process_seed() == process_seed);
+    uint64_t map_seed = ss_hash_random_seed();
+    assert(map_seed != ss_hash_random_seed());
+    ss_hash_set_process_seed(42);
+    assert(ss_hash_process_seed() == 42);
+    ss_hash_set_process_seed(process_seed);
+    printf("[OK] ss_hash64_*_seeded: Seeded hash tests passed\n");
+}
+
+static void test_crc32c()
+{
+    printf("\n=== Testing CRC32C ===\n");
+
+    // Known answers (RFC 3720 test vectors)
+    unsigned char zeros[32] = {0};
+    unsigned char ones[32];
+    memset(ones, 0xff, sizeof(ones));
+    assert(ss_hash_crc32c_update(0, "123456789", 9) == 0xe3069283u);
+    assert(ss_hash_crc32c_update(0, zeros, 32) == 0x8a9136aau);
+    assert(ss_hash_crc32c_update(0, ones, 32) == 0x62a8ab43u);
+    assert(ss_hash_crc32c_update(0, "", 0) == 0);
+    assert(ss_hash_crc32c("123456789", 9) == 0xe3069283u);
+    printf("[OK] ss_hash_crc32c: Known answer tests passed\n");
+
+    // Hardware and software paths agree for every length, offset and split
+    unsigned char buf[300];
+    for (size_t i = 0; i < sizeof(buf); i++)
+    {
+        buf[i] = (unsigned char)(i * 131 + 17);
+    }
+    uint32_t features = ss_cpu_features();
+    for (size_t off = 0; off < 8; off++)
+    {
+        for (size_t len = 0; len + off <= sizeof(buf); len += 7)
+        {
+            ss_cpu_mask_features(~0u);
+            uint32_t fast = ss_hash_crc32c_update(0, buf + off, len);
+            ss_cpu_mask_features(0);
+            uint32_t portable = ss_hash_crc32c_update(0, buf + off, len);
+            assert(fast == portable);
+            size_t half = len / 3;
+            uint32_t chained = ss_hash_crc32c_update(0, buf + off, half);
+            chained = ss_hash_crc32c_update(chained, buf + off + half, len - half);
+            assert(chained == portable);
+        }
+    }
+    ss_cpu_mask_features(~0u);
+    assert(ss_cpu_features() == features);
+    printf("[OK] ss_hash_crc32c_update: Dispatch parity and chaining tests passed\n");
+}
+
+static void test_hasher()
+{
+    printf("\n=== Testing ss_hasher_t ===\n");
+
+    unsigned char buf[200];
+    for (size_t i = 0; i < sizeof(buf); i++)
+    {
+        buf[i] = (unsigned char)('A' + i % 60); // Letters and punctuation for the case variant
+    }
+
+    // Every length and split into three fragments matches the one-shot hash
+    ss_hasher_t h;
+    for (size_t len = 0; len <= 160; len++)
+    {
+        uint64_t expected = ss_hash64(buf, len, 42);
+        uint64_t expected_case = ss_hash64_case(buf, len, 42);
+        for (size_t a = 0; a <= len; a += 5)
+        {
+            for (size_t b = a; b <= len; b += 7)
+            {
+                ss_hasher_init(&h, 42);
+                ss_hasher_update(&h, buf, a);
+                ss_hasher_update(&h, buf + a, b - a);
+                ss_hasher_update(&h, buf + b, len - b);
+                assert(ss_hasher_final(&h) == expected);
+
+                ss_hasher_init_case(&h, 42);
+                ss_hasher_update(&h, buf, a);
+                ss_hasher_update(&h, buf + a, b - a);
+                ss_hasher_update(&h, buf + b, len - b);
+                assert(ss_hasher_final(&h) == expected_case);
+            }
+        }
+    }
+    printf("[OK] ss_hasher_update/final: Split parity tests passed\n");
+
+    // Byte at a time, with final taken along the way
+    ss_hasher_init(&h, 0);
+    for (size_t i = 0; i < sizeof(buf); i++)
+    {
+        ss_hasher_update(&h, buf + i, 1);
+        assert(ss_hasher_final(&h) == ss_hash64(buf, i + 1, 0));
+    }
+    assert((size_t)ss_hasher_final(&h) == ss_hash64_mem(buf, sizeof(buf)));
+    printf("[OK] ss_hasher_final: Incremental final tests passed\n");
+
+    // Composite keys
+    ss_slice_t parts[3] = {{"tenant-7", 8}, {"/v1/orders/", 11}, {"GET", 3}};
+    const char* whole = "tenant-7/v1/orders/GET";
+    assert(ss_hash64_slices(parts, 3, 9) == ss_hash64(whole, 22, 9));
+    assert(ss_hash64_slices_case(parts, 3, 9) == ss_hash64_case("TENANT-7/V1/ORDERS/get", 22, 9));
+    assert(ss_hash64_slices(parts, 0, 9) == ss_hash64("", 0, 9));
+    assert(ss_hash_mem_update(ss_hash_mem_update(0, "tenant-7", 8), "/v1/orders/GET", 14) ==
+           ss_hash_mem(whole, 22));
+    printf("[OK] ss_hash64_slices: Composite key tests passed\n");
 }
 
 void test_hash()
@@ -243,6 +487,10 @@ void test_hash()
     test_memory_hash();
     test_string_hash();
     test_pointer_hash();
+    test_hash64();
+    test_integer_mix();
+    test_crc32c();
+    test_hasher();
 
     printf("=== All ss_hash tests passed ===\n\n");
 }
\ No newline at end of file
@@ -23,6 +23,32 @@ static ss_bool_t find_entry(ss_hashmap_t* map, ss_entry_t* entry, void* param)
     return strncmp((const char*)entry->key, target, entry->ksize) == 0 ? 1 : 0; // Stop if found
 }
 
+// Helper hash sending every key to the same bucket
+static size_t const_hash(const void* value, size_t size)
+{
+    (void)value; // Unused
+    (void)size;  // Unused
+    return 7;
+}
+
+// Helper destructor counting released borrowed pointers
+// Bucket a key hash lands in, mirroring the map's index computation
+static size_t bucket_of(size_t khash, size_t bnum)
+{
+#if SS_HASHMAP_MIX_INDEX
+    return (size_t)(ss_hash_fmix64(khash) % bnum);
+#else
+    return khash % bnum;
+#endif
+}
+
+static int borrowed_frees = 0;
+static void count_free(void* ptr)
+{
+    (void)ptr; // Unused
+    borrowed_frees++;
+}
+
 void test_hashmap()
 {
     printf("\n=== Starting ss_hashmap tests ===\n");
@@ -32,7 +58,7 @@ void test_hashmap()
     assert(dynamic_map != NULL);
     assert(dynamic_map->bnum == 16);
     assert(dynamic_map->size == 0);
-    assert(dynamic_map->buckets != NULL);
+    assert(dynamic_map->buckets == NULL); // Small maps start with inline entries
     printf("[OK] ss_hashmap_create: Dynamic hashmap creation test passed\n");
 
     // Test stack hashmap initialization
@@ -41,7 +67,7 @@ void test_hashmap()
     assert(ret);
     assert(stack_map.bnum == 16);
     assert(stack_map.size == 0);
-    assert(stack_map.buckets != NULL);
+    assert(stack_map.buckets == NULL); // Small maps start with inline entries
     printf("[OK] ss_hashmap_init: Stack hashmap initialization test passed\n");
 
     // Test putting key-value pairs
@@ -130,6 +156,175 @@ void test_hashmap()
     assert(ss_array_size(&test_keys) == ss_hashmap_size(&stack_map));
     ss_array_destroy(&test_keys);
 
+    // Test promotion from inline entries to buckets
+    ss_hashmap_t growing;
+    ss_hashmap_init(&growing, 32, ss_hash_int, ss_compare_int);
+    for (int i = 0; i < SS_HASHMAP_SMALL_SIZE; i++)
+    {
+        int v = i * 10;
+        ss_hashmap_put(&growing, &i, sizeof(i), &v, sizeof(v));
+    }
+    assert(growing.buckets == NULL && growing.size == SS_HASHMAP_SMALL_SIZE);
+    int probe = 3;
+    assert(ss_hashmap_remove(&growing, &probe, sizeof(probe)));
+    assert(ss_hashmap_get(&growing, &probe, sizeof(probe), NULL) == NULL);
+    ss_hashmap_put(&growing, &probe, sizeof(probe), &probe, sizeof(probe));
+    for (int i = SS_HASHMAP_SMALL_SIZE; i < 100; i++)
+    {
+        int v = i * 10;
+        ss_hashmap_put(&growing, &i, sizeof(i), &v, sizeof(v));
+    }
+    assert(growing.buckets != NULL && growing.size == 100);
+    for (int i = 0; i < 100; i++)
+    {
+        const int* v = (const int*)ss_hashmap_get(&growing, &i, sizeof(i), &vsize);
+        assert(v && vsize == sizeof(int) && *v == (i == 3 ? 3 : i * 10));
+    }
+    ss_array_t grown_keys;
+    ss_array_init(&grown_keys, sizeof(ss_slice_t), 100);
+    ss_hashmap_keys(&growing, &grown_keys);
+    assert(ss_array_size(&grown_keys) == 100);
+    ss_array_destroy(&grown_keys);
+    ss_hashmap_destroy(&growing);
+    printf("[OK] ss_hashmap small mode: Inline storage and promotion test passed\n");
+
+    // Test shape statistics
+    ss_hashmap_stats_t stats;
+    ss_hashmap_stats(&stack_map, &stats);
+    assert(stats.size == 4 && stats.small);
+    assert(stats.used_buckets == 0);
+    assert(stats.mean_depth == 2.5);
+    assert(stats.bytes == sizeof(ss_hashmap_t) + 4 * 4 + 13 + 13);
+
+    ss_hashmap_t spread;
+    ss_hashmap_init(&spread, 16, ss_hash_int, ss_compare_int);
+    for (int i = 0; i < 40; i++)
+    {
+        ss_hashmap_put(&spread, &i, sizeof(i), &i, sizeof(i));
+    }
+    ss_hashmap_stats(&spread, &stats);
+    assert(stats.size == 40 && stats.bnum == 16 && !stats.small);
+    assert(stats.used_buckets > 12);
+    assert(stats.max_height >= 2);
+    assert(stats.mean_depth >= 1.0);
+    assert(stats.load_factor == 40.0 / 16);
+    size_t used = 0;
+    for (int i = 0; i < SS_HASHMAP_HEIGHT_HISTOGRAM_SIZE; i++)
+    {
+        used += stats.height_histogram[i];
+    }
+    assert(used == stats.used_buckets);
+    assert(stats.bytes > sizeof(ss_hashmap_t) + 16 * sizeof(ss_hashmap_bucket*) + 40 * 8);
+    ss_hashmap_destroy(&spread);
+
+    // 16-byte aligned pointers with the identity ss_hash_ptr still use most buckets
+    ss_hashmap_init(&spread, 16, ss_hash_ptr, ss_compare_ptr);
+    for (int i = 0; i < 64; i++)
+    {
+        void* p = (void*)(uintptr_t)(0x10000 + i * 16);
+        ss_hashmap_put(&spread, &p, sizeof(p), &i, sizeof(i));
+    }
+    ss_hashmap_stats(&spread, &stats);
+    assert(stats.size == 64 && stats.used_buckets > 12);
+    ss_hashmap_destroy(&spread);
+
+    // A constant hash lands every key in one bucket, whose tree stays balanced
+    ss_hashmap_t degenerate;
+    ss_hashmap_init(&degenerate, 16, const_hash, ss_compare_int);
+    for (int i = 0; i < 32; i++)
+    {
+        ss_hashmap_put(&degenerate, &i, sizeof(i), &i, sizeof(i));
+    }
+    ss_hashmap_stats(&degenerate, &stats);
+    assert(stats.used_buckets == 1);
+    assert(stats.max_height >= 6 && stats.max_height <= 7);
+    assert(stats.height_histogram[stats.max_height] == 1);
+    assert(stats.max_height == stats.mean_height);
+    ss_hashmap_destroy(&degenerate);
+    printf("[OK] ss_hashmap_stats: Shape statistics test passed\n");
+
+    // Test borrowed key/value mode
+    ss_hashmap_t borrowed;
+    ss_hashmap_init(&borrowed, 16, ss_hash_mem, ss_compare_mem);
+    ss_hashmap_set_borrow(&borrowed, SS_BORROW_KEY | SS_BORROW_VALUE, count_free, count_free);
+    char bkey1[] = "key1";
+    char bkey1_again[] = "key1";
+    char bkey2[] = "key2";
+    int big1[64] = {1};
+    int big2[64] = {2};
+    ss_hashmap_put(&borrowed, bkey1, 4, big1, sizeof(big1));
+    ss_hashmap_put(&borrowed, bkey2, 4, big2, sizeof(big2));
+    assert(borrowed.size == 2);
+    assert(ss_hashmap_get(&borrowed, "key1", 4, &vsize) == big1 && vsize == sizeof(big1));
+    // Same value pointer again: nothing released
+    ss_hashmap_put(&borrowed, bkey1, 4, big1, sizeof(big1));
+    assert(borrowed_frees == 0);
+    // Equal key from another buffer and a new value: previous key and value released
+    ss_hashmap_put(&borrowed, bkey1_again, 4, big2, sizeof(big2));
+    assert(borrowed_frees == 2);
+    assert(ss_hashmap_get(&borrowed, "key1", 4, NULL) == big2);
+    assert(ss_hashmap_remove(&borrowed, "key1", 4));
+    assert(borrowed_frees == 4);
+    ss_hashmap_clear(&borrowed);
+    assert(borrowed_frees == 6);
+    // Promotion keeps borrowed pointers without releasing them
+    int bkeys[SS_HASHMAP_SMALL_SIZE * 2];
+    for (int i = 0; i < SS_HASHMAP_SMALL_SIZE * 2; i++)
+    {
+        bkeys[i] = i;
+        ss_hashmap_put(&borrowed, &bkeys[i], sizeof(int), big1, sizeof(big1));
+    }
+    assert(borrowed.buckets != NULL && borrowed_frees == 6);
+    assert(ss_hashmap_get(&borrowed, &bkeys[0], sizeof(int), NULL) == big1);
+    ss_hashmap_clear(&borrowed);
+    assert(borrowed_frees == 6 + SS_HASHMAP_SMALL_SIZE * 4);
+    // No destructors: pointers are simply dropped
+    ss_hashmap_set_borrow(&borrowed, SS_BORROW_VALUE, NULL, NULL);
+    ss_hashmap_put(&borrowed, "key3", 4, big1, sizeof(big1));
+    assert(ss_hashmap_get(&borrowed, "key3", 4, NULL) == big1);
+    ss_hashmap_destroy(&borrowed);
+    assert(borrowed_frees == 6 + SS_HASHMAP_SMALL_SIZE * 4);
+    printf("[OK] ss_hashmap_set_borrow: Borrowed key/value mode test passed\n");
+
+    // Test seeded hashing: keys crafted to collide under one seed spread under another
+    char crafted[32][16];
+    int ncrafted = 0;
+    for (int i = 0; ncrafted < 32; i++)
+    {
+        snprintf(crafted[ncrafted], sizeof(crafted[0]), "k%d", i);
+        if (bucket_of(ss_hash64_string_seeded(crafted[ncrafted], 0, 1), 64) == 0)
+        {
+            ncrafted++;
+        }
+    }
+    ss_hashmap_t seeded;
+    ss_hashmap_stats_t seeded_stats;
+    ss_hashmap_init(&seeded, 64, ss_hash_string, ss_compare_string);
+    ss_hashmap_set_seed(&seeded, ss_hash64_string_seeded, 1);
+    for (int i = 0; i < 32; i++)
+    {
+        ss_hashmap_put(&seeded, crafted[i], strlen(crafted[i]) + 1, &i, sizeof(i));
+    }
+    ss_hashmap_stats(&seeded, &seeded_stats);
+    assert(seeded_stats.used_buckets == 1); // Attacker knows the seed
+    ss_hashmap_destroy(&seeded);
+    ss_hashmap_init(&seeded, 64, ss_hash_string, ss_compare_string);
+    ss_hashmap_set_seed(&seeded, ss_hash64_string_seeded, ss_hash_random_seed());
+    for (int i = 0; i < 32; i++)
+    {
+        ss_hashmap_put(&seeded, crafted[i], strlen(crafted[i]) + 1, &i, sizeof(i));
+    }
+    ss_hashmap_stats(&seeded, &seeded_stats);
+    assert(seeded_stats.used_buckets > 8);
+    for (int i = 0; i < 32; i++)
+    {
+        assert(*(int*)ss_hashmap_get(&seeded, crafted[i], strlen(crafted[i]) + 1, NULL) == i);
+    }
+    assert(ss_hashmap_remove(&seeded, crafted[5], strlen(crafted[5]) + 1));
+    assert(ss_hashmap_get(&seeded, crafted[5], strlen(crafted[5]) + 1, NULL) == NULL);
+    ss_hashmap_destroy(&seeded);
+    printf("[OK] ss_hashmap_set_seed: Seeded hashing test passed\n");
+
     // Cleanup
     ss_array_destroy(&keys_array);
     ss_hashmap_destroy(&stack_map);
@@ -0,0 +1,109 @@
+#include "ss_intern.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+// Helper lock hooks counting acquire/release pairs
+static void count_lock(void* param)
+{
+    int* state = (int*)param;
+    assert(state[0] == 0); // Not re-entered
+    state[0] = 1;
+    state[1]++;
+}
+
+static void count_unlock(void* param)
+{
+    int* state = (int*)param;
+    assert(state[0] == 1);
+    state[0] = 0;
+}
+
+void test_intern()
+{
+    printf("\n=== Starting ss_intern tests ===\n");
+
+    // Test creation and initialization
+    ss_intern_t* dynamic_table = ss_intern_create();
+    assert(dynamic_table != NULL);
+    assert(ss_intern_size(dynamic_table) == 0);
+    assert(ss_intern_find(dynamic_table, "missing", 0, NULL) == NULL);
+    assert(ss_intern_str(dynamic_table, 0) == NULL);
+    ss_intern_free(dynamic_table);
+    printf("[OK] ss_intern_create/free: Dynamic table creation test passed\n");
+
+    ss_intern_t t;
+    assert(ss_intern_init(&t));
+
+    // Test interning returns dense ids and deduplicates
+    uint32_t id = 99;
+    char buffer[32];
+    const char* cpu = ss_intern(&t, "cpu.usage", 0, &id);
+    assert(cpu != NULL && id == 0);
+    assert(strcmp(cpu, "cpu.usage") == 0);
+    strcpy(buffer, "cpu.usage");
+    assert(ss_intern(&t, buffer, 0, &id) == cpu && id == 0); // Same pointer for equal text
+    assert(ss_intern(&t, "host", 0, &id) != NULL && id == 1);
+    assert(ss_intern(&t, "cpu.usage.max", 3, &id) != NULL && id == 2); // Explicit length
+    assert(strcmp(ss_intern_str(&t, 2), "cpu") == 0);
+    assert(ss_intern_entry(&t, 2)->len == 3);
+    assert(ss_intern_size(&t) == 3);
+    assert(ss_intern_bytes(&t) == 10 + 5 + 4);
+    printf("[OK] ss_intern: Dense id and dedup test passed\n");
+
+    // Test find does not insert
+    assert(ss_intern_find(&t, "host", 0, &id) != NULL && id == 1);
+    assert(ss_intern_find(&t, "region", 0, NULL) == NULL);
+    assert(ss_intern_size(&t) == 3);
+    printf("[OK] ss_intern_find: Lookup only test passed\n");
+
+    // Test growth across chunks, index resizes and pages keeps pointers stable
+    for (int i = 0; i < 5000; i++)
+    {
+        snprintf(buffer, sizeof(buffer), "tag.%d", i);
+        assert(ss_intern(&t, buffer, 0, &id) != NULL && id == (uint32_t)i + 3);
+    }
+    assert(ss_intern_size(&t) == 5003);
+    assert(ss_intern_str(&t, 0) == cpu);
+    for (int i = 0; i < 5000; i++)
+    {
+        snprintf(buffer, sizeof(buffer), "tag.%d", i);
+        const char* s = ss_intern_str(&t, (uint32_t)i + 3);
+        assert(s && strcmp(s, buffer) == 0);
+        assert(ss_intern_find(&t, buffer, 0, &id) == s && id == (uint32_t)i + 3);
+    }
+    assert(ss_intern_str(&t, 5003) == NULL);
+    assert(t.table->capacity * 3 >= (size_t)ss_intern_size(&t) * 4);
+    assert(t.table->next && t.table->next->capacity == t.table->capacity / 2); // Kept for readers
+    printf("[OK] ss_intern: Growth and stable pointer test passed\n");
+
+    // Test oversized strings and embedded NUL bytes
+    char big[SS_INTERN_PAGE_SIZE + 100];
+    memset(big, 'x', sizeof(big));
+    const char* big_copy = ss_intern(&t, big, sizeof(big), &id);
+    assert(big_copy != NULL && ss_intern_entry(&t, id)->len == sizeof(big));
+    assert(big_copy[sizeof(big)] == '\0');
+    const char* tail = ss_intern(&t, "after.big", 0, NULL);
+    assert(tail != NULL && t.pages->data <= tail); // Small strings keep filling the open page
+    assert(ss_intern(&t, "a\0b", 3, &id) != ss_intern(&t, "a\0c", 3, NULL));
+    assert(ss_intern_find(&t, "a\0b", 3, NULL) == ss_intern_str(&t, id));
+    printf("[OK] ss_intern: Oversized and binary string test passed\n");
+
+    // Test sync path takes the lock hooks only to insert
+    int state[2] = {0, 0};
+    assert(ss_intern_sync(&t, "host", 0, &id) != NULL && id == 1); // No lock set
+    ss_intern_set_lock(&t, count_lock, count_unlock, state);
+    assert(ss_intern_sync(&t, "host", 0, &id) != NULL && id == 1); // Lock-free hit
+    assert(state[1] == 0);
+    const char* region = ss_intern_sync(&t, "region", 0, &id);
+    assert(region != NULL && state[0] == 0 && state[1] == 1);
+    assert(ss_intern_sync(&t, "region", 0, NULL) == region && state[1] == 1);
+    assert(ss_intern_str(&t, id) == region);
+    printf("[OK] ss_intern_sync: Lock hook test passed\n");
+
+    ss_intern_destroy(&t);
+    assert(ss_intern_size(&t) == 0 && t.pages == NULL);
+    printf("[OK] ss_intern_destroy: Destroy test passed\n");
+
+    printf("=== All ss_intern tests passed ===\n");
+}
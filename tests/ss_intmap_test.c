@@ -0,0 +1,105 @@
+#include "ss_intmap.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+// Helper function summing keys and values
+static ss_bool_t sum_entry(ss_intmap_t* m, uint64_t key, uint64_t* value, void* param)
+{
+    (void)m; // Unused
+    uint64_t* sum = (uint64_t*)param;
+    sum[0] += key;
+    sum[1] += *value;
+    return SS_FALSE;
+}
+
+// Helper function stopping at a specific key
+static ss_bool_t find_key(ss_intmap_t* m, uint64_t key, uint64_t* value, void* param)
+{
+    (void)m;     // Unused
+    (void)value; // Unused
+    return key == *(uint64_t*)param;
+}
+
+void test_intmap()
+{
+    printf("\n=== Starting ss_intmap tests ===\n");
+
+    // Test creation and initialization
+    ss_intmap_t* dynamic_map = ss_intmap_create(100);
+    assert(dynamic_map != NULL);
+    assert(dynamic_map->capacity == 128);
+    assert(ss_intmap_size(dynamic_map) == 0);
+    ss_intmap_free(dynamic_map);
+    printf("[OK] ss_intmap_create/free: Dynamic map creation test passed\n");
+
+    ss_intmap_t m;
+    assert(ss_intmap_init(&m, 0));
+    assert(m.capacity == SS_DEFAULT_INTMAP_CAPACITY);
+    assert(sizeof(ss_intmap_slot_t) == 16);
+
+    // Test put/get including key 0 and growth
+    for (uint64_t k = 0; k < 1000; k++)
+    {
+        assert(ss_intmap_put(&m, k * 16, k + 1)); // Aligned, strided keys
+    }
+    assert(ss_intmap_size(&m) == 1000);
+    assert(m.capacity >= 1000 * 4 / 3);
+    uint64_t value = 0;
+    for (uint64_t k = 0; k < 1000; k++)
+    {
+        assert(ss_intmap_get(&m, k * 16, &value) && value == k + 1);
+    }
+    assert(!ss_intmap_get(&m, 8, &value));
+    assert(ss_intmap_find(&m, 0) && *ss_intmap_find(&m, 0) == 1);
+    printf("[OK] ss_intmap_put/get: Put and get test passed\n");
+
+    // Test update in place
+    assert(ss_intmap_put(&m, 32, 777));
+    *ss_intmap_find(&m, 48) += 1;
+    assert(ss_intmap_get(&m, 32, &value) && value == 777);
+    assert(ss_intmap_get(&m, 48, &value) && value == 5);
+    assert(ss_intmap_size(&m) == 1000);
+    printf("[OK] ss_intmap_put: Update existing key test passed\n");
+
+    // Test iteration
+    uint64_t sums[2] = {0, 0};
+    ss_intmap_iterate(&m, sum_entry, sums);
+    assert(sums[0] == 16 * (999 * 1000 / 2));
+    uint64_t target = 160;
+    assert(ss_intmap_iterate(&m, find_key, &target));
+    target = 161;
+    assert(!ss_intmap_iterate(&m, find_key, &target));
+    printf("[OK] ss_intmap_iterate: Iteration test passed\n");
+
+    // Test removal keeps probe runs intact
+    for (uint64_t k = 0; k < 1000; k += 2)
+    {
+        assert(ss_intmap_remove(&m, k * 16));
+    }
+    assert(!ss_intmap_remove(&m, 0));
+    assert(ss_intmap_size(&m) == 500);
+    for (uint64_t k = 0; k < 1000; k++)
+    {
+        assert(ss_intmap_get(&m, k * 16, NULL) == (k % 2 == 1));
+    }
+    printf("[OK] ss_intmap_remove: Remove operation test passed\n");
+
+    // Test pointer values, reserve and clear
+    int object = 42;
+    assert(ss_intmap_put_ptr(&m, 7, &object));
+    assert(ss_intmap_get_ptr(&m, 7) == &object);
+    assert(ss_intmap_get_ptr(&m, 9) == NULL);
+    assert(ss_intmap_reserve(&m, 10000));
+    assert(m.capacity >= 10000 * 4 / 3);
+    assert(ss_intmap_get_ptr(&m, 7) == &object && ss_intmap_size(&m) == 501);
+    ss_intmap_clear(&m);
+    assert(ss_intmap_size(&m) == 0);
+    assert(!ss_intmap_get(&m, 7, NULL) && !ss_intmap_get(&m, 16, NULL));
+    printf("[OK] ss_intmap_clear: Clear operation test passed\n");
+
+    ss_intmap_destroy(&m);
+    printf("[OK] ss_intmap_destroy: Cleanup completed\n");
+
+    printf("=== All ss_intmap tests passed ===\n\n");
+}
@@ -0,0 +1,165 @@
+#include "ss_itree.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_RANGES 600
+
+// Helper function checking parents, order, AVL balance, heights and subtree maxima;
+// returns the node count
+static size_t verify_node(ss_itree_node_t* node, ss_itree_node_t* parent)
+{
+    if (!node)
+    {
+        return 0;
+    }
+    assert(node->parent == parent && node->lo <= node->hi);
+    int lh = node->left ? node->left->height : 0;
+    int rh = node->right ? node->right->height : 0;
+    assert(lh - rh <= 1 && rh - lh <= 1);
+    assert(node->height == (lh > rh ? lh : rh) + 1);
+    uint64_t max = node->hi;
+    if (node->left)
+    {
+        assert(node->left->lo <= node->lo);
+        max = node->left->max > max ? node->left->max : max;
+    }
+    if (node->right)
+    {
+        assert(node->right->lo >= node->lo);
+        max = node->right->max > max ? node->right->max : max;
+    }
+    assert(node->max == max);
+    return verify_node(node->left, node) + 1 + verify_node(node->right, node);
+}
+
+// Helper function collecting the ids stored as values
+static ss_bool_t collect_cb(ss_itree_t* t, ss_itree_node_t* node, void* param)
+{
+    int* out = (int*)param;
+    (void)t;
+    out[++out[0]] = *(int*)ss_itree_node_value(node);
+    return SS_FALSE;
+}
+
+// Helper function stopping a query at the first range
+static ss_bool_t stop_cb(ss_itree_t* t, ss_itree_node_t* node, void* param)
+{
+    (void)t;
+    *(ss_itree_node_t**)param = node;
+    return SS_TRUE;
+}
+
+void test_itree()
+{
+    printf("\n=== Starting ss_itree tests ===\n");
+
+    // Test stabbing and overlap queries on a few port ranges
+    ss_itree_t* t = ss_itree_create();
+    assert(t != NULL);
+    uint64_t ranges[][2] = {{80, 80}, {0, 1023}, {443, 443}, {1024, 65535}, {8000, 8999}};
+    for (int i = 0; i < 5; i++)
+    {
+        assert(ss_itree_insert(t, ranges[i][0], ranges[i][1], &i, sizeof(i)) != NULL);
+    }
+    assert(ss_itree_insert(t, 10, 9, NULL, 0) == NULL); // Empty range
+    assert(ss_itree_size(t) == 5 && verify_node(t->root, NULL) == 5);
+    int ids[TEST_RANGES + 1];
+    ids[0] = 0;
+    assert(!ss_itree_stab(t, 80, collect_cb, ids));
+    assert(ids[0] == 2 && ids[1] == 1 && ids[2] == 0); // [0,1023] sorts before [80,80]
+    ids[0] = 0;
+    assert(!ss_itree_stab(t, 8080, collect_cb, ids));
+    assert(ids[0] == 2 && ids[1] == 3 && ids[2] == 4);
+    ids[0] = 0;
+    assert(!ss_itree_overlap(t, 1000, 1100, collect_cb, ids));
+    assert(ids[0] == 2 && ids[1] == 1 && ids[2] == 3);
+    ids[0] = 0;
+    assert(!ss_itree_stab(t, 70000, collect_cb, ids) && ids[0] == 0);
+    assert(*(int*)ss_itree_node_value(ss_itree_find_overlap(t, 443, 500)) == 1);
+    assert(*(int*)ss_itree_node_value(ss_itree_find_overlap(t, 9000, 9000)) == 3);
+    assert(ss_itree_find_overlap(t, 65536, UINT64_MAX) == NULL);
+    ss_itree_node_t* first = NULL;
+    assert(ss_itree_stab(t, 443, stop_cb, &first));
+    assert(*(int*)ss_itree_node_value(first) == 1);
+    ids[0] = 0;
+    assert(!ss_itree_iterate(t, collect_cb, ids));
+    assert(ids[0] == 5 && ids[1] == 1 && ids[2] == 0 && ids[3] == 2 && ids[5] == 4);
+    ss_itree_free(t);
+    printf("[OK] ss_itree_stab/overlap: Port range test passed\n");
+
+    // Test random ranges, including duplicates, against a linear scan while removing
+    ss_itree_t tree;
+    ss_itree_node_t* nodes[TEST_RANGES];
+    uint64_t lo[TEST_RANGES], hi[TEST_RANGES];
+    unsigned int seed = 2024;
+    ss_itree_init(&tree);
+    for (int i = 0; i < TEST_RANGES; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        lo[i] = (seed >> 8) % 10000;
+        hi[i] = lo[i] + (seed >> 20) % (i % 3 == 0 ? 2000 : 50);
+        if (i % 50 == 1)
+        {
+            lo[i] = lo[i - 1];
+            hi[i] = hi[i - 1];
+        }
+        nodes[i] = ss_itree_insert(&tree, lo[i], hi[i], &i, sizeof(i));
+        assert(nodes[i] != NULL);
+    }
+    assert(verify_node(tree.root, NULL) == TEST_RANGES);
+    for (int round = 0; round < 3; round++)
+    {
+        for (int q = 0; q < 200; q++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            uint64_t qlo = (seed >> 8) % 12000;
+            uint64_t qhi = qlo + (q & 1 ? 0 : (seed >> 24) % 300);
+            size_t expected = 0;
+            int leftmost = -1;
+            for (int i = 0; i < TEST_RANGES; i++)
+            {
+                if (nodes[i] && lo[i] <= qhi && hi[i] >= qlo)
+                {
+                    expected++;
+                    if (leftmost < 0 || lo[i] < lo[leftmost] ||
+                        (lo[i] == lo[leftmost] && hi[i] < hi[leftmost]))
+                    {
+                        leftmost = i;
+                    }
+                }
+            }
+            ids[0] = 0;
+            assert(!ss_itree_overlap(&tree, qlo, qhi, collect_cb, ids));
+            assert((size_t)ids[0] == expected);
+            for (int k = 1; k <= ids[0]; k++)
+            {
+                int id = ids[k];
+                assert(nodes[id] && lo[id] <= qhi && hi[id] >= qlo);
+                assert(k == 1 || lo[ids[k - 1]] <= lo[id]);
+            }
+            ss_itree_node_t* found = ss_itree_find_overlap(&tree, qlo, qhi);
+            assert(!found == (leftmost < 0));
+            assert(!found || (found->lo == lo[leftmost] && found->hi == hi[leftmost]));
+        }
+        // Remove a third of the remaining ranges, the handles of the others stay valid
+        for (int i = round; i < TEST_RANGES; i += 3)
+        {
+            if (nodes[i] && i % 2 == round % 2)
+            {
+                ss_itree_remove(&tree, nodes[i]);
+                nodes[i] = NULL;
+            }
+        }
+        assert(verify_node(tree.root, NULL) == ss_itree_size(&tree));
+        for (int i = 0; i < TEST_RANGES; i++)
+        {
+            assert(!nodes[i] || *(int*)ss_itree_node_value(nodes[i]) == i);
+        }
+    }
+    ss_itree_destroy(&tree);
+    assert(ss_itree_size(&tree) == 0 && !tree.root);
+    printf("[OK] ss_itree: Random range test passed\n");
+
+    printf("=== All ss_itree tests passed ===\n");
+}
@@ -0,0 +1,110 @@
+#include "ss_compare.h"
+#include "ss_hash.h"
+#include "ss_lru.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+// Helper function recording evicted keys
+static void record_evict(ss_lru_t* lru, const ss_entry_t* entry, void* param)
+{
+    (void)lru; // Unused
+    char* last = (char*)param;
+    memcpy(last, entry->key, entry->ksize);
+    last[entry->ksize] = '\0';
+}
+
+void test_lru()
+{
+    printf("\n=== Starting ss_lru tests ===\n");
+
+    // Test creation and initialization
+    ss_lru_t* dynamic_lru = ss_lru_create(4, 0, ss_hash_mem, ss_compare_mem);
+    assert(dynamic_lru != NULL);
+    assert(ss_lru_size(dynamic_lru) == 0);
+    assert(ss_lru_oldest(dynamic_lru) == NULL);
+    ss_lru_free(dynamic_lru);
+    printf("[OK] ss_lru_create/free: Dynamic cache creation test passed\n");
+
+    ss_lru_t lru;
+    assert(ss_lru_init(&lru, 3, 0, ss_hash_mem, ss_compare_mem));
+    char evicted[16] = {0};
+    ss_lru_set_evict_cb(&lru, record_evict, evicted);
+
+    // Test put/get
+    const char* keys[] = {"key1", "key2", "key3", "key4"};
+    const char* values[] = {"value1", "value2", "value3", "value4"};
+    for (int i = 0; i < 3; i++)
+    {
+        assert(ss_lru_put(&lru, keys[i], strlen(keys[i]), values[i], strlen(values[i])));
+    }
+    assert(ss_lru_size(&lru) == 3);
+    size_t vsize = 0;
+    const char* value = (const char*)ss_lru_get(&lru, "key1", 4, &vsize);
+    assert(value != NULL && vsize == 6 && strncmp(value, "value1", 6) == 0);
+    assert(ss_lru_get(&lru, "nonexistent", 11, NULL) == NULL);
+    assert(lru.hits == 1 && lru.misses == 1);
+    printf("[OK] ss_lru_put/get: Put and get test passed\n");
+
+    // Test eviction order: key1 was touched by get, so key2 is the oldest
+    assert(ss_lru_put(&lru, keys[3], 4, values[3], 6));
+    assert(ss_lru_size(&lru) == 3);
+    assert(strcmp(evicted, "key2") == 0);
+    assert(lru.evictions == 1);
+    assert(ss_lru_peek(&lru, "key2", 4, NULL) == NULL);
+    assert(ss_lru_touch(&lru, "key3", 4));
+    assert(!ss_lru_touch(&lru, "key2", 4));
+    const ss_entry_t* oldest = ss_lru_oldest(&lru);
+    assert(oldest && oldest->ksize == 4 && memcmp(oldest->key, "key1", 4) == 0);
+    printf("[OK] ss_lru_evict: Eviction order test passed\n");
+
+    // Test update with same and different value sizes
+    assert(ss_lru_put(&lru, "key1", 4, "VALUE1", 6));
+    value = (const char*)ss_lru_peek(&lru, "key1", 4, &vsize);
+    assert(vsize == 6 && strncmp(value, "VALUE1", 6) == 0);
+    assert(ss_lru_put(&lru, "key1", 4, "longer_value", 12));
+    value = (const char*)ss_lru_peek(&lru, "key1", 4, &vsize);
+    assert(vsize == 12 && strncmp(value, "longer_value", 12) == 0);
+    assert(ss_lru_size(&lru) == 3);
+    assert(ss_lru_bytes(&lru) == 4 + 12 + 4 + 6 + 4 + 6);
+    printf("[OK] ss_lru_put: Update existing key test passed\n");
+
+    // Test remove
+    assert(ss_lru_remove(&lru, "key3", 4));
+    assert(!ss_lru_remove(&lru, "key3", 4));
+    assert(ss_lru_size(&lru) == 2);
+    assert(lru.evictions == 1);
+    printf("[OK] ss_lru_remove: Remove test passed\n");
+
+    // Test byte capacity
+    ss_lru_t blru;
+    assert(ss_lru_init(&blru, 0, 20, ss_hash_mem, ss_compare_mem));
+    assert(ss_lru_put(&blru, "a", 1, "123456789", 9));  // 10 bytes
+    assert(ss_lru_put(&blru, "b", 1, "123456789", 9));  // 20 bytes
+    assert(ss_lru_put(&blru, "c", 1, "1234", 4));       // evicts "a"
+    assert(ss_lru_size(&blru) == 2 && ss_lru_bytes(&blru) == 15);
+    assert(ss_lru_peek(&blru, "a", 1, NULL) == NULL);
+    assert(!ss_lru_put(&blru, "d", 1, "12345678901234567890", 20)); // Too large on its own
+    assert(ss_lru_size(&blru) == 2);
+    assert(ss_lru_evict(&blru));
+    assert(ss_lru_evict(&blru));
+    assert(!ss_lru_evict(&blru));
+    assert(ss_lru_bytes(&blru) == 0);
+    ss_lru_destroy(&blru);
+    printf("[OK] ss_lru byte capacity: Byte limit test passed\n");
+
+    // Test NULL values and clear
+    assert(ss_lru_put(&lru, "empty", 5, NULL, 0));
+    assert(ss_lru_peek(&lru, "empty", 5, &vsize) == NULL && vsize == 0);
+    ss_lru_clear(&lru);
+    assert(ss_lru_size(&lru) == 0 && ss_lru_bytes(&lru) == 0);
+    assert(ss_lru_oldest(&lru) == NULL);
+    assert(ss_lru_put(&lru, "key1", 4, "value1", 6));
+    assert(ss_lru_size(&lru) == 1);
+    printf("[OK] ss_lru_clear: Clear test passed\n");
+
+    ss_lru_destroy(&lru);
+    printf("[OK] ss_lru_destroy: Cleanup completed\n");
+
+    printf("=== All ss_lru tests passed ===\n\n");
+}
@@ -1,3 +1,4 @@
+#include "ss_alloc.h"
 #include "ss_compare.h"
 #include "ss_hash.h"
 #include "ss_obtree.h"
@@ -53,6 +54,90 @@ static ss_bool_t verify_inorder(ss_obtree_t* t, ss_obtree_node_t* node, int dept
     return 0; // Continue traversal
 }
 
+// Helper function checking AVL heights, balance, parent links and ordering, returns the height
+static int verify_avl(ss_obtree_t* t, ss_obtree_node_t* node, ss_obtree_node_t* parent)
+{
+    if (!node)
+    {
+        return 0;
+    }
+    assert(node->parent == parent);
+    // Children order by hash first, then by key
+    if (node->left)
+    {
+        assert(node->left->khash < node->khash ||
+               (node->left->khash == node->khash &&
+                t->key_compare(node->left->entry.key, node->left->entry.ksize, node->entry.key,
+                               node->entry.ksize) < 0));
+    }
+    if (node->right)
+    {
+        assert(node->right->khash > node->khash ||
+               (node->right->khash == node->khash &&
+                t->key_compare(node->right->entry.key, node->right->entry.ksize,
+                               node->entry.key, node->entry.ksize) > 0));
+    }
+    int lh = verify_avl(t, node->left, node);
+    int rh = verify_avl(t, node->right, node);
+    assert(lh - rh <= 1 && rh - lh <= 1);
+    assert(node->height == SS_MAX(lh, rh) + 1);
+    assert(node->count == 1 + (node->left ? node->left->count : 0) +
+                              (node->right ? node->right->count : 0));
+    return node->height;
+}
+
+// Helper function collecting range scan keys into an int array, param[0] holds the count
+static ss_bool_t collect_int(ss_obtree_t* t, ss_obtree_node_t* node, int depth, void* param)
+{
+    (void)t;     // Unused
+    (void)depth; // Unused
+    int* out = (int*)param;
+    out[1 + out[0]++] = *(const int*)node->entry.key;
+    return out[0] == 8; // Stop after 8 keys
+}
+
+// Helper function counting range scan visits
+static ss_bool_t count_node(ss_obtree_t* t, ss_obtree_node_t* node, int depth, void* param)
+{
+    (void)t;     // Unused
+    (void)node;  // Unused
+    (void)depth; // Unused
+    (*(size_t*)param)++;
+    return SS_FALSE;
+}
+
+// Helper function recording int keys and depths, stopping at key param[0] (0 for none)
+static ss_bool_t record_order(ss_obtree_t* t, ss_obtree_node_t* node, int depth, void* param)
+{
+    (void)t; // Unused
+    int* rec = (int*)param;
+    int key = *(const int*)node->entry.key;
+    rec[2 + rec[1] * 2] = key;
+    rec[3 + rec[1] * 2] = depth;
+    rec[1]++;
+    return key == rec[0];
+}
+
+// Helper function freeing each visited node of a tree with borrowed keys, counting them
+static ss_bool_t free_node(ss_obtree_t* t, ss_obtree_node_t* node, int depth, void* param)
+{
+    (void)t;     // Unused
+    (void)depth; // Unused
+    (*(size_t*)param)++;
+    ss_free(node);
+    return SS_FALSE;
+}
+
+// Helper function appending each visited entry to an entry array, param[0] is the count
+static ss_bool_t collect_entry(ss_obtree_t* t, ss_obtree_node_t* node, int depth, void* param)
+{
+    (void)t;     // Unused
+    (void)depth; // Unused
+    ss_entry_t* out = (ss_entry_t*)param;
+    out[1 + out[0].ksize++] = node->entry;
+    return SS_FALSE;
+}
+
 void test_obtree()
 {
     printf("\n=== Starting ss_obtree tests ===\n");
@@ -163,6 +248,443 @@ void test_obtree()
     assert(ss_obtree_remove2(&tree, "key1", strlen("key1"), hash));
     printf("[OK] Hash-based operations test passed\n");
 
+    // Test shape statistics
+    ss_obtree_stats_t stats;
+    ss_obtree_stats(&tree, &stats);
+    assert(stats.size == 0 && stats.height == 0);
+    assert(stats.bytes == sizeof(ss_obtree_t));
+    ss_obtree_t chain;
+    ss_obtree_init(&chain, ss_hash_int, ss_compare_int, NULL);
+    for (int i = 0; i < 20; i++)
+    {
+        ss_obtree_set(&chain, &i, sizeof(i), NULL, 0);
+    }
+    ss_obtree_stats(&chain, &stats);
+    assert(stats.size == 20);
+    assert(stats.height >= 5 && stats.height <= 20);
+    assert(stats.mean_depth >= 1.0 && stats.mean_depth <= (double)stats.height);
+    size_t counted = 0;
+    for (int i = 0; i < SS_OBTREE_DEPTH_HISTOGRAM_SIZE; i++)
+    {
+        counted += stats.depth_histogram[i];
+    }
+    assert(counted == 20);
+    assert(stats.depth_histogram[0] == 1);
+    assert(stats.bytes == sizeof(ss_obtree_t) + 20 * (sizeof(ss_obtree_node_t) + sizeof(int)));
+    ss_obtree_destroy(&chain);
+    printf("[OK] ss_obtree_stats: Shape statistics test passed\n");
+
+    // Test AVL balancing: a monotonic hash would degenerate an unbalanced tree into a list
+    ss_obtree_t avl;
+    ss_obtree_init(&avl, ss_hash_int, ss_compare_int, NULL);
+    for (int i = 0; i < 1024; i++)
+    {
+        ss_obtree_set(&avl, &i, sizeof(i), &i, sizeof(i));
+    }
+    assert(avl.size == 1024);
+    assert(verify_avl(&avl, avl.root, NULL) == 11); // Sequential inserts fill every level
+    ss_obtree_stats(&avl, &stats);
+    assert(stats.height == 11);
+
+    // Churn: remove odd keys, reinsert some, remove a contiguous range
+    ss_obtree_node_t* kept = ss_obtree_get(&avl, &(int){512}, sizeof(int));
+    for (int i = 1; i < 1024; i += 2)
+    {
+        assert(ss_obtree_remove(&avl, &i, sizeof(i)));
+    }
+    verify_avl(&avl, avl.root, NULL);
+    for (int i = 1; i < 1024; i += 4)
+    {
+        ss_obtree_set(&avl, &i, sizeof(i), &i, sizeof(i));
+    }
+    for (int i = 100; i < 700; i++)
+    {
+        if (i != 512)
+        {
+            ss_obtree_remove(&avl, &i, sizeof(i));
+        }
+        verify_avl(&avl, avl.root, NULL);
+    }
+    assert(avl.size == 768 - 449); // 299 even and 150 odd keys in [100, 700) are gone
+    // Removals move nodes instead of copying entries, so node handles stay valid
+    assert(ss_obtree_get(&avl, &(int){512}, sizeof(int)) == kept);
+    assert(*(int*)kept->entry.value == 512);
+    for (int i = 0; i < 1024; i++)
+    {
+        int present = i == 512 || i < 100 || i >= 700 ? (i % 2 == 0 || i % 4 == 1) : 0;
+        assert((ss_obtree_get(&avl, &i, sizeof(i)) != NULL) == present);
+    }
+    ss_obtree_destroy(&avl);
+    printf("[OK] ss_obtree balancing: AVL invariants hold under insert/remove churn\n");
+
+    // Test sorted mode: keys 0, 10, ..., 990 inserted in scrambled order
+    ss_obtree_t sorted;
+    ss_obtree_init_sorted(&sorted, ss_compare_int, NULL);
+    assert(ss_obtree_first(&sorted) == NULL && ss_obtree_last(&sorted) == NULL);
+    for (int i = 0; i < 100; i++)
+    {
+        int k = (i * 37) % 100 * 10;
+        ss_obtree_set(&sorted, &k, sizeof(k), NULL, 0);
+    }
+    verify_avl(&sorted, sorted.root, NULL);
+    int expect = 0;
+    for (ss_obtree_node_t* n = ss_obtree_first(&sorted); n; n = ss_obtree_next(n))
+    {
+        assert(*(int*)n->entry.key == expect);
+        expect += 10;
+    }
+    assert(expect == 1000);
+    for (ss_obtree_node_t* n = ss_obtree_last(&sorted); n; n = ss_obtree_prev(n))
+    {
+        expect -= 10;
+        assert(*(int*)n->entry.key == expect);
+    }
+    assert(expect == 0);
+    printf("[OK] ss_obtree_first/last/next/prev: Sorted iteration test passed\n");
+
+    int probe = 250;
+    assert(*(int*)ss_obtree_lower_bound(&sorted, &probe, sizeof(probe))->entry.key == 250);
+    assert(*(int*)ss_obtree_upper_bound(&sorted, &probe, sizeof(probe))->entry.key == 260);
+    probe = 255;
+    assert(*(int*)ss_obtree_lower_bound(&sorted, &probe, sizeof(probe))->entry.key == 260);
+    assert(*(int*)ss_obtree_upper_bound(&sorted, &probe, sizeof(probe))->entry.key == 260);
+    probe = -1;
+    assert(ss_obtree_lower_bound(&sorted, &probe, sizeof(probe)) == ss_obtree_first(&sorted));
+    probe = 990;
+    assert(ss_obtree_upper_bound(&sorted, &probe, sizeof(probe)) == NULL);
+    printf("[OK] ss_obtree_lower_bound/upper_bound: Bound test passed\n");
+
+    int lo = 95, hi = 150;
+    int got[9] = {0};
+    assert(!ss_obtree_range(&sorted, &lo, sizeof(lo), &hi, sizeof(hi), collect_int, got));
+    assert(got[0] == 5 && got[1] == 100 && got[5] == 140); // hi is exclusive
+    memset(got, 0, sizeof(got));
+    assert(ss_obtree_range(&sorted, NULL, 0, NULL, 0, collect_int, got)); // Stopped at 8
+    assert(got[0] == 8 && got[1] == 0 && got[8] == 70);
+    size_t visited = 0;
+    lo = 500;
+    hi = 500;
+    ss_obtree_range(&sorted, &lo, sizeof(lo), &hi, sizeof(hi), count_node, &visited);
+    assert(visited == 0);
+    ss_obtree_range(&sorted, &lo, sizeof(lo), NULL, 0, count_node, &visited);
+    assert(visited == 50);
+    ss_obtree_destroy(&sorted);
+
+    // Prefix scan over byte-string keys
+    ss_obtree_init_sorted(&sorted, ss_compare_mem, NULL);
+    const char* paths[] = {"user/7", "user", "users", "user/10", "admin/1", "user/1", "uses"};
+    for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++)
+    {
+        ss_obtree_set(&sorted, paths[i], strlen(paths[i]), NULL, 0);
+    }
+    visited = 0;
+    // '0' follows '/', so ["user/", "user0") holds every key starting with "user/"
+    ss_obtree_range(&sorted, "user/", 5, "user0", 5, count_node, &visited);
+    assert(visited == 3);
+    assert(ss_obtree_remove(&sorted, "user", 4));
+    assert(memcmp(ss_obtree_first(&sorted)->entry.key, "admin/1", 7) == 0);
+    assert(memcmp(ss_obtree_next(ss_obtree_first(&sorted))->entry.key, "user/1", 6) == 0);
+    ss_obtree_destroy(&sorted);
+    printf("[OK] ss_obtree_range: Range and prefix scan test passed\n");
+
+    // Test rank/select over a sliding window of even keys
+    ss_obtree_t stats_tree;
+    ss_obtree_init_sorted(&stats_tree, ss_compare_int, NULL);
+    assert(ss_obtree_select(&stats_tree, 0) == NULL);
+    for (int i = 0; i < 1000; i++)
+    {
+        int k = (i * 7919) % 1000 * 2;
+        ss_obtree_set(&stats_tree, &k, sizeof(k), NULL, 0);
+    }
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(*(int*)ss_obtree_select(&stats_tree, (size_t)i)->entry.key == i * 2);
+        int k = i * 2;
+        assert(ss_obtree_rank(&stats_tree, &k, sizeof(k)) == (size_t)i);
+        k++; // Absent keys rank after their smaller neighbour
+        assert(ss_obtree_rank(&stats_tree, &k, sizeof(k)) == (size_t)i + 1);
+    }
+    assert(ss_obtree_select(&stats_tree, 1000) == NULL);
+    for (int i = 0; i < 400; i++)
+    {
+        int k = i * 2;
+        ss_obtree_remove(&stats_tree, &k, sizeof(k)); // Slide the window to [800, 1998]
+        k = 2000 + i * 2;
+        ss_obtree_set(&stats_tree, &k, sizeof(k), NULL, 0);
+    }
+    verify_avl(&stats_tree, stats_tree.root, NULL);
+    assert(stats_tree.root->count == 1000);
+    ss_obtree_node_t* median = ss_obtree_select(&stats_tree, stats_tree.size / 2);
+    assert(*(int*)median->entry.key == 800 + 1000);
+    assert(*(int*)ss_obtree_select(&stats_tree, stats_tree.size * 99 / 100)->entry.key == 2780);
+    int probe_rank = 0;
+    assert(ss_obtree_rank(&stats_tree, &probe_rank, sizeof(int)) == 0);
+    probe_rank = 9999;
+    assert(ss_obtree_rank(&stats_tree, &probe_rank, sizeof(int)) == 1000);
+    ss_obtree_destroy(&stats_tree);
+    printf("[OK] ss_obtree_select/rank: Order statistics test passed\n");
+
+    // Test linear-time bulk build from sorted entries
+    static int build_keys[1000];
+    static ss_entry_t build_entries[1001];
+    for (int i = 0; i < 1000; i++)
+    {
+        build_keys[i] = i * 3;
+        build_entries[i].key = &build_keys[i];
+        build_entries[i].ksize = sizeof(int);
+        build_entries[i].value = &build_keys[i];
+        build_entries[i].vsize = sizeof(int);
+    }
+    ss_obtree_t built;
+    ss_obtree_init_sorted(&built, ss_compare_int, NULL);
+    assert(ss_obtree_build_sorted(&built, build_entries, 0) && built.root == NULL);
+    assert(ss_obtree_build_sorted(&built, build_entries, 1000));
+    assert(built.size == 1000 && built.block_size == 1000);
+    assert(verify_avl(&built, built.root, NULL) == 10); // Optimal height for 1000 nodes
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(ss_obtree_select(&built, (size_t)i)->entry.key != &build_keys[i]); // Copied
+        assert(*(int*)ss_obtree_select(&built, (size_t)i)->entry.value == i * 3);
+    }
+    assert(!ss_obtree_build_sorted(&built, build_entries, 10)); // Not empty
+    // Block and heap nodes mix under later inserts and removes
+    for (int i = 0; i < 1000; i += 2)
+    {
+        int k = i * 3 + 1;
+        ss_obtree_set(&built, &k, sizeof(k), NULL, 0);
+        k = i * 3;
+        assert(ss_obtree_remove(&built, &k, sizeof(k)));
+    }
+    verify_avl(&built, built.root, NULL);
+    assert(built.size == 1000);
+    ss_obtree_destroy(&built);
+    assert(built.block == NULL);
+
+    // Out-of-order input is rejected and leaves the tree empty
+    build_entries[500].key = &build_keys[499];
+    assert(!ss_obtree_build_sorted(&built, build_entries, 1000));
+    assert(built.root == NULL && built.size == 0 && built.block == NULL);
+    build_entries[500].key = &build_keys[500];
+
+    // A hashed tree rebuilds from its own in-order dump
+    ss_obtree_t hashed;
+    ss_obtree_init(&hashed, ss_hash_int, ss_compare_int, NULL);
+    for (int i = 0; i < 1000; i++)
+    {
+        ss_obtree_set(&hashed, &build_keys[i], sizeof(int), NULL, 0);
+    }
+    memset(build_entries, 0, sizeof(build_entries));
+    ss_obtree_inorder(&hashed, collect_entry, build_entries);
+    assert(build_entries[0].ksize == 1000);
+    ss_obtree_init(&built, ss_hash_int, ss_compare_int, NULL);
+    assert(ss_obtree_build_sorted(&built, build_entries + 1, 1000));
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(ss_obtree_get(&built, &build_keys[i], sizeof(int)) != NULL);
+        assert(!ss_obtree_remove(&built, &(int){i * 3 + 1}, sizeof(int)));
+    }
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(ss_obtree_remove(&built, &build_keys[i], sizeof(int)));
+    }
+    assert(built.root == NULL && built.block == NULL); // Freed once empty
+    ss_obtree_destroy(&built);
+    ss_obtree_destroy(&hashed);
+    printf("[OK] ss_obtree_build_sorted: Bulk build test passed\n");
+
+    // Test traversal order and depths on a perfect tree: 4 / 2 6 / 1 3 5 7
+    ss_obtree_t walk;
+    ss_obtree_init_sorted(&walk, ss_compare_int, NULL);
+    const int walk_keys[] = {4, 2, 6, 1, 3, 5, 7};
+    for (int i = 0; i < 7; i++)
+    {
+        ss_obtree_set(&walk, &walk_keys[i], sizeof(int), NULL, 0);
+    }
+    const int pre[] = {4, 0, 2, 1, 1, 2, 3, 2, 6, 1, 5, 2, 7, 2};
+    const int in[] = {1, 2, 2, 1, 3, 2, 4, 0, 5, 2, 6, 1, 7, 2};
+    const int post[] = {1, 2, 3, 2, 2, 1, 5, 2, 7, 2, 6, 1, 4, 0};
+    int rec[2 + 14] = {0};
+    assert(!ss_obtree_preorder(&walk, record_order, rec) && rec[1] == 7);
+    assert(memcmp(rec + 2, pre, sizeof(pre)) == 0);
+    memset(rec, 0, sizeof(rec));
+    assert(!ss_obtree_inorder(&walk, record_order, rec) && rec[1] == 7);
+    assert(memcmp(rec + 2, in, sizeof(in)) == 0);
+    memset(rec, 0, sizeof(rec));
+    assert(!ss_obtree_postorder(&walk, record_order, rec) && rec[1] == 7);
+    assert(memcmp(rec + 2, post, sizeof(post)) == 0);
+    // A stop anywhere, including inside a subtree, ends the whole traversal
+    memset(rec, 0, sizeof(rec));
+    rec[0] = 3;
+    assert(ss_obtree_inorder(&walk, record_order, rec) && rec[1] == 3);
+    memset(rec, 0, sizeof(rec));
+    rec[0] = 3;
+    assert(ss_obtree_postorder(&walk, record_order, rec) && rec[1] == 2);
+    printf("[OK] ss_obtree traversals: Iterative order, depth and stop test passed\n");
+
+    // Test a post-order teardown that frees every node, for sizes of both parities
+    const size_t teardown_sizes[] = {1, 2, 3, 4, 7, 8, 100, 1000};
+    for (size_t n = 0; n < sizeof(teardown_sizes) / sizeof(teardown_sizes[0]); n++)
+    {
+        ss_obtree_t teardown;
+        ss_obtree_init_sorted(&teardown, ss_compare_int, NULL);
+        ss_obtree_set_borrow(&teardown, SS_BORROW_KEY, NULL, NULL);
+        for (size_t i = 0; i < teardown_sizes[n]; i++)
+        {
+            ss_obtree_set(&teardown, &build_keys[i], sizeof(int), NULL, 0);
+        }
+        size_t freed = 0;
+        assert(!ss_obtree_postorder(&teardown, free_node, &freed));
+        assert(freed == teardown_sizes[n]);
+        ss_obtree_init_sorted(&teardown, ss_compare_int, NULL);
+        assert(teardown.root == NULL && teardown.size == 0);
+    }
+    printf("[OK] ss_obtree_postorder: Freeing teardown test passed\n");
+
+    // Test cursors
+    ss_obtree_cursor_t cursor;
+    ss_obtree_cursor_init(&cursor, &walk);
+    assert(ss_obtree_cursor_node(&cursor) == NULL && !ss_obtree_cursor_next(&cursor));
+    int probe_key = 5;
+    assert(ss_obtree_cursor_seek(&cursor, &probe_key, sizeof(int)));
+    assert(ss_obtree_cursor_next(&cursor) && ss_obtree_cursor_next(&cursor));
+    assert(*(int*)ss_obtree_cursor_node(&cursor)->entry.key == 7);
+    assert(!ss_obtree_cursor_next(&cursor) && !ss_obtree_cursor_prev(&cursor));
+    assert(ss_obtree_cursor_last(&cursor));
+    int steps = 1;
+    while (ss_obtree_cursor_prev(&cursor))
+    {
+        steps++;
+    }
+    assert(steps == 7 && ss_obtree_cursor_first(&cursor));
+    assert(*(int*)ss_obtree_cursor_node(&cursor)->entry.key == 1);
+    ss_obtree_destroy(&walk);
+
+    // In hash mode a seek lands on the key itself, steps follow hash order
+    ss_obtree_init(&walk, ss_hash_int, ss_compare_int, NULL);
+    for (int i = 0; i < 50; i++)
+    {
+        ss_obtree_set(&walk, &i, sizeof(i), NULL, 0);
+    }
+    ss_obtree_cursor_init(&cursor, &walk);
+    probe_key = 17;
+    assert(ss_obtree_cursor_seek(&cursor, &probe_key, sizeof(int)));
+    assert(ss_obtree_cursor_node(&cursor) == ss_obtree_get(&walk, &probe_key, sizeof(int)));
+    steps = 0;
+    for (ss_obtree_cursor_first(&cursor); ss_obtree_cursor_node(&cursor);
+         ss_obtree_cursor_next(&cursor))
+    {
+        steps++;
+    }
+    assert(steps == 50);
+    ss_obtree_destroy(&walk);
+    printf("[OK] ss_obtree_cursor: Cursor test passed\n");
+
+    // Test split at present and absent keys, then joining the parts back in order
+    ss_obtree_t parts[4];
+    ss_obtree_init_sorted(&parts[0], ss_compare_int, NULL);
+    for (int i = 0; i < 2000; i += 2)
+    {
+        ss_obtree_set(&parts[0], &i, sizeof(i), &i, sizeof(i));
+    }
+    const int cuts[] = {1500, 1000, 501}; // Shards 0 < 3 < 2 < 1; the last key is absent
+    for (int i = 1; i < 4; i++)
+    {
+        ss_obtree_init(&parts[i], NULL, NULL, NULL); // Settings come from the split tree
+        assert(ss_obtree_split(&parts[0], &cuts[i - 1], sizeof(int), &parts[i]));
+    }
+    assert(!ss_obtree_split(&parts[0], &cuts[0], sizeof(int), &parts[1])); // Not empty
+    const size_t part_sizes[] = {251, 250, 250, 249};
+    for (int i = 0; i < 4; i++)
+    {
+        assert(parts[i].size == part_sizes[i] && parts[i].root->count == part_sizes[i]);
+        verify_avl(&parts[i], parts[i].root, NULL);
+    }
+    assert(*(int*)ss_obtree_first(&parts[2])->entry.key == 1000);
+    assert(*(int*)ss_obtree_last(&parts[3])->entry.key == 998);
+    assert(*(int*)ss_obtree_first(&parts[3])->entry.key == 502);
+    assert(!ss_obtree_join(&parts[1], &parts[3])); // Out of order
+    assert(ss_obtree_join(&parts[2], &parts[1]) && parts[1].size == 0 && !parts[1].root);
+    assert(ss_obtree_join(&parts[3], &parts[2]) && ss_obtree_join(&parts[0], &parts[3]));
+    assert(parts[0].size == 1000);
+    assert(verify_avl(&parts[0], parts[0].root, NULL) <= 11);
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(*(int*)ss_obtree_select(&parts[0], (size_t)i)->entry.value == 2 * i);
+    }
+    // Joins of very different heights, and splits past either end
+    int key = -1;
+    assert(ss_obtree_split(&parts[0], &key, sizeof(key), &parts[1]));
+    assert(parts[0].size == 0 && parts[1].size == 1000);
+    assert(ss_obtree_join(&parts[0], &parts[1]) && parts[0].size == 1000);
+    key = 2000;
+    assert(ss_obtree_split(&parts[0], &key, sizeof(key), &parts[1]) && parts[1].size == 0);
+    ss_obtree_set(&parts[1], &key, sizeof(key), NULL, 0);
+    assert(ss_obtree_join(&parts[0], &parts[1]) && parts[0].size == 1001);
+    key = 0;
+    assert(ss_obtree_split(&parts[0], &(int){2}, sizeof(int), &parts[1]) && parts[0].size == 1);
+    assert(ss_obtree_join(&parts[0], &parts[1]) && parts[0].size == 1001);
+    verify_avl(&parts[0], parts[0].root, NULL);
+    for (int i = 0; i < 4; i++)
+    {
+        ss_obtree_destroy(&parts[i]);
+    }
+    printf("[OK] ss_obtree_split/join: Split and join test passed\n");
+
+    // Test merge of overlapping trees: the target keeps its entries on duplicates
+    ss_obtree_t evens, thirds;
+    ss_obtree_init_sorted(&evens, ss_compare_int, NULL);
+    ss_obtree_init_sorted(&thirds, ss_compare_int, NULL);
+    for (int i = 0; i < 3000; i++)
+    {
+        int tag = i % 2 == 0 ? 2 : 3;
+        if (i % 2 == 0)
+        {
+            ss_obtree_set(&evens, &i, sizeof(i), &tag, sizeof(tag));
+        }
+        if (i % 3 == 0)
+        {
+            tag = 3;
+            ss_obtree_set(&thirds, &i, sizeof(i), &tag, sizeof(tag));
+        }
+    }
+    assert(ss_obtree_merge(&evens, &thirds) && thirds.size == 0 && !thirds.root);
+    assert(evens.size == 1500 + 1000 - 500);
+    verify_avl(&evens, evens.root, NULL);
+    for (int i = 0; i < 3000; i++)
+    {
+        ss_obtree_node_t* node = ss_obtree_get(&evens, &i, sizeof(i));
+        assert(!node == (i % 2 != 0 && i % 3 != 0));
+        assert(!node || *(int*)node->entry.value == (i % 2 == 0 ? 2 : 3));
+    }
+    // Bulk-built blocks move with their nodes: adopted, or detached when both have one
+    for (int i = 0; i < 1000; i++)
+    {
+        build_entries[i].key = &build_keys[i]; // Keys 0, 3, .. 2997
+        build_entries[i].ksize = sizeof(int);
+        build_entries[i].value = NULL;
+        build_entries[i].vsize = 0;
+    }
+    ss_obtree_init_sorted(&built, ss_compare_int, NULL);
+    assert(ss_obtree_build_sorted(&built, build_entries, 1000));
+    assert(ss_obtree_merge(&thirds, &built) && thirds.block && !built.block);
+    assert(ss_obtree_build_sorted(&built, build_entries, 1000));
+    assert(ss_obtree_merge(&thirds, &built) && thirds.size == 1000 && !built.block);
+    assert(ss_obtree_merge(&evens, &thirds) && evens.size == 2000 && evens.block); // Duplicates
+    verify_avl(&evens, evens.root, NULL);
+    assert(ss_obtree_build_sorted(&built, build_entries, 1000));
+    key = 1500;
+    assert(ss_obtree_split(&built, &key, sizeof(key), &thirds) && !built.block);
+    assert(built.size == 500 && thirds.size == 500);
+    assert(ss_obtree_join(&built, &thirds) && built.size == 1000);
+    verify_avl(&built, built.root, NULL);
+    ss_obtree_init(&hashed, ss_hash_int, ss_compare_int, NULL);
+    assert(!ss_obtree_merge(&evens, &hashed) && !ss_obtree_join(&hashed, &evens));
+    ss_obtree_destroy(&hashed);
+    ss_obtree_destroy(&built);
+    ss_obtree_destroy(&thirds);
+    ss_obtree_destroy(&evens);
+    printf("[OK] ss_obtree_merge: Merge test passed\n");
+
     // Cleanup
     ss_obtree_destroy(&tree);
     printf("[OK] ss_obtree_destroy: Cleanup completed\n");
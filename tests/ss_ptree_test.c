@@ -0,0 +1,225 @@
+#include "ss_compare.h"
+#include "ss_ptree.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_KEYS 1024
+
+// Helper function checking order, AVL balance and stored heights; returns the node count
+static size_t verify_node(const ss_ptree_node_t* node, const int* lo, const int* hi)
+{
+    if (!node)
+    {
+        return 0;
+    }
+    int key = *(const int*)node->entry.key;
+    assert(!lo || *lo < key);
+    assert(!hi || key < *hi);
+    assert(node->refs >= 1);
+    int lh = node->left ? node->left->height : 0;
+    int rh = node->right ? node->right->height : 0;
+    assert(lh - rh <= 1 && rh - lh <= 1);
+    assert(node->height == (lh > rh ? lh : rh) + 1);
+    return verify_node(node->left, lo, &key) + 1 + verify_node(node->right, &key, hi);
+}
+
+// Helper function checking a snapshot holds exactly the keys with present[key] set,
+// each mapped to key * 10 + present[key]
+static void verify_snapshot(const ss_ptree_snapshot_t* s, const int* present, int n)
+{
+    size_t count = 0;
+    assert(verify_node(s->root, NULL, NULL) == s->size);
+    for (int k = 0; k < n; k++)
+    {
+        const ss_entry_t* e = ss_ptree_snapshot_get(s, &k, sizeof(k));
+        assert(!e == !present[k]);
+        if (e)
+        {
+            assert(e->vsize == sizeof(int) && *(int*)e->value == k * 10 + present[k]);
+            count++;
+        }
+    }
+    assert(count == s->size);
+}
+
+// Helper function collecting visited keys into an int array
+static ss_bool_t collect_cb(const ss_ptree_snapshot_t* s, const ss_entry_t* entry, void* param)
+{
+    int* out = (int*)param;
+    (void)s;
+    out[++out[0]] = *(int*)entry->key;
+    return SS_FALSE;
+}
+
+// Helper function stopping a scan after five keys
+static ss_bool_t stop_cb(const ss_ptree_snapshot_t* s, const ss_entry_t* entry, void* param)
+{
+    int* out = (int*)param;
+    (void)s;
+    out[++out[0]] = *(int*)entry->key;
+    return out[0] == 5;
+}
+
+void test_ptree()
+{
+    printf("\n=== Starting ss_ptree tests ===\n");
+
+    ss_ptree_t tree;
+    ss_ptree_snapshot_t snap;
+    int present[TEST_KEYS];
+    int i, value;
+
+    // Test set, replace, get and remove on the current version
+    ss_ptree_init(&tree, ss_compare_int);
+    for (i = 0; i < TEST_KEYS; i++)
+    {
+        value = i * 10;
+        assert(ss_ptree_set(&tree, &i, sizeof(i), &value, sizeof(value)));
+    }
+    assert(ss_ptree_size(&tree) == TEST_KEYS);
+    assert(tree.root->height == 11); // Monotonic inserts stay balanced
+    assert(verify_node(tree.root, NULL, NULL) == TEST_KEYS);
+    i = 7;
+    value = 71;
+    assert(ss_ptree_set(&tree, &i, sizeof(i), &value, sizeof(value)));
+    assert(ss_ptree_size(&tree) == TEST_KEYS);
+    assert(*(int*)ss_ptree_get(&tree, &i, sizeof(i))->value == 71);
+    assert(ss_ptree_remove(&tree, &i, sizeof(i)));
+    assert(!ss_ptree_remove(&tree, &i, sizeof(i)));
+    assert(!ss_ptree_get(&tree, &i, sizeof(i)));
+    assert(ss_ptree_size(&tree) == TEST_KEYS - 1);
+    ss_ptree_destroy(&tree);
+    assert(!tree.root && ss_ptree_size(&tree) == 0);
+    printf("[OK] ss_ptree_set/get/remove: Basic operations test passed\n");
+
+    // Test that an update copies only the search path and shares everything else
+    ss_ptree_init(&tree, ss_compare_int);
+    for (i = 0; i < TEST_KEYS; i++)
+    {
+        value = i * 10;
+        assert(ss_ptree_set(&tree, &i, sizeof(i), &value, sizeof(value)));
+    }
+    ss_ptree_snapshot(&tree, &snap);
+    assert(snap.root == tree.root && snap.root->refs == 2);
+    i = 0;
+    value = 1;
+    assert(ss_ptree_set(&tree, &i, sizeof(i), &value, sizeof(value)));
+    assert(snap.root != tree.root && snap.root->refs == 1);
+    assert(tree.root->right == snap.root->right && tree.root->right->refs == 2);
+    assert(tree.root->left != snap.root->left);
+    assert(*(int*)ss_ptree_snapshot_get(&snap, &i, sizeof(i))->value == 0);
+    assert(*(int*)ss_ptree_get(&tree, &i, sizeof(i))->value == 1);
+    ss_ptree_snapshot_release(&snap);
+    assert(tree.root->right->refs == 1);
+    printf("[OK] ss_ptree_set: Path copying test passed\n");
+
+    // Test that snapshots keep their version across removals and outlive the tree
+    ss_ptree_snapshot_t before, after;
+    ss_ptree_snapshot(&tree, &before);
+    for (i = 0; i < TEST_KEYS; i += 2)
+    {
+        assert(ss_ptree_remove(&tree, &i, sizeof(i)));
+    }
+    ss_ptree_snapshot(&tree, &after);
+    ss_ptree_destroy(&tree);
+    assert(ss_ptree_snapshot_size(&before) == TEST_KEYS);
+    assert(ss_ptree_snapshot_size(&after) == TEST_KEYS / 2);
+    i = 0;
+    assert(*(int*)ss_ptree_snapshot_get(&before, &i, sizeof(i))->value == 1);
+    assert(verify_node(before.root, NULL, NULL) == TEST_KEYS);
+    for (i = 1; i < TEST_KEYS; i += 2)
+    {
+        assert(*(int*)ss_ptree_snapshot_get(&after, &i, sizeof(i))->value == i * 10);
+        assert(*(int*)ss_ptree_snapshot_get(&before, &i, sizeof(i))->value == i * 10);
+    }
+    for (i = 2; i < TEST_KEYS; i += 2)
+    {
+        assert(!ss_ptree_snapshot_get(&after, &i, sizeof(i)));
+        assert(*(int*)ss_ptree_snapshot_get(&before, &i, sizeof(i))->value == i * 10);
+    }
+    assert(verify_node(after.root, NULL, NULL) == TEST_KEYS / 2);
+    ss_ptree_snapshot_release(&before);
+    assert(verify_node(after.root, NULL, NULL) == TEST_KEYS / 2);
+    ss_ptree_snapshot_release(&after);
+    assert(!after.root && ss_ptree_snapshot_size(&after) == 0);
+    printf("[OK] ss_ptree_snapshot: Isolation and lifetime test passed\n");
+
+    // Test ordered range scans on a snapshot, including early stop
+    ss_ptree_init(&tree, ss_compare_int);
+    for (i = 99; i >= 0; i--)
+    {
+        assert(ss_ptree_set(&tree, &i, sizeof(i), NULL, 0));
+    }
+    ss_ptree_snapshot(&tree, &snap);
+    ss_ptree_clear(&tree);
+    assert(ss_ptree_size(&tree) == 0 && ss_ptree_snapshot_size(&snap) == 100);
+    int keys[128], lo = 10, hi = 20;
+    keys[0] = 0;
+    assert(!ss_ptree_snapshot_range(&snap, &lo, sizeof(lo), &hi, sizeof(hi), collect_cb, keys));
+    assert(keys[0] == 10);
+    for (i = 0; i < 10; i++)
+    {
+        assert(keys[i + 1] == 10 + i);
+    }
+    keys[0] = 0;
+    assert(!ss_ptree_snapshot_range(&snap, NULL, 0, &lo, sizeof(lo), collect_cb, keys));
+    assert(keys[0] == 10 && keys[1] == 0 && keys[10] == 9);
+    keys[0] = 0;
+    lo = 95;
+    assert(!ss_ptree_snapshot_range(&snap, &lo, sizeof(lo), NULL, 0, collect_cb, keys));
+    assert(keys[0] == 5 && keys[1] == 95 && keys[5] == 99);
+    keys[0] = 0;
+    assert(!ss_ptree_snapshot_iterate(&snap, collect_cb, keys));
+    assert(keys[0] == 100);
+    for (i = 0; i < 100; i++)
+    {
+        assert(keys[i + 1] == i);
+    }
+    keys[0] = 0;
+    lo = 50;
+    assert(ss_ptree_snapshot_range(&snap, &lo, sizeof(lo), NULL, 0, stop_cb, keys));
+    assert(keys[0] == 5 && keys[1] == 50 && keys[5] == 54);
+    ss_ptree_snapshot_release(&snap);
+    ss_ptree_destroy(&tree);
+    printf("[OK] ss_ptree_snapshot_range: Ordered scan test passed\n");
+
+    // Test random churn against a reference, checking every kept snapshot at the end
+    ss_ptree_snapshot_t snaps[8];
+    int expected[8][TEST_KEYS];
+    unsigned int seed = 12345;
+    ss_ptree_init(&tree, ss_compare_int);
+    memset(present, 0, sizeof(present));
+    for (int round = 0; round < 8; round++)
+    {
+        for (int op = 0; op < 2000; op++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            int k = (int)((seed >> 8) % TEST_KEYS);
+            if (seed & 0x80000000u)
+            {
+                present[k] = present[k] % 9 + 1;
+                value = k * 10 + present[k];
+                assert(ss_ptree_set(&tree, &k, sizeof(k), &value, sizeof(value)));
+            }
+            else
+            {
+                assert(ss_ptree_remove(&tree, &k, sizeof(k)) == (present[k] != 0));
+                present[k] = 0;
+            }
+        }
+        ss_ptree_snapshot(&tree, &snaps[round]);
+        memcpy(expected[round], present, sizeof(present));
+    }
+    ss_ptree_destroy(&tree);
+    for (int round = 0; round < 8; round++)
+    {
+        // Release in an interleaved order so shared subtrees outlive their creators
+        int r = (round * 3) % 8;
+        verify_snapshot(&snaps[r], expected[r], TEST_KEYS);
+        ss_ptree_snapshot_release(&snaps[r]);
+    }
+    printf("[OK] ss_ptree: Random churn with snapshots test passed\n");
+
+    printf("=== All ss_ptree tests passed ===\n");
+}
@@ -0,0 +1,256 @@
+#include "ss_compare.h"
+#include "ss_skiplist.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#define TEST_THREADS 8
+#endif
+
+#define TEST_KEYS 2048
+
+// Helper function counting the nodes waiting on a handle's limbo lists
+static size_t limbo_count(const ss_skiplist_thread_t* th)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < 3; i++)
+    {
+        for (const ss_skiplist_node_t* node = th->limbo[i]; node; node = node->limbo)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+// Helper function checking every level is sorted and a sublist of the level below
+static size_t verify_levels(ss_skiplist_t* sl)
+{
+    size_t size = 0;
+    for (int level = SS_SKIPLIST_MAX_LEVEL - 1; level >= 0; level--)
+    {
+        const ss_skiplist_node_t* prev = NULL;
+        size_t count = 0;
+        for (uintptr_t p = sl->head->next[level]; p; p = ((ss_skiplist_node_t*)p)->next[level])
+        {
+            const ss_skiplist_node_t* node = (const ss_skiplist_node_t*)p;
+            assert((p & 1) == 0 && (uint32_t)level < node->height);
+            assert(!prev || sl->key_compare(prev->entry.key, prev->entry.ksize, node->entry.key,
+                                            node->entry.ksize) < 0);
+            prev = node;
+            count++;
+        }
+        assert(count >= size);
+        size = count;
+    }
+    return size;
+}
+
+// Helper function collecting visited keys into an int array
+static ss_bool_t collect_cb(ss_skiplist_t* sl, const ss_entry_t* entry, void* param)
+{
+    int* out = (int*)param;
+    (void)sl;
+    out[++out[0]] = *(int*)entry->key;
+    return out[0] == 5 && out[1] < 0; // A negative first key asks to stop after five
+}
+
+// Helper function removing keys through a second handle while a scan is in progress
+static ss_bool_t remove_ahead_cb(ss_skiplist_t* sl, const ss_entry_t* entry, void* param)
+{
+    ss_skiplist_thread_t* other = (ss_skiplist_thread_t*)param;
+    int key = *(int*)entry->key;
+    (void)sl;
+    for (int k = key + 1; k < key + 4; k++)
+    {
+        ss_skiplist_remove(other, &k, sizeof(k));
+    }
+    return SS_FALSE;
+}
+
+#ifdef TEST_THREADS
+// Helper function summing visited keys, so range scans read every node they pass
+static ss_bool_t sum_cb(ss_skiplist_t* sl, const ss_entry_t* entry, void* param)
+{
+    (void)sl;
+    *(int*)param += *(int*)entry->key;
+    return SS_FALSE;
+}
+
+// Helper function hammering a few keys, so inserts race with removes of the same key
+static void* stress_worker(void* param)
+{
+    ss_skiplist_thread_t* th = (ss_skiplist_thread_t*)param;
+    unsigned int seed = th->seed;
+    int sum = 0, lo = 2, hi = 6;
+    for (int i = 0; i < 20000; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        int k = (int)((seed >> 16) % 8), value = k;
+        switch ((seed >> 8) % 4)
+        {
+        case 0:
+            ss_skiplist_insert(th, &k, sizeof(k), &value, sizeof(value));
+            break;
+        case 1:
+            ss_skiplist_remove(th, &k, sizeof(k));
+            break;
+        case 2:
+            value = -1;
+            assert(!ss_skiplist_get(th, &k, sizeof(k), &value, sizeof(value)) || value == k);
+            break;
+        default:
+            ss_skiplist_range(th, &lo, sizeof(lo), &hi, sizeof(hi), sum_cb, &sum);
+            break;
+        }
+    }
+    return NULL;
+}
+
+// Helper function checking no retired node is still linked at any level
+static void verify_retired(ss_skiplist_t* sl)
+{
+    for (int level = 0; level < SS_SKIPLIST_MAX_LEVEL; level++)
+    {
+        for (uintptr_t p = sl->head->next[level]; p; p = ((ss_skiplist_node_t*)p)->next[level])
+        {
+            for (size_t i = 0; i < SS_SKIPLIST_MAX_THREADS; i++)
+            {
+                for (size_t j = 0; j < 3; j++)
+                {
+                    for (ss_skiplist_node_t* node = sl->threads[i].limbo[j]; node;
+                         node = node->limbo)
+                    {
+                        assert((uintptr_t)node != p);
+                    }
+                }
+            }
+        }
+    }
+}
+#endif
+
+void test_skiplist()
+{
+    printf("\n=== Starting ss_skiplist tests ===\n");
+
+    ss_skiplist_t sl;
+    int i, value;
+
+    // Test insert, get and remove through one handle
+    assert(ss_skiplist_init(&sl, ss_compare_int));
+    ss_skiplist_thread_t* th = ss_skiplist_attach(&sl);
+    assert(th != NULL);
+    for (i = 0; i < TEST_KEYS; i++)
+    {
+        int k = (i * 7919) % TEST_KEYS; // Scrambled order
+        value = k * 10;
+        assert(ss_skiplist_insert(th, &k, sizeof(k), &value, sizeof(value)));
+    }
+    assert(ss_skiplist_size(&sl) == TEST_KEYS);
+    assert(verify_levels(&sl) == TEST_KEYS);
+    i = 5;
+    value = 1;
+    assert(!ss_skiplist_insert(th, &i, sizeof(i), &value, sizeof(value))); // Present
+    for (i = 0; i < TEST_KEYS; i++)
+    {
+        value = -1;
+        assert(ss_skiplist_get(th, &i, sizeof(i), &value, sizeof(value)) && value == i * 10);
+    }
+    i = TEST_KEYS;
+    assert(!ss_skiplist_get(th, &i, sizeof(i), NULL, 0));
+    for (i = 0; i < TEST_KEYS; i += 2)
+    {
+        assert(ss_skiplist_remove(th, &i, sizeof(i)));
+        assert(!ss_skiplist_remove(th, &i, sizeof(i)));
+    }
+    assert(ss_skiplist_size(&sl) == TEST_KEYS / 2);
+    assert(verify_levels(&sl) == TEST_KEYS / 2);
+    for (i = 0; i < TEST_KEYS; i++)
+    {
+        assert(ss_skiplist_get(th, &i, sizeof(i), NULL, 0) == (i & 1));
+    }
+    printf("[OK] ss_skiplist_insert/get/remove: Basic operations test passed\n");
+
+    // Test ordered range scans and early stop
+    int keys[TEST_KEYS + 1], lo = 100, hi = 120;
+    keys[0] = 0;
+    assert(!ss_skiplist_range(th, &lo, sizeof(lo), &hi, sizeof(hi), collect_cb, keys));
+    assert(keys[0] == 10 && keys[1] == 101 && keys[10] == 119);
+    keys[0] = 0;
+    assert(!ss_skiplist_iterate(th, collect_cb, keys));
+    assert(keys[0] == TEST_KEYS / 2);
+    for (i = 1; i <= keys[0]; i++)
+    {
+        assert(keys[i] == 2 * i - 1);
+    }
+    i = -7;
+    assert(ss_skiplist_insert(th, &i, sizeof(i), NULL, 0));
+    keys[0] = 0;
+    assert(ss_skiplist_iterate(th, collect_cb, keys));
+    assert(keys[0] == 5 && keys[1] == -7 && keys[5] == 7);
+    assert(ss_skiplist_remove(th, &i, sizeof(i)));
+    printf("[OK] ss_skiplist_range: Ordered scan test passed\n");
+
+    // Test that retired nodes are reclaimed in epochs, and only after a pinned scan ends
+    ss_skiplist_thread_t* other = ss_skiplist_attach(&sl);
+    assert(other != NULL && other != th);
+    assert(!ss_skiplist_iterate(th, remove_ahead_cb, other)); // Scan walks retired nodes
+    assert(ss_skiplist_size(&sl) < TEST_KEYS / 2);
+    assert(verify_levels(&sl) == ss_skiplist_size(&sl));
+    size_t pending = limbo_count(other);
+    assert(pending > 0);
+    for (i = 0; i < 4 * SS_SKIPLIST_RETIRE_BATCH; i++)
+    {
+        int k = TEST_KEYS + i;
+        assert(ss_skiplist_insert(other, &k, sizeof(k), NULL, 0));
+        assert(ss_skiplist_remove(other, &k, sizeof(k)));
+    }
+    assert(limbo_count(other) < pending + 4 * SS_SKIPLIST_RETIRE_BATCH);
+    assert(limbo_count(other) <= 3 * SS_SKIPLIST_RETIRE_BATCH);
+    ss_skiplist_detach(other);
+    assert(ss_skiplist_attach(&sl) == other); // Slot is reused
+    ss_skiplist_detach(other);
+    printf("[OK] ss_skiplist: Epoch reclamation test passed\n");
+
+    // Test variable-size keys
+    ss_skiplist_destroy(&sl);
+    assert(ss_skiplist_init(&sl, ss_compare_mem));
+    th = ss_skiplist_attach(&sl);
+    const char* words[] = {"pear", "apple", "fig", "banana", "applesauce"};
+    for (i = 0; i < 5; i++)
+    {
+        assert(ss_skiplist_insert(th, words[i], strlen(words[i]), &i, sizeof(i)));
+    }
+    assert(ss_skiplist_get(th, "fig", 3, &value, sizeof(value)) && value == 2);
+    assert(!ss_skiplist_get(th, "figs", 4, NULL, 0));
+    assert(verify_levels(&sl) == 5);
+    ss_skiplist_destroy(&sl);
+    printf("[OK] ss_skiplist: Variable-size key test passed\n");
+
+#ifdef TEST_THREADS
+    // Test concurrent inserts, removes, gets and scans on a handful of keys
+    pthread_t threads[TEST_THREADS];
+    ss_skiplist_thread_t* handles[TEST_THREADS];
+    assert(ss_skiplist_init(&sl, ss_compare_int));
+    for (i = 0; i < TEST_THREADS; i++)
+    {
+        handles[i] = ss_skiplist_attach(&sl);
+        assert(handles[i] != NULL);
+        assert(pthread_create(&threads[i], NULL, stress_worker, handles[i]) == 0);
+    }
+    for (i = 0; i < TEST_THREADS; i++)
+    {
+        assert(pthread_join(threads[i], NULL) == 0);
+        ss_skiplist_detach(handles[i]);
+    }
+    assert(verify_levels(&sl) == ss_skiplist_size(&sl));
+    verify_retired(&sl);
+    ss_skiplist_destroy(&sl);
+    printf("[OK] ss_skiplist: Concurrent stress test passed\n");
+#endif
+
+    printf("=== All ss_skiplist tests passed ===\n");
+}
@@ -0,0 +1,120 @@
+#include "ss_compare.h"
+#include "ss_hash.h"
+#include "ss_ttlmap.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+// Helper function checking that entries never expire early; value holds the deadline
+static void check_expire(ss_ttlmap_t* m, const ss_entry_t* entry, void* param)
+{
+    uint64_t deadline;
+    memcpy(&deadline, entry->value, sizeof(deadline));
+    assert(deadline <= ss_ttlmap_now(m));
+    if (param)
+    {
+        // Exact mode: the wheel is advanced one tick at a time
+        assert(deadline == ss_ttlmap_now(m));
+        (*(size_t*)param)++;
+    }
+}
+
+void test_ttlmap()
+{
+    printf("\n=== Starting ss_ttlmap tests ===\n");
+
+    // Test creation and initialization
+    ss_ttlmap_t* dynamic_map = ss_ttlmap_create(100, ss_hash_int, ss_compare_int);
+    assert(dynamic_map != NULL);
+    assert(ss_ttlmap_size(dynamic_map) == 0);
+    assert(ss_ttlmap_now(dynamic_map) == 100);
+    ss_ttlmap_free(dynamic_map);
+    printf("[OK] ss_ttlmap_create/free: Dynamic map creation test passed\n");
+
+    ss_ttlmap_t m;
+    assert(ss_ttlmap_init(&m, 0, ss_hash_int, ss_compare_int));
+    size_t expired = 0;
+    ss_ttlmap_set_expire_cb(&m, check_expire, &expired);
+
+    // Test put/get and exact expiry across level boundaries
+    const uint64_t ttls[] = {0, 1, 5, 63, 64, 65, 100, 4095, 4096, 5000, 70000};
+    const int count = (int)(sizeof(ttls) / sizeof(ttls[0]));
+    for (int i = 0; i < count; i++)
+    {
+        assert(ss_ttlmap_put(&m, &i, sizeof(i), &ttls[i], sizeof(ttls[i]), ttls[i]));
+    }
+    assert(ss_ttlmap_size(&m) == (size_t)count);
+    int k = 3;
+    size_t vsize = 0;
+    const uint64_t* v = (const uint64_t*)ss_ttlmap_get(&m, &k, sizeof(k), &vsize);
+    assert(v && *v == 63 && vsize == sizeof(uint64_t));
+    k = 0;
+    assert(ss_ttlmap_get(&m, &k, sizeof(k), NULL) == NULL); // Already due
+    printf("[OK] ss_ttlmap_put/get: Put and get test passed\n");
+
+    uint64_t t;
+    for (t = 0; t <= 70000; t++)
+    {
+        ss_ttlmap_expire_until(&m, t, 0);
+    }
+    assert(expired == (size_t)count);
+    assert(ss_ttlmap_size(&m) == 0);
+    printf("[OK] ss_ttlmap_expire_until: Exact tick expiry test passed\n");
+
+    // Test refresh and remove
+    ss_ttlmap_set_expire_cb(&m, check_expire, NULL);
+    uint64_t deadline = ss_ttlmap_now(&m) + 10;
+    k = 1;
+    assert(ss_ttlmap_put(&m, &k, sizeof(k), &deadline, sizeof(deadline), 10));
+    k = 2;
+    assert(ss_ttlmap_put(&m, &k, sizeof(k), &deadline, sizeof(deadline), 10));
+    assert(ss_ttlmap_expire_until(&m, ss_ttlmap_now(&m) + 5, 0) == 0);
+    deadline = ss_ttlmap_now(&m) + 100;
+    k = 1;
+    assert(ss_ttlmap_put(&m, &k, sizeof(k), &deadline, sizeof(deadline), 100));
+    assert(ss_ttlmap_expire_until(&m, ss_ttlmap_now(&m) + 20, 0) == 1);
+    assert(ss_ttlmap_size(&m) == 1);
+    assert(ss_ttlmap_refresh(&m, &k, sizeof(k), 1000));
+    assert(ss_ttlmap_expire_until(&m, ss_ttlmap_now(&m) + 500, 0) == 0);
+    assert(ss_ttlmap_remove(&m, &k, sizeof(k)));
+    assert(!ss_ttlmap_remove(&m, &k, sizeof(k)));
+    assert(!ss_ttlmap_refresh(&m, &k, sizeof(k), 10));
+    assert(ss_ttlmap_size(&m) == 0);
+    printf("[OK] ss_ttlmap_refresh/remove: Refresh and remove test passed\n");
+
+    // Test bounded batches and long delays beyond the wheel horizon
+    uint64_t base = ss_ttlmap_now(&m);
+    for (int i = 0; i < 100; i++)
+    {
+        uint64_t ttl = (uint64_t)i * 400000 + 7;
+        deadline = base + ttl;
+        assert(ss_ttlmap_put(&m, &i, sizeof(i), &deadline, sizeof(deadline), ttl));
+    }
+    size_t total = 0;
+    size_t batch;
+    while ((batch = ss_ttlmap_expire_until(&m, base + 99 * 400000, 8)) > 0)
+    {
+        assert(batch <= 8);
+        total += batch;
+    }
+    assert(total == 99);
+    assert(ss_ttlmap_size(&m) == 1);
+    assert(ss_ttlmap_expire_until(&m, base + 99 * 400000 + 7, 0) == 1);
+    assert(ss_ttlmap_size(&m) == 0);
+    printf("[OK] ss_ttlmap_expire_until: Bounded batch and long delay test passed\n");
+
+    // Test clear
+    for (int i = 0; i < 10; i++)
+    {
+        assert(ss_ttlmap_put(&m, &i, sizeof(i), NULL, 0, (uint64_t)i * 1000));
+    }
+    ss_ttlmap_clear(&m);
+    assert(ss_ttlmap_size(&m) == 0);
+    assert(ss_ttlmap_expire_until(&m, ss_ttlmap_now(&m) + 100000, 0) == 0);
+    printf("[OK] ss_ttlmap_clear: Clear test passed\n");
+
+    ss_ttlmap_destroy(&m);
+    printf("[OK] ss_ttlmap_destroy: Cleanup completed\n");
+
+    printf("=== All ss_ttlmap tests passed ===\n\n");
+}
@@ -21,6 +21,7 @@ target("test_tcsl")
     add_files("tests/*.c")
     add_deps("tcsl")
     add_includedirs("$(buildir)/include/tcsl")
+    add_syslinks("pthread")
 
 
 